@@ -36,6 +36,7 @@ namespace LandmarkArrays
   static char const* const TrueColor = "truecolor";
   static char const* const Elevation = "elevation";
   static char const* const Observations = "observations";
+  static char const* const ReprojectionError = "reprojection error";
 }
 
 namespace DepthMapArrays
@@ -31,6 +31,7 @@
 #include "GroundControlPointsHelper.h"
 
 #include "CameraView.h"
+#include "GroundControlPointsMatcher.h"
 #include "GroundControlPointsWidget.h"
 #include "MainWindow.h"
 #include "WorldView.h"
@@ -38,6 +39,9 @@
 #include "vtkMaptkPointPicker.h"
 #include "vtkMaptkPointPlacer.h"
 
+#include <maptk/geodetic_conversion.h>
+#include <maptk/parallel_for.h>
+
 #include <vital/types/geodesy.h>
 
 #include <vtkHandleWidget.h>
@@ -54,6 +58,11 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMessageBox>
+#include <QProgressDialog>
+
+#include <array>
+#include <limits>
+#include <vector>
 
 namespace kv = kwiver::vital;
 
@@ -78,6 +87,8 @@ const auto TAG_POINT              = QStringLiteral("Point");
 const auto TAG_NAME               = QStringLiteral("name");
 const auto TAG_LOCATION           = QStringLiteral("location");
 const auto TAG_USER_REGISTERED    = QStringLiteral("userRegistered");
+const auto TAG_OBSERVATIONS       = QStringLiteral("observations");
+const auto TAG_FRAME              = QStringLiteral("frame");
 
 enum class Reset
 {
@@ -157,6 +168,20 @@ kv::ground_control_point_sptr extractGroundControlPoint(QJsonObject const& f)
 
   gcp->set_geo_loc_user_provided(props.value(TAG_USER_REGISTERED).toBool());
 
+  for (auto const& ov : props.value(TAG_OBSERVATIONS).toArray())
+  {
+    auto const& o = ov.toObject();
+    auto const& frame = o.value(TAG_FRAME);
+    auto const& oloc = o.value(TAG_LOCATION).toArray();
+    if (!frame.isDouble() || oloc.size() != 2 || !isDoubleArray(oloc))
+    {
+      qDebug() << "ignoring bad observation" << o << "of point feature" << f;
+      continue;
+    }
+    gcp->set_observation(static_cast<kv::frame_id_t>(frame.toDouble()),
+                         {oloc[0].toDouble(), oloc[1].toDouble()});
+  }
+
   return gcp;
 }
 
@@ -187,6 +212,18 @@ QJsonValue buildFeature(kv::ground_control_point_sptr const& gcpp)
   props.insert(TAG_NAME, qtString(gcp.name()));
   props.insert(TAG_LOCATION, QJsonArray{sl[0], sl[1], sl[2]});
   props.insert(TAG_USER_REGISTERED, gcp.is_geo_loc_user_provided());
+  if (!gcp.observations().empty())
+  {
+    QJsonArray observations;
+    for (auto const& o : gcp.observations())
+    {
+      QJsonObject obs;
+      obs.insert(TAG_FRAME, static_cast<double>(o.first));
+      obs.insert(TAG_LOCATION, QJsonArray{o.second[0], o.second[1]});
+      observations.append(obs);
+    }
+    props.insert(TAG_OBSERVATIONS, observations);
+  }
 
   // Create and return feature
   QJsonObject f;
@@ -211,6 +248,11 @@ public:
   std::map<vtkHandleWidget*, id_t> gcpHandleToIdMap;
   std::map<id_t, vtkHandleWidget*> gcpIdToHandleMap;
 
+  // Which camera view points were projected (rather than moved to infinity)
+  // by the last camera view update, and the world points they came from
+  std::vector<char> cameraPointVisible;
+  unsigned long cameraPointsVersion = 0;
+
   void addPoint(id_t id, kv::ground_control_point_sptr const& point);
 
   void updatePoint(int handleId);
@@ -286,7 +328,9 @@ void GroundControlPointsHelperPrivate::resetPoint(
     auto lgcs = this->mainWindow->localGeoCoordinateSystem();
     if (lgcs.origin().crs() >= 0)
     {
-      kwiver::vital::vector_3d loc(lgcs.origin().location() + gcp->loc());
+      // A single point needs no batch conversion; it is kept in the CRS of
+      // the origin and converted when its geodetic location is queried
+      kv::vector_3d const loc(lgcs.origin().location() + gcp->loc());
       gcp->set_geo_loc({loc, lgcs.origin().crs()});
     }
 
@@ -537,7 +581,11 @@ void GroundControlPointsHelper::addWorldViewPoint()
   worldWidget->addPoint(p);
   worldWidget->render();
 
-  emit this->pointAdded(d->addPoint());
+  auto const id = d->addPoint();
+  d->groundControlPoints[id]->set_observation(
+    d->mainWindow->activeFrame(), cameraPt.head<2>());
+
+  emit this->pointAdded(id);
   emit this->pointCountChanged(d->groundControlPoints.size());
 }
 
@@ -608,6 +656,19 @@ void GroundControlPointsHelper::moveWorldViewPoint()
   double depth = d->mainWindow->activeCamera()->Depth(pt);
 
   kv::vector_3d p = camera->UnprojectPoint(cameraPt.data(), depth);
+
+  // Record the new location as the point's observation on the active frame
+  auto const handle = worldWidget->handleWidget(handleId);
+  if (auto const gcpIdIter = qtGet(d->gcpHandleToIdMap, handle))
+  {
+    auto const gcpIter = qtGet(d->groundControlPoints, gcpIdIter->second);
+    if (gcpIter && gcpIter->second)
+    {
+      gcpIter->second->set_observation(
+        d->mainWindow->activeFrame(), cameraPt.head<2>());
+    }
+  }
+
   d->movePoint(handleId, worldWidget, p);
 }
 
@@ -617,7 +678,7 @@ void GroundControlPointsHelper::updateCameraViewPoints()
   QTE_D();
 
   vtkMaptkCamera* camera = d->mainWindow->activeCamera();
-  if (!camera)
+  if (!camera || !camera->GetCamera())
   {
     return;
   }
@@ -628,12 +689,105 @@ void GroundControlPointsHelper::updateCameraViewPoints()
   GroundControlPointsWidget* cameraWidget =
     d->mainWindow->cameraView()->groundControlPointsWidget();
 
+  // Build the half-spaces bounding the region in which vtkMaptkCamera's
+  // ProjectPoint accepts points: in front of the camera and within ten image
+  // sizes of the image origin; a point X is inside if h.[X 1] >= 0 for each
+  auto const& P = camera->GetCamera()->as_matrix();
+  int dims[2];
+  camera->GetImageDimensions(dims);
+  std::vector<std::array<double, 4>> planes;
+  auto const addPlane = [&planes](Eigen::RowVector4d const& h){
+    planes.push_back({{h[0], h[1], h[2], h[3]}});
+  };
+  addPlane(P.row(2));
+  if (dims[0] > 0 && dims[1] > 0)
+  {
+    for (int k = 0; k < 2; ++k)
+    {
+      auto const limit = 10.0 * dims[k];
+      addPlane(limit * P.row(2) - P.row(k));
+      addPlane(limit * P.row(2) + P.row(k));
+    }
+  }
+
+  using index_t = kwiver::maptk::kd_tree<3>;
+  auto const classify = [&planes](double const* lo, double const* hi){
+    auto result = index_t::INSIDE;
+    for (auto const& h : planes)
+    {
+      auto vmin = h[3], vmax = h[3];
+      for (int k = 0; k < 3; ++k)
+      {
+        vmin += h[k] * (h[k] > 0.0 ? lo[k] : hi[k]);
+        vmax += h[k] * (h[k] > 0.0 ? hi[k] : lo[k]);
+      }
+      if (vmax < 0.0)
+      {
+        return index_t::OUTSIDE;
+      }
+      if (vmin < 0.0)
+      {
+        result = index_t::INTERSECTS;
+      }
+    }
+    return result;
+  };
+  auto const contains = [&planes](double const* p){
+    for (auto const& h : planes)
+    {
+      if (h[0] * p[0] + h[1] * p[1] + h[2] * p[2] + h[3] < 0.0)
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Find the points which are visible to the camera and project them
+  // (ignoring any point the index has which the widget no longer has)
+  auto const& pointIndex = worldWidget->pointIndex();
+  auto const numWorldPts = worldWidget->numberOfPoints();
+  std::vector<size_t> visiblePoints;
+  pointIndex.query(classify, contains, [&visiblePoints, numWorldPts](size_t i){
+    if (i < static_cast<size_t>(numWorldPts))
+    {
+      visiblePoints.push_back(i);
+    }
+  });
+
+  std::vector<double> cameraPts(2 * static_cast<size_t>(numWorldPts),
+                                std::numeric_limits<double>::infinity());
+  std::vector<char> visible(static_cast<size_t>(numWorldPts), 0);
+  auto const& vc = *camera->GetCamera();
+  kwiver::maptk::parallel_for(
+    0, visiblePoints.size(), [&](size_t begin, size_t end){
+      for (auto k = begin; k < end; ++k)
+      {
+        auto const i = visiblePoints[k];
+        auto const* const p = pointIndex.point(i);
+        auto const& ppos = vc.project(kv::vector_3d{p[0], p[1], p[2]});
+        cameraPts[2 * i + 0] = ppos[0];
+        cameraPts[2 * i + 1] = ppos[1];
+        visible[i] = 1;
+      }
+    }, 256);
+
+  // If the world points changed since the last update, every camera view
+  // point must be refreshed; otherwise only points which are visible now, or
+  // which were visible before and must now be moved to infinity, need to move
+  auto& lastVisible = d->cameraPointVisible;
+  if (lastVisible.size() != visible.size() ||
+      d->cameraPointsVersion != worldWidget->pointsVersion())
+  {
+    lastVisible.assign(visible.size(), 1);
+    d->cameraPointsVersion = worldWidget->pointsVersion();
+  }
+
   with_expr (qtScopedBlockSignals{cameraWidget})
   {
     auto const activeHandle = worldWidget->activeHandle();
 
     int numCameraPts = cameraWidget->numberOfPoints();
-    int numWorldPts = worldWidget->numberOfPoints();
     while (numCameraPts > numWorldPts)
     {
       cameraWidget->deletePoint(--numCameraPts);
@@ -641,14 +795,12 @@ void GroundControlPointsHelper::updateCameraViewPoints()
 
     for (int i = 0; i < numWorldPts; ++i)
     {
-      kv::vector_3d worldPt = worldWidget->point(i);
-      double cameraPt[2];
-      camera->ProjectPoint(worldPt, cameraPt);
+      auto const* const cameraPt = cameraPts.data() + 2 * i;
       if (i >= numCameraPts)
       {
         cameraWidget->addPoint(cameraPt[0], cameraPt[1], 0.0);
       }
-      else
+      else if (visible[i] || lastVisible[i])
       {
         cameraWidget->movePoint(i, cameraPt[0], cameraPt[1], 0.0);
       }
@@ -656,6 +808,8 @@ void GroundControlPointsHelper::updateCameraViewPoints()
 
     cameraWidget->setActivePoint(activeHandle);
   }
+
+  lastVisible.swap(visible);
 }
 
 //-----------------------------------------------------------------------------
@@ -663,9 +817,32 @@ void GroundControlPointsHelper::recomputePoints()
 {
   QTE_D();
 
-  for (auto const& i : d->groundControlPoints)
+  auto const& lgcs = d->mainWindow->localGeoCoordinateSystem();
+  if (lgcs.origin().crs() >= 0)
   {
-    d->resetPoint(i.second, i.first, Reset::Silent);
+    // Convert the scene locations of all points which are not user
+    // registered in one batch
+    std::vector<kv::ground_control_point*> points;
+    std::vector<double> locations;
+    for (auto const& i : d->groundControlPoints)
+    {
+      if (!i.second->is_geo_loc_user_provided())
+      {
+        auto const& loc = i.second->loc();
+        points.push_back(i.second.get());
+        locations.insert(locations.end(), loc.data(), loc.data() + 3);
+      }
+    }
+
+    kwiver::maptk::local_to_geographic(
+      lgcs, locations.data(), points.size(), locations.data());
+
+    for (size_t k = 0; k < points.size(); ++k)
+    {
+      auto const* const loc = locations.data() + 3 * k;
+      points[k]->set_geo_loc({kv::vector_3d{loc[0], loc[1], loc[2]},
+                              kv::SRID::lat_lon_WGS84});
+    }
   }
 
   emit this->pointsRecomputed();
@@ -715,6 +892,104 @@ void GroundControlPointsHelper::removePoint(id_t gcpId)
   }
 }
 
+//-----------------------------------------------------------------------------
+void GroundControlPointsHelper::findObservations(id_t gcpId)
+{
+  QTE_D();
+
+  auto const gcpp = qtGet(d->groundControlPoints, gcpId);
+  auto const gcp = (gcpp ? gcpp->second : nullptr);
+  if (!gcp)
+  {
+    qWarning() << "No ground control point with id" << gcpId;
+    return;
+  }
+
+  // Match from the observation on the active frame, if there is one
+  auto const& observations = gcp->observations();
+  auto source = observations.find(d->mainWindow->activeFrame());
+  if (source == observations.end())
+  {
+    source = observations.begin();
+  }
+  if (source == observations.end())
+  {
+    QMessageBox::information(
+      d->mainWindow, QStringLiteral("Find in All Frames"),
+      QStringLiteral("The point must first be placed on a frame "
+                     "in the camera view."));
+    return;
+  }
+
+  auto const videoSource = d->mainWindow->createVideoSource();
+  if (!videoSource)
+  {
+    QMessageBox::information(
+      d->mainWindow, QStringLiteral("Find in All Frames"),
+      QStringLiteral("Imagery is required to find the point."));
+    return;
+  }
+
+  // Match in a separate thread, reading the video there, with progress
+  // shown in a dialog that allows canceling
+  auto* const matcher = new GroundControlPointsMatcher{this};
+  matcher->setData(gcpId, gcp->loc(), source->first, source->second,
+                   d->mainWindow->cameraMap()->cameras(), videoSource);
+
+  auto* const progress = new QProgressDialog{
+    QStringLiteral("Finding the ground control point in all frames..."),
+    QStringLiteral("Cancel"), 0, 0, d->mainWindow};
+  progress->setWindowTitle(QStringLiteral("Find in All Frames"));
+  progress->setWindowModality(Qt::WindowModal);
+  progress->setMinimumDuration(500);
+  progress->setAttribute(Qt::WA_DeleteOnClose);
+
+  connect(matcher, &GroundControlPointsMatcher::progressChanged, progress,
+          [progress](int value, int maximum){
+            progress->setMaximum(maximum);
+            progress->setValue(value);
+          });
+  connect(progress, &QProgressDialog::canceled,
+          matcher, &GroundControlPointsMatcher::cancel, Qt::DirectConnection);
+  connect(matcher, &QThread::finished, this, [this, matcher, progress]{
+    progress->close();
+    this->mergeObservations(matcher);
+    matcher->deleteLater();
+  });
+
+  matcher->start();
+}
+
+//-----------------------------------------------------------------------------
+void GroundControlPointsHelper::mergeObservations(
+  GroundControlPointsMatcher* matcher)
+{
+  QTE_D();
+
+  if (matcher->isCanceled())
+  {
+    return;
+  }
+
+  // The point may have been removed while matching
+  auto const gcpId = matcher->pointId();
+  auto const gcpp = qtGet(d->groundControlPoints, gcpId);
+  auto const gcp = (gcpp ? gcpp->second : nullptr);
+  if (!gcp)
+  {
+    return;
+  }
+
+  // Keep existing observations, which may have been placed by the user, over
+  // the ones found by matching
+  auto observations = gcp->observations();
+  auto const& found = matcher->observations();
+  observations.insert(found.begin(), found.end());
+  gcp->set_observations(observations);
+
+  emit this->pointChanged(gcpId);
+}
+
 //-----------------------------------------------------------------------------
 void GroundControlPointsHelper::setActivePoint(id_t gcpId)
 {
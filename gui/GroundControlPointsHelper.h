@@ -42,6 +42,7 @@
 
 // Forward declarations
 class GroundControlPointsHelperPrivate;
+class GroundControlPointsMatcher;
 
 class GroundControlPointsHelper : public QObject
 {
@@ -76,6 +77,11 @@ public slots:
   void resetPoint(kwiver::vital::ground_control_point_id_t);
   void removePoint(kwiver::vital::ground_control_point_id_t);
 
+  // Find the point on every frame with a camera by template matching around
+  // its projections, starting from its observation on the active frame (or
+  // its first observation); this runs in a separate thread
+  void findObservations(kwiver::vital::ground_control_point_id_t);
+
   void setActivePoint(kwiver::vital::ground_control_point_id_t);
 
 signals:
@@ -97,6 +103,8 @@ protected slots:
   void moveCameraViewPoint();
   void moveWorldViewPoint();
 
+  void mergeObservations(GroundControlPointsMatcher*);
+
 private:
   QTE_DECLARE_PRIVATE_RPTR(GroundControlPointsHelper)
   QTE_DECLARE_PRIVATE(GroundControlPointsHelper)
@@ -0,0 +1,177 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "GroundControlPointsMatcher.h"
+
+#include <maptk/template_matching.h>
+
+#include <vital/logger/logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace kv = kwiver::vital;
+
+QTE_IMPLEMENT_D_FUNC(GroundControlPointsMatcher)
+
+//-----------------------------------------------------------------------------
+class GroundControlPointsMatcherPrivate
+{
+public:
+  kv::ground_control_point_id_t pointId = 0;
+  kv::vector_3d point;
+  kv::frame_id_t sourceFrame = 0;
+  kv::vector_2d sourceLocation;
+  kv::camera_map::map_camera_t cameras;
+  kv::algo::video_input_sptr videoSource;
+
+  GroundControlPointsMatcher::observation_map_t observations;
+
+  std::atomic<bool> canceled{false};
+};
+
+//-----------------------------------------------------------------------------
+GroundControlPointsMatcher::GroundControlPointsMatcher(QObject* parent)
+  : QThread{parent}, d_ptr{new GroundControlPointsMatcherPrivate}
+{
+}
+
+//-----------------------------------------------------------------------------
+GroundControlPointsMatcher::~GroundControlPointsMatcher()
+{
+  this->cancel();
+  this->wait();
+}
+
+//-----------------------------------------------------------------------------
+void GroundControlPointsMatcher::setData(
+  kv::ground_control_point_id_t pointId, kv::vector_3d const& point,
+  kv::frame_id_t sourceFrame, kv::vector_2d const& sourceLocation,
+  kv::camera_map::map_camera_t const& cameras,
+  kv::algo::video_input_sptr const& videoSource)
+{
+  QTE_D();
+
+  d->pointId = pointId;
+  d->point = point;
+  d->sourceFrame = sourceFrame;
+  d->sourceLocation = sourceLocation;
+  d->cameras = cameras;
+  d->videoSource = videoSource;
+}
+
+//-----------------------------------------------------------------------------
+kv::ground_control_point_id_t GroundControlPointsMatcher::pointId() const
+{
+  QTE_D();
+  return d->pointId;
+}
+
+//-----------------------------------------------------------------------------
+GroundControlPointsMatcher::observation_map_t
+GroundControlPointsMatcher::observations() const
+{
+  QTE_D();
+  return d->observations;
+}
+
+//-----------------------------------------------------------------------------
+bool GroundControlPointsMatcher::isCanceled() const
+{
+  QTE_D();
+  return d->canceled;
+}
+
+//-----------------------------------------------------------------------------
+void GroundControlPointsMatcher::cancel()
+{
+  QTE_D();
+  d->canceled = true;
+}
+
+//-----------------------------------------------------------------------------
+void GroundControlPointsMatcher::run()
+{
+  QTE_D();
+
+  std::vector<kv::frame_id_t> frames;
+  for (auto const& c : d->cameras)
+  {
+    frames.push_back(c.first);
+  }
+  auto const maximum = static_cast<int>(frames.size());
+
+  // The images are requested in increasing frame order, after the source
+  // frame, so read the video forward rather than seeking to each frame; a
+  // seek is only needed to go back from the source frame
+  kv::timestamp ts;
+  bool more = true;
+  auto const images = [&](kv::frame_id_t frame) -> kv::image_container_sptr
+  {
+    auto const read = std::lower_bound(frames.begin(), frames.end(), frame);
+    emit this->progressChanged(static_cast<int>(read - frames.begin()),
+                               maximum);
+    if (d->canceled)
+    {
+      return nullptr;
+    }
+
+    if (ts.has_valid_frame() && ts.get_frame() > frame)
+    {
+      more = d->videoSource->seek_frame(ts, frame);
+    }
+    while (more && (!ts.has_valid_frame() || ts.get_frame() < frame))
+    {
+      more = d->videoSource->next_frame(ts);
+    }
+    return (more && ts.get_frame() == frame)
+           ? d->videoSource->frame_image() : nullptr;
+  };
+
+  try
+  {
+    auto observations = kwiver::maptk::match_point_observations(
+      d->point, d->sourceFrame, d->sourceLocation, d->cameras, images);
+    if (!d->canceled)
+    {
+      d->observations = std::move(observations);
+    }
+  }
+  catch (std::exception const& e)
+  {
+    LOG_WARN(kv::get_logger("telesculptor.gcp_matcher"),
+             "Failed to find ground control point " << d->pointId
+             << ": " << e.what());
+  }
+
+  d->videoSource->close();
+  emit this->progressChanged(maximum, maximum);
+}
@@ -0,0 +1,91 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TELESCULPTOR_GROUNDCONTROLPOINTSMATCHER_H_
+#define TELESCULPTOR_GROUNDCONTROLPOINTSMATCHER_H_
+
+#include <maptk/ground_control_point.h>
+
+#include <vital/algo/video_input.h>
+#include <vital/types/camera_map.h>
+
+#include <qtGlobal.h>
+
+#include <QtCore/QThread>
+
+class GroundControlPointsMatcherPrivate;
+
+/// Find a ground control point on every frame in a separate thread
+class GroundControlPointsMatcher : public QThread
+{
+  Q_OBJECT
+
+public:
+  using observation_map_t =
+    kwiver::vital::ground_control_point::observation_map_t;
+
+  GroundControlPointsMatcher(QObject* parent = nullptr);
+  ~GroundControlPointsMatcher() override;
+
+  /// Set the point to find, its observation on the source frame, the cameras
+  /// of the frames to search, and an open video source from which to read
+  /// them; the video source is used only by this thread and closed when done
+  void setData(kwiver::vital::ground_control_point_id_t pointId,
+               kwiver::vital::vector_3d const& point,
+               kwiver::vital::frame_id_t sourceFrame,
+               kwiver::vital::vector_2d const& sourceLocation,
+               kwiver::vital::camera_map::map_camera_t const& cameras,
+               kwiver::vital::algo::video_input_sptr const& videoSource);
+
+  kwiver::vital::ground_control_point_id_t pointId() const;
+
+  /// Get the observations found; valid once the thread has finished, and
+  /// empty if matching failed or was canceled
+  observation_map_t observations() const;
+
+  bool isCanceled() const;
+
+signals:
+  /// Emitted as frames are read, with the number of frames read so far
+  void progressChanged(int value, int maximum);
+
+public slots:
+  void cancel();
+
+protected:
+  void run() override;
+
+private:
+  QTE_DECLARE_PRIVATE_RPTR(GroundControlPointsMatcher)
+  QTE_DECLARE_PRIVATE(GroundControlPointsMatcher)
+  QTE_DISABLE_COPY(GroundControlPointsMatcher)
+};
+
+#endif
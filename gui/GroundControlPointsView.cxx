@@ -155,6 +155,7 @@ void GroundControlPointsViewPrivate::enableControls(
 
   this->UI.actionDelete->setEnabled(state);
   this->UI.actionRevert->setEnabled(state);
+  this->UI.actionFindObservations->setEnabled(state);
   this->UI.actionCopyLocationLatLon->setEnabled(state && haveLocation);
   this->UI.actionCopyLocationLatLonElev->setEnabled(state && haveLocation);
   this->UI.actionCopyLocationLonLat->setEnabled(state && haveLocation);
@@ -333,11 +334,13 @@ GroundControlPointsView::GroundControlPointsView(
   auto* const spacer = new QWidget{d->UI.toolBar};
   spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
-  d->UI.toolBar->insertWidget(d->UI.actionRevert, d->copyLocationButton);
-  d->UI.toolBar->insertWidget(d->UI.actionRevert, spacer);
+  auto* const firstAction = d->UI.actionFindObservations;
+  d->UI.toolBar->insertWidget(firstAction, d->copyLocationButton);
+  d->UI.toolBar->insertWidget(firstAction, spacer);
 
   d->popupMenu = new QMenu{this};
   d->popupMenu->addMenu(clMenu);
+  d->popupMenu->addAction(d->UI.actionFindObservations);
   d->popupMenu->addAction(d->UI.actionRevert);
   d->popupMenu->addAction(d->UI.actionDelete);
 
@@ -359,6 +362,14 @@ GroundControlPointsView::GroundControlPointsView(
             }
           });
 
+  connect(d->UI.actionFindObservations, &QAction::triggered,
+          this, [d]{
+            if (d->helper && d->currentPoint != INVALID_POINT)
+            {
+              d->helper->findObservations(d->currentPoint);
+            }
+          });
+
   connect(d->UI.actionRevert, &QAction::triggered,
           this, [d]{
             if (d->helper && d->currentPoint != INVALID_POINT)
@@ -35,6 +35,7 @@
 
 // VTK includes
 #include <vtkActor.h>
+#include <vtkCamera.h>
 #include <vtkCommand.h>
 #include <vtkEvent.h>
 #include <vtkEventQtSlotConnect.h>
@@ -52,6 +53,9 @@
 // Qt includes
 #include <QApplication>
 
+// STL includes
+#include <vector>
+
 QTE_IMPLEMENT_D_FUNC(GroundControlPointsWidget)
 
 //-----------------------------------------------------------------------------
@@ -63,6 +67,7 @@ public:
   // Methods
   void updateTransformMatrixInverse();
   void deletePoint(int handleId);
+  void invalidatePoints();
 
   // Seed widget
   vtkNew<vtkMaptkSeedWidget> widget;
@@ -75,6 +80,22 @@ public:
   vtkMatrix4x4* transformMatrix = nullptr;
   vtkNew<vtkMatrix4x4> transformMatrixInverse;
   vtkMTimeType transformMatrixMTime = 0;
+
+  kwiver::maptk::kd_tree<3> pointIndex;
+  bool pointIndexDirty = true;
+  unsigned long pointsVersion = 0;
+
+  // Index of the points' display positions, which is rebuilt when the points,
+  // camera or viewport change, and the last handle picked from it
+  kwiver::maptk::kd_tree<2> displayIndex;
+  std::vector<int> displayHandles;
+  unsigned long displayIndexPointsVersion = static_cast<unsigned long>(-1);
+  vtkMTimeType displayIndexCameraMTime = 0;
+  int displayIndexSize[2] = { 0, 0 };
+  bool pickValid = false;
+  int pickX = 0;
+  int pickY = 0;
+  int pickedHandle = -1;
 };
 
 //-----------------------------------------------------------------------------
@@ -126,9 +147,17 @@ void GroundControlPointsWidgetPrivate::deletePoint(int handleId)
   {
     this->widget->DeleteSeed(handleId);
     this->repr->SetActiveHandle(handleId - 1);
+    this->invalidatePoints();
   }
 }
 
+//-----------------------------------------------------------------------------
+void GroundControlPointsWidgetPrivate::invalidatePoints()
+{
+  this->pointIndexDirty = true;
+  ++this->pointsVersion;
+}
+
 //-----------------------------------------------------------------------------
 GroundControlPointsWidget::GroundControlPointsWidget(QObject* parent)
   : QObject(parent)
@@ -139,7 +168,7 @@ GroundControlPointsWidget::GroundControlPointsWidget(QObject* parent)
   d->connections->Connect(d->widget.GetPointer(),
                           vtkCommand::PlacePointEvent,
                           this,
-                          SIGNAL(pointPlaced()));
+                          SLOT(placePointEvent()));
   d->connections->Connect(d->widget.GetPointer(),
                           vtkCommand::InteractionEvent,
                           this,
@@ -155,6 +184,25 @@ GroundControlPointsWidget::GroundControlPointsWidget(QObject* parent)
     vtkMaptkSeedWidget::ActiveSeedChangedEvent,
     this,
     SLOT(activeHandleChangedCallback(vtkObject*, unsigned long, void*, void*)));
+  d->connections->Connect(d->widget.GetPointer(),
+                          vtkMaptkSeedWidget::SeedDeletedEvent,
+                          this,
+                          SLOT(seedDeletedEvent()));
+
+  // Only pick the handle nearest to the cursor, rather than picking every
+  // handle on every mouse event
+  d->pointRepr->SetNearbyFunction(
+    [this, d](vtkHandleRepresentation* rep, int x, int y){
+      if (!d->renderer)
+      {
+        return true;
+      }
+      // Check the handle exists, as asking the representation for one past
+      // the end would create it
+      auto const handle = this->pickHandle(x, y);
+      return handle >= 0 && handle < d->repr->GetNumberOfSeeds() &&
+             d->repr->GetHandleRepresentation(handle) == rep;
+    });
 }
 
 //-----------------------------------------------------------------------------
@@ -263,6 +311,7 @@ void GroundControlPointsWidget::addDisplayPoint(double pt[3])
   d->repr->GetHandleRepresentation(handleId)->SetPointPlacer(nullptr);
   vtkHandleWidget* currentHandle = d->widget->CreateNewHandle();
   currentHandle->SetEnabled(1);
+  d->invalidatePoints();
 }
 
 //-----------------------------------------------------------------------------
@@ -332,6 +381,7 @@ void GroundControlPointsWidget::movePoint(int handleId,
   if (d->renderer)
   {
     d->repr->SetSeedWorldPosition(handleId, p);
+    d->invalidatePoints();
   }
 }
 
@@ -342,10 +392,30 @@ void GroundControlPointsWidget::movePointEvent()
 
   if (d->widget->GetWidgetState() == vtkMaptkSeedWidget::MovingSeed)
   {
+    d->invalidatePoints();
     emit pointMoved();
   }
 }
 
+//-----------------------------------------------------------------------------
+void GroundControlPointsWidget::placePointEvent()
+{
+  QTE_D();
+
+  // A point was placed interactively
+  d->invalidatePoints();
+  emit pointPlaced();
+}
+
+//-----------------------------------------------------------------------------
+void GroundControlPointsWidget::seedDeletedEvent()
+{
+  QTE_D();
+
+  // A point was deleted, either interactively or by deletePoint
+  d->invalidatePoints();
+}
+
 //-----------------------------------------------------------------------------
 void GroundControlPointsWidget::deletePoint(int handleId)
 {
@@ -371,6 +441,7 @@ void GroundControlPointsWidget::setTransformMatrix(vtkMatrix4x4* m)
   QTE_D();
   d->transformMatrix = m;
   d->updateTransformMatrixInverse();
+  d->invalidatePoints();
 }
 
 //-----------------------------------------------------------------------------
@@ -388,6 +459,96 @@ int GroundControlPointsWidget::numberOfPoints() const
   return d->repr->GetNumberOfSeeds();
 }
 
+//-----------------------------------------------------------------------------
+kwiver::maptk::kd_tree<3> const& GroundControlPointsWidget::pointIndex()
+{
+  QTE_D();
+
+  if (d->pointIndexDirty ||
+      d->pointIndex.size() != static_cast<size_t>(this->numberOfPoints()))
+  {
+    auto const n = this->numberOfPoints();
+    std::vector<double> points(3 * static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i)
+    {
+      d->repr->GetSeedWorldPosition(i, points.data() + 3 * i);
+    }
+    d->pointIndex.build(points.data(), static_cast<size_t>(n));
+    d->pointIndexDirty = false;
+  }
+
+  return d->pointIndex;
+}
+
+//-----------------------------------------------------------------------------
+int GroundControlPointsWidget::pickHandle(int x, int y)
+{
+  QTE_D();
+
+  if (!d->renderer)
+  {
+    return -1;
+  }
+
+  // Project the points to display coordinates if anything they depend on has
+  // changed; points outside the clipping range cannot be picked
+  auto const cameraMTime = d->renderer->GetActiveCamera()->GetMTime();
+  auto const* const size = d->renderer->GetSize();
+  if (d->displayIndexPointsVersion != d->pointsVersion ||
+      d->displayIndexCameraMTime != cameraMTime ||
+      d->displayIndexSize[0] != size[0] || d->displayIndexSize[1] != size[1])
+  {
+    auto const& index = this->pointIndex();
+    std::vector<double> points;
+    points.reserve(2 * index.size());
+    d->displayHandles.clear();
+    for (size_t i = 0; i < index.size(); ++i)
+    {
+      auto const* const p = index.point(i);
+      d->renderer->SetWorldPoint(p[0], p[1], p[2], 1.0);
+      d->renderer->WorldToDisplay();
+      auto const* const dp = d->renderer->GetDisplayPoint();
+      if (dp[2] >= 0.0 && dp[2] <= 1.0)
+      {
+        points.push_back(dp[0]);
+        points.push_back(dp[1]);
+        d->displayHandles.push_back(static_cast<int>(i));
+      }
+    }
+    d->displayIndex.build(points.data(), d->displayHandles.size());
+
+    d->displayIndexPointsVersion = d->pointsVersion;
+    d->displayIndexCameraMTime = cameraMTime;
+    d->displayIndexSize[0] = size[0];
+    d->displayIndexSize[1] = size[1];
+    d->pickValid = false;
+  }
+
+  // Every handle asks for the same position while handling an event, so
+  // look it up only once
+  if (!d->pickValid || d->pickX != x || d->pickY != y)
+  {
+    double const q[2] = { static_cast<double>(x), static_cast<double>(y) };
+    auto const i =
+      d->displayIndex.nearest(q, 0.5 * d->pointRepr->GetHandleSize());
+    d->pickedHandle =
+      (i == d->displayIndex.npos ? -1 : d->displayHandles[i]);
+    d->pickX = x;
+    d->pickY = y;
+    d->pickValid = true;
+  }
+
+  // Never report a handle which has been deleted since the pick
+  return (d->pickedHandle < this->numberOfPoints() ? d->pickedHandle : -1);
+}
+
+//-----------------------------------------------------------------------------
+unsigned long GroundControlPointsWidget::pointsVersion() const
+{
+  QTE_D();
+  return d->pointsVersion;
+}
+
 //-----------------------------------------------------------------------------
 void GroundControlPointsWidget::render()
 {
@@ -34,6 +34,9 @@
 // qtExtensions includes
 #include <qtGlobal.h>
 
+// maptk includes
+#include <maptk/kd_tree.h>
+
 // kwiver includes
 #include <vital/types/vector.h>
 
@@ -98,6 +101,19 @@ public:
   // Get access to the points stored by the widget
   int numberOfPoints() const;
 
+  // Get a spatial index over the points stored by the widget; point indices
+  // in the tree are handle IDs, and the index is rebuilt lazily after the
+  // points change
+  kwiver::maptk::kd_tree<3> const& pointIndex();
+
+  // Find the handle nearest to a display position, within half the handle
+  // size; returns -1 if there is none
+  int pickHandle(int x, int y);
+
+  // Get a counter which is incremented whenever any point is added, moved
+  // or removed
+  unsigned long pointsVersion() const;
+
   // Render the widget
   void render();
 
@@ -119,6 +135,8 @@ public slots:
 protected slots:
   // void addInternalPoint();
   void movePointEvent();
+  void placePointEvent();
+  void seedDeletedEvent();
   void pointDeletedCallback(vtkObject*, unsigned long, void*, void*);
   void activeHandleChangedCallback(vtkObject*, unsigned long, void*, void*);
 
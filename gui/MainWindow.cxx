@@ -57,10 +57,11 @@
 #include "vtkMaptkImageDataGeometryFilter.h"
 #include "vtkMaptkImageUnprojectDepth.h"
 
+#include <maptk/match_matrix.h>
+#include <maptk/residual_statistics.h>
 #include <maptk/version.h>
 #include <maptk/write_pdal.h>
 
-#include <arrows/core/match_matrix.h>
 #include <arrows/core/track_set_impl.h>
 #include <vital/algo/video_input.h>
 #include <vital/io/camera_io.h>
@@ -102,6 +103,8 @@
 #include <QTimer>
 #include <QUrl>
 
+#include <unordered_map>
+
 namespace kv = kwiver::vital;
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -280,12 +283,15 @@ public:
                      QString const& maskPath);
 
   void addFrame(kv::camera_perspective_sptr const& camera, int id);
-  void updateFrames(std::shared_ptr<kv::metadata_map::map_metadata_t>);
+  void updateFrames(std::shared_ptr<kv::metadata_map::map_metadata_t>,
+                    kwiver::maptk::metadata_table_sptr);
 
   kv::camera_map_sptr cameraMap() const;
   void updateCameras(kv::camera_map_sptr const&);
   bool updateCamera(kv::frame_id_t frame,
                     kv::camera_perspective_sptr cam);
+  void applySnapshot(SolutionSnapshot::Buffer const&);
+  void updateLandmarkResiduals();
 
   std::shared_ptr<std::map<kwiver::vital::frame_id_t, std::string>>
   depthLookup() const;
@@ -330,8 +336,12 @@ public:
   kv::landmark_map_sptr toolUpdateLandmarks;
   kv::feature_track_set_sptr toolUpdateTracks;
   kv::feature_track_set_changes_sptr toolUpdateTrackChanges;
+  kwiver::maptk::match_matrix_accumulator_sptr toolUpdateMatchMatrix;
   vtkSmartPointer<vtkImageData> toolUpdateDepth;
   vtkSmartPointer<vtkStructuredGrid> toolUpdateVolume;
+  std::shared_ptr<SolutionSnapshot> toolUpdateSnapshot;
+  std::shared_ptr<SolutionSnapshot> toolSnapshot;
+  std::uint64_t toolSnapshotVersion = 0;
   bool toolSaveDepthFlag = false;
 
   kv::config_block_sptr freestandingConfig = kv::config_block::empty_config();
@@ -343,10 +353,22 @@ public:
   kv::timestamp currentVideoTimestamp;
   kv::metadata_map_sptr videoMetadataMap =
     std::make_shared<kv::simple_metadata_map>();
+  // The metadata of videoMetadataMap, which is only copied on request
+  std::shared_ptr<kv::metadata_map::map_metadata_t const> videoMetadata =
+    std::make_shared<kv::metadata_map::map_metadata_t>();
+  // The same metadata in columnar form, for queries across all frames
+  kwiver::maptk::metadata_table_sptr videoMetadataTable =
+    std::make_shared<kwiver::maptk::metadata_table>();
 
   QMap<kv::frame_id_t, FrameData> frames;
   kv::feature_track_set_sptr tracks;
+  kwiver::maptk::match_matrix_accumulator_sptr matchMatrix;
   kv::landmark_map_sptr landmarks;
+  // The landmarks of the landmark map from which they were taken, by id, so
+  // that snapshots can move them in place without copying the map
+  kv::landmark_map_sptr snapshotLandmarksSource;
+  std::unordered_map<kv::landmark_id_t, std::shared_ptr<kv::landmark_d>>
+    snapshotLandmarks;
   vtkSmartPointer<vtkImageData> activeDepth;
   int activeDepthFrame = -1;
   int currentDepthFrame = -1;
@@ -664,15 +686,23 @@ void MainWindowPrivate::addFrame(
 
 //-----------------------------------------------------------------------------
 void MainWindowPrivate::updateFrames(
-  std::shared_ptr<kv::metadata_map::map_metadata_t> mdMap)
+  std::shared_ptr<kv::metadata_map::map_metadata_t> mdMap,
+  kwiver::maptk::metadata_table_sptr mdTable)
 {
   this->videoMetadataMap = std::make_shared<kv::simple_metadata_map>(*mdMap);
+  this->videoMetadata = mdMap;
+  this->videoMetadataTable = mdTable;
 
   sfmConstraints->set_metadata(videoMetadataMap);
 
-
-
-  this->UI.metadata->updateMetadata(mdMap);
+  // The table has a column for each tag found by the importer, so the view
+  // need not scan every frame
+  QSet<kv::vital_metadata_tag> mdTags;
+  for (auto const tag : mdTable->tags())
+  {
+    mdTags.insert(tag);
+  }
+  this->UI.metadata->setMetadataTags(mdTags);
 
   int num_cams_loaded_from_krtd = 0;
 
@@ -703,6 +733,9 @@ void MainWindowPrivate::updateFrames(
       }
     }
     this->UI.worldView->setCameras(this->cameraMap());
+
+    // Color the project's landmarks by their reprojection error
+    this->updateLandmarkResiduals();
   }
 
   if(num_cams_loaded_from_krtd == 0)
@@ -721,7 +754,7 @@ void MainWindowPrivate::updateFrames(
     auto baseCamera = kv::simple_camera_perspective();
     baseCamera.set_intrinsics(K);
 
-    auto md = videoMetadataMap->metadata();
+    auto const& md = *this->videoMetadata;
     kv::camera_map::map_camera_t camMap;
     if (!md.empty())
     {
@@ -907,6 +940,136 @@ bool MainWindowPrivate::updateCamera(kv::frame_id_t frame,
   return true;
 }
 
+//-----------------------------------------------------------------------------
+void MainWindowPrivate::applySnapshot(SolutionSnapshot::Buffer const& buffer)
+{
+  // Update the existing cameras and landmarks in place where possible, so
+  // that the interim results of a tool do not require copying the solution
+  foreach (auto const i, qtIndexRange(buffer.frames.size()))
+  {
+    auto const frame = buffer.frames[i];
+    auto* const fr = qtGet(this->frames, frame);
+    if (!fr)
+    {
+      continue;
+    }
+
+    auto const center = kv::vector_3d{&buffer.cameraCenters[3 * i]};
+    auto const rotation =
+      kv::rotation_d{kv::vector_4d{&buffer.cameraRotations[4 * i]}};
+    auto const* const k = &buffer.cameraIntrinsics[5 * i];
+
+    auto const camera =
+      (fr->camera ? std::dynamic_pointer_cast<kv::simple_camera_perspective>(
+                      fr->camera->GetCamera())
+                  : nullptr);
+    auto intrinsics = (camera ? camera->intrinsics() : nullptr);
+    if (!intrinsics || intrinsics->focal_length() != k[0] ||
+        intrinsics->principal_point() != kv::vector_2d{k[1], k[2]} ||
+        intrinsics->aspect_ratio() != k[3] || intrinsics->skew() != k[4])
+    {
+      auto const dist =
+        (intrinsics ? intrinsics->dist_coeffs() : std::vector<double>{});
+      intrinsics = std::make_shared<kv::simple_camera_intrinsics>(
+        k[0], kv::vector_2d{k[1], k[2]}, k[3], k[4],
+        Eigen::Map<Eigen::VectorXd const>(dist.data(),
+                                          static_cast<int>(dist.size())),
+        (intrinsics ? intrinsics->image_width() : 0u),
+        (intrinsics ? intrinsics->image_height() : 0u));
+    }
+
+    if (camera)
+    {
+      camera->set_center(center);
+      camera->set_rotation(rotation);
+      camera->set_intrinsics(intrinsics);
+      fr->camera->Update();
+    }
+    else
+    {
+      this->updateCamera(frame, std::make_shared<kv::simple_camera_perspective>(
+                                  center, rotation, intrinsics));
+    }
+  }
+
+  if (!buffer.landmarks.empty())
+  {
+    // Index the landmarks when the landmark map has been replaced since the
+    // last snapshot
+    if (this->snapshotLandmarksSource != this->landmarks)
+    {
+      this->snapshotLandmarks.clear();
+      if (this->landmarks)
+      {
+        for (auto const& lm : this->landmarks->landmarks())
+        {
+          auto const lmd = std::dynamic_pointer_cast<kv::landmark_d>(lm.second);
+          if (lmd)
+          {
+            this->snapshotLandmarks.emplace(lm.first, lmd);
+          }
+        }
+      }
+      this->snapshotLandmarksSource = this->landmarks;
+    }
+
+    // Move existing landmarks in place; if there are new landmarks, the map
+    // itself must be rebuilt to include them
+    auto needNewMap = !this->landmarks;
+    foreach (auto const i, qtIndexRange(buffer.landmarks.size()))
+    {
+      auto const lmi = this->snapshotLandmarks.find(buffer.landmarks[i]);
+      if (lmi != this->snapshotLandmarks.end())
+      {
+        lmi->second->set_loc(kv::vector_3d{&buffer.landmarkPositions[3 * i]});
+      }
+      else
+      {
+        needNewMap = true;
+      }
+    }
+
+    if (needNewMap)
+    {
+      auto landmarks =
+        (this->landmarks ? this->landmarks->landmarks()
+                         : kv::landmark_map::map_landmark_t{});
+      foreach (auto const i, qtIndexRange(buffer.landmarks.size()))
+      {
+        auto const id = buffer.landmarks[i];
+        if (!this->snapshotLandmarks.count(id))
+        {
+          auto const lmd = std::make_shared<kv::landmark_d>(
+            kv::vector_3d{&buffer.landmarkPositions[3 * i]});
+          landmarks[id] = lmd;
+          this->snapshotLandmarks.emplace(id, lmd);
+        }
+      }
+      this->landmarks = std::make_shared<kv::simple_landmark_map>(landmarks);
+      this->snapshotLandmarksSource = this->landmarks;
+    }
+
+    this->UI.worldView->setLandmarks(*this->landmarks);
+  }
+
+  this->UI.worldView->setCameras(this->cameraMap());
+}
+
+//-----------------------------------------------------------------------------
+void MainWindowPrivate::updateLandmarkResiduals()
+{
+  if (!this->landmarks || !this->tracks || !this->landmarks->size())
+  {
+    return;
+  }
+
+  kwiver::maptk::residual_statistics stats;
+  stats.compute(this->cameraMap()->cameras(),
+                this->landmarks->landmarks(),
+                this->tracks->tracks());
+  this->UI.worldView->setLandmarkResiduals(stats);
+}
+
 //-----------------------------------------------------------------------------
 void MainWindowPrivate::setActiveCamera(int id)
 {
@@ -1098,12 +1261,7 @@ void MainWindowPrivate::updateCameraView()
 //-----------------------------------------------------------------------------
 std::string MainWindowPrivate::getFrameName(kv::frame_id_t frameId)
 {
-  kwiver::vital::metadata_map::map_metadata_t md;
-  if (videoMetadataMap)
-  {
-    md = videoMetadataMap->metadata();
-  }
-  return frameName(frameId, md);
+  return frameName(frameId, *this->videoMetadata);
 }
 
 //-----------------------------------------------------------------------------
@@ -1180,23 +1338,15 @@ void MainWindowPrivate::loadImage(FrameData frame)
       this->UI.cameraView->setImageData(imageData, size);
       this->UI.worldView->setImageData(imageData, size);
 
-      // Update metadata view
-      if (!this->videoMetadataMap)
+      // Update metadata view with the values of this frame only
+      auto const mdi = this->videoMetadata->find(frame.id);
+      if (mdi == this->videoMetadata->end())
       {
         this->UI.metadata->updateMetadata(kv::metadata_vector{});
       }
       else
       {
-        auto md_map = this->videoMetadataMap->metadata();
-        auto mdi = md_map.find(frame.id);
-        if (mdi == md_map.end())
-        {
-          this->UI.metadata->updateMetadata(kwiver::vital::metadata_vector{});
-        }
-        else
-        {
-          this->UI.metadata->updateMetadata(mdi->second);
-        }
+        this->UI.metadata->updateMetadata(mdi->second);
       }
     }
   }
@@ -1990,6 +2140,7 @@ void MainWindow::loadTracks(QString const& path)
       }
 
       d->tracks = tracks;
+      d->matchMatrix.reset();
       d->updateCameraView();
       for (auto const& track : tracks->tracks())
       {
@@ -2364,6 +2515,8 @@ void MainWindow::saveDepthPoints()
     this, "Export Depth Point Cloud", name,
     "PLY file (*.ply);;"
     "LAS file (*.las);;"
+    "LAZ file (*.laz);;"
+    "PCD file (*.pcd);;"
     "All Files (*)");
 
   if (!path.isEmpty())
@@ -2463,6 +2616,8 @@ void MainWindow::saveFusedMesh()
     this, "Export Fused Mesh", name + QString("_fused_mesh.ply"),
     "PLY File (*.ply);;"
     "LAS File (*.las);;"
+    "LAZ File (*.laz);;"
+    "PCD File (*.pcd);;"
     "VTK Polydata (*.vtp);;"
     "All Files (*)");
 
@@ -2586,6 +2741,7 @@ void MainWindow::executeTool(QObject* object)
     tool->setCameras(d->cameraMap());
     tool->setLandmarks(d->landmarks);
     tool->setSfmConstraints(d->sfmConstraints);
+    tool->setMetadataTable(d->videoMetadataTable);
     tool->setVideoPath(stdString(d->videoPath));
     tool->setMaskPath(stdString(d->maskPath));
     tool->setConfig(d->project->config);
@@ -2652,6 +2808,7 @@ void MainWindow::acceptToolResults(
                       !d->toolUpdateTrackChanges &&
                       !d->toolUpdateDepth &&
                       !d->toolUpdateVolume &&
+                      !d->toolUpdateSnapshot &&
                       d->toolUpdateActiveFrame < 0;
 
   if (d->activeTool)
@@ -2662,9 +2819,16 @@ void MainWindow::acceptToolResults(
     d->toolUpdateLandmarks = NULL;
     d->toolUpdateTracks = NULL;
     d->toolUpdateTrackChanges = NULL;
+    d->toolUpdateMatchMatrix = NULL;
     d->toolUpdateActiveFrame = -1;
     d->toolUpdateDepth = NULL;
     d->toolUpdateVolume = NULL;
+    d->toolUpdateSnapshot = NULL;
+    if (outputs.testFlag(AbstractTool::Cameras) ||
+        outputs.testFlag(AbstractTool::Landmarks))
+    {
+      d->toolUpdateSnapshot = data->snapshot;
+    }
     if (outputs.testFlag(AbstractTool::Cameras))
     {
       d->toolUpdateCameras = data->cameras;
@@ -2676,6 +2840,7 @@ void MainWindow::acceptToolResults(
     if (outputs.testFlag(AbstractTool::Tracks))
     {
       d->toolUpdateTracks = data->tracks;
+      d->toolUpdateMatchMatrix = data->matchMatrix;
     }
     if (outputs.testFlag(AbstractTool::TrackChanges))
     {
@@ -2721,10 +2886,19 @@ void MainWindow::acceptToolResults(
         d->shiftGeoOrigin(offset);
       }
     }
+
+    // Color landmarks by the reprojection error of the final solution, which
+    // the tool computed along with it
+    if (data->residuals)
+    {
+      d->UI.worldView->setLandmarkResiduals(*data->residuals);
+    }
   }
   else if (updateNeeded)
   {
-    QTimer::singleShot(1000, this, &MainWindow::updateToolResults);
+    // Snapshots are applied in place, so they can be shown more often
+    auto const delay = (d->toolUpdateSnapshot ? 100 : 1000);
+    QTimer::singleShot(delay, this, &MainWindow::updateToolResults);
   }
 }
 
@@ -2771,6 +2945,19 @@ void MainWindow::updateToolResults()
 {
   QTE_D();
 
+  if (d->toolUpdateSnapshot)
+  {
+    if (d->toolUpdateSnapshot != d->toolSnapshot)
+    {
+      d->toolSnapshot = d->toolUpdateSnapshot;
+      d->toolSnapshotVersion = 0;
+    }
+    d->toolSnapshot->read(
+      d->toolSnapshotVersion, [d](SolutionSnapshot::Buffer const& buffer){
+        d->applySnapshot(buffer);
+      });
+    d->toolUpdateSnapshot = NULL;
+  }
   if (d->toolUpdateCameras)
   {
     d->updateCameras(d->toolUpdateCameras);
@@ -2788,6 +2975,7 @@ void MainWindow::updateToolResults()
   if (d->toolUpdateTracks)
   {
     d->tracks = d->toolUpdateTracks;
+    d->matchMatrix = d->toolUpdateMatchMatrix;
     d->UI.cameraView->clearFeatureTracks();
     foreach (auto const& track, d->tracks->tracks())
     {
@@ -2800,6 +2988,7 @@ void MainWindow::updateToolResults()
     d->UI.actionKeyframesOnly->setEnabled(!d->tracks->tracks().empty());
     d->UI.actionTrackedFramesOnly->setEnabled(!d->tracks->tracks().empty());
     d->toolUpdateTracks = NULL;
+    d->toolUpdateMatchMatrix = NULL;
   }
   if (d->toolUpdateTrackChanges)
   {
@@ -2870,11 +3059,12 @@ void MainWindow::addFrame(int frame)
 
 //-----------------------------------------------------------------------------
 void MainWindow::updateFrames(
-  std::shared_ptr<kv::metadata_map::map_metadata_t> mdMap)
+  std::shared_ptr<kv::metadata_map::map_metadata_t> mdMap,
+  kwiver::maptk::metadata_table_sptr mdTable)
 {
   QTE_D();
 
-  d->updateFrames(mdMap);
+  d->updateFrames(mdMap, mdTable);
 }
 
 //-----------------------------------------------------------------------------
@@ -2884,9 +3074,17 @@ void MainWindow::showMatchMatrix()
 
   if (d->tracks)
   {
-    // Get matrix
+    // Get matrix; tools which produce tracks incrementally also keep the
+    // matrix up to date, otherwise compute it once and keep it until the
+    // tracks change
+    if (!d->matchMatrix)
+    {
+      d->matchMatrix =
+        std::make_shared<kwiver::maptk::match_matrix_accumulator>();
+      d->matchMatrix->rebuild(*d->tracks);
+    }
     auto frames = std::vector<kv::frame_id_t>();
-    auto const mm = kwiver::arrows::match_matrix(d->tracks, frames);
+    auto const mm = d->matchMatrix->matrix(frames);
 
     // Show window
     auto window = new MatchMatrixWindow();
@@ -2981,6 +3179,52 @@ vtkMaptkCamera* MainWindow::activeCamera()
   return (activeFrame ? activeFrame->camera : nullptr);
 }
 
+//-----------------------------------------------------------------------------
+kv::frame_id_t MainWindow::activeFrame() const
+{
+  QTE_D();
+
+  return d->activeCameraIndex;
+}
+
+//-----------------------------------------------------------------------------
+kv::camera_map_sptr MainWindow::cameraMap() const
+{
+  QTE_D();
+
+  return d->cameraMap();
+}
+
+//-----------------------------------------------------------------------------
+kv::algo::video_input_sptr MainWindow::createVideoSource() const
+{
+  QTE_D();
+
+  if (d->videoPath.isEmpty())
+  {
+    return nullptr;
+  }
+
+  kv::algo::video_input_sptr videoSource;
+  kv::algo::video_input::set_nested_algo_configuration(
+    "video_reader", d->freestandingConfig, videoSource);
+  if (!videoSource)
+  {
+    return nullptr;
+  }
+
+  try
+  {
+    videoSource->open(stdString(d->videoPath));
+  }
+  catch (kv::file_not_found_exception const& e)
+  {
+    qWarning() << e.what();
+    return nullptr;
+  }
+  return videoSource;
+}
+
 //-----------------------------------------------------------------------------
 void MainWindow::enableAntiAliasing(bool enable)
 {
@@ -37,6 +37,10 @@
 
 #include <memory>
 
+#include <maptk/metadata_table.h>
+
+#include <vital/algo/video_input.h>
+#include <vital/types/camera_map.h>
 #include <vital/types/local_geo_cs.h>
 #include <vital/types/metadata_map.h>
 
@@ -56,10 +60,16 @@ public:
   ~MainWindow() override;
 
   vtkMaptkCamera* activeCamera();
+  kwiver::vital::frame_id_t activeFrame() const;
+  kwiver::vital::camera_map_sptr cameraMap() const;
   WorldView* worldView();
   CameraView* cameraView();
   kwiver::vital::local_geo_cs localGeoCoordinateSystem() const;
 
+  // Create and open a video source for the imagery which is independent of
+  // the one used to display frames, or return null if there is no imagery
+  kwiver::vital::algo::video_input_sptr createVideoSource() const;
+
 public slots:
   void newProject();
 
@@ -127,7 +137,8 @@ protected slots:
   void updateToolResults();
   void addFrame(int);
   void updateFrames(
-    std::shared_ptr<kwiver::vital::metadata_map::map_metadata_t>);
+    std::shared_ptr<kwiver::vital::metadata_map::map_metadata_t>,
+    kwiver::maptk::metadata_table_sptr);
   void updateVideoImportProgress(QString const&, int);
   void enableAntiAliasing(bool enable);
 
@@ -69,7 +69,7 @@ public:
   void removeItem(int id);
   void clear();
 
-  QSet<int> itemIds() const { return this->keyLabels.keys().toSet(); }
+  QSet<int> valuedItemIds() const { return this->valueTexts.keys().toSet(); }
   void updateLabelColors();
 
   QWidget* contentWidget;
@@ -81,6 +81,10 @@ protected:
 
   QHash<int, QLabel*> keyLabels;
   QHash<int, qtSqueezedLabel*> valueLabels;
+
+  // Text shown by the value labels which are set, used to skip redundant
+  // updates when changing frames
+  QHash<int, QString> valueTexts;
 };
 
 //-----------------------------------------------------------------------------
@@ -126,6 +130,13 @@ void MetadataViewPrivate::setItemValue(int id, QString const& valueText)
 {
   if (auto* const l = this->valueLabels.value(id, nullptr))
   {
+    auto const vi = this->valueTexts.find(id);
+    if (vi != this->valueTexts.end() && *vi == valueText)
+    {
+      return;
+    }
+    this->valueTexts.insert(id, valueText);
+
     if (valueText.isEmpty())
     {
       l->setText("(empty)");
@@ -143,6 +154,7 @@ void MetadataViewPrivate::setItemValue(int id, QString const& valueText)
 //-----------------------------------------------------------------------------
 void MetadataViewPrivate::clearItemValue(int id)
 {
+  this->valueTexts.remove(id);
   if (auto* const l = this->valueLabels.value(id, nullptr))
   {
     l->setText("(not available)");
@@ -156,6 +168,7 @@ void MetadataViewPrivate::removeItem(int id)
 {
   delete this->keyLabels.take(id);
   delete this->valueLabels.take(id);
+  this->valueTexts.remove(id);
 }
 
 //-----------------------------------------------------------------------------
@@ -165,6 +178,7 @@ void MetadataViewPrivate::clear()
   qDeleteAll(this->valueLabels);
   this->keyLabels.clear();
   this->valueLabels.clear();
+  this->valueTexts.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -238,29 +252,15 @@ void MetadataView::changeEvent(QEvent* e)
 }
 
 //-----------------------------------------------------------------------------
-void MetadataView::updateMetadata(
-  std::shared_ptr<kv::metadata_map::map_metadata_t> mdMap)
+void MetadataView::setMetadataTags(QSet<kv::vital_metadata_tag> const& mdKeys)
 {
   QTE_D();
 
   // Reset UI so fields will be in correct order
   d->clear();
 
-  QSet<kv::vital_metadata_tag> mdKeys;
   auto traits = kv::metadata_traits{};
 
-  // Collect all keys present in the metadata map
-  for (auto const& mdi : *mdMap)
-  {
-    for (auto const& mdp : mdi.second | kvr::valid)
-    {
-      for (auto const& mde : *mdp)
-      {
-        mdKeys.insert(mde.first);
-      }
-    }
-  }
-
   // Update UI fields
   using md_tag_type_t = std::underlying_type<kv::vital_metadata_tag>::type;
   constexpr auto lastMetadataTag =
@@ -277,15 +277,35 @@ void MetadataView::updateMetadata(
 }
 
 //-----------------------------------------------------------------------------
-void MetadataView::updateMetadata(kv::metadata_vector const& mdVec)
+void MetadataView::updateMetadata(
+  std::shared_ptr<kv::metadata_map::map_metadata_t> mdMap)
 {
-  QTE_D();
+  QSet<kv::vital_metadata_tag> mdKeys;
 
-  for (auto const k : d->itemIds())
+  // Collect all keys present in the metadata map
+  for (auto const& mdi : *mdMap)
   {
-    d->clearItemValue(k);
+    for (auto const& mdp : mdi.second | kvr::valid)
+    {
+      for (auto const& mde : *mdp)
+      {
+        mdKeys.insert(mde.first);
+      }
+    }
   }
 
+  this->setMetadataTags(mdKeys);
+}
+
+//-----------------------------------------------------------------------------
+void MetadataView::updateMetadata(kv::metadata_vector const& mdVec)
+{
+  QTE_D();
+
+  // Only format the values of this frame, and only touch the fields whose
+  // values were set before or are set now
+  auto oldIds = d->valuedItemIds();
+
   for (auto const& mdp : mdVec | kvr::valid)
   {
     for (auto const& mde : *mdp)
@@ -297,12 +317,18 @@ void MetadataView::updateMetadata(kv::metadata_vector const& mdVec)
       if (mdi)
       {
         d->setItemValue(k, qtString(mdi->as_string()));
+        oldIds.remove(k);
       }
     }
 
     // TODO handle multiple metadatas?
     break;
   }
+
+  for (auto const k : oldIds)
+  {
+    d->clearItemValue(k);
+  }
 }
 
 //END MetadataView
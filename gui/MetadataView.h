@@ -36,6 +36,7 @@
 #include <qtGlobal.h>
 
 #include <QScrollArea>
+#include <QSet>
 
 class MetadataViewPrivate;
 
@@ -50,8 +51,13 @@ public:
   bool eventFilter(QObject* sender, QEvent* e) override;
 
 public slots:
+  // Set the fields shown to those of the given tags
+  void setMetadataTags(QSet<kwiver::vital::vital_metadata_tag> const&);
+  // Set the fields shown to those of the tags present in any frame; prefer
+  // setMetadataTags when the tags are known, as this scans every frame
   void updateMetadata(
     std::shared_ptr<kwiver::vital::metadata_map::map_metadata_t>);
+  // Show the values of a single frame
   void updateMetadata(kwiver::vital::metadata_vector const&);
 
 protected:
@@ -141,8 +141,15 @@ void VideoImport::run()
     emit this->updated(frame);
   }
 
+  // Build the columnar table of the metadata, so that the GUI and tools need
+  // not scan every frame's metadata to query it; the map is ordered by frame
+  // and keeps the first metadata of a repeated frame, so videos whose
+  // metadata frames are out of order or repeated are handled too
+  auto const metadataTable =
+    std::make_shared<kwiver::maptk::metadata_table>(*metadataMap);
+
   emit this->progressChanged(QString("Loading video complete"), 100);
-  emit this->completed(metadataMap);
+  emit this->completed(metadataMap, metadataTable);
 
   d->video_reader->close();
 }
@@ -31,6 +31,8 @@
 #ifndef TELESCULPTOR_VIDEOINPUT_H_
 #define TELESCULPTOR_VIDEOINPUT_H_
 
+#include <maptk/metadata_table.h>
+
 #include <vital/types/local_geo_cs.h>
 
 #include <vital/vital_types.h>
@@ -48,6 +50,7 @@
 class VideoImportPrivate;
 
 Q_DECLARE_METATYPE(std::shared_ptr<kwiver::vital::metadata_map::map_metadata_t>);
+Q_DECLARE_METATYPE(kwiver::maptk::metadata_table_sptr);
 
 class VideoImport : public QThread
 {
@@ -65,7 +68,8 @@ public:
 
 signals:
   /// Emitted when the tool execution is completed.
-  void completed(std::shared_ptr<kwiver::vital::metadata_map::map_metadata_t>);
+  void completed(std::shared_ptr<kwiver::vital::metadata_map::map_metadata_t>,
+                 kwiver::maptk::metadata_table_sptr);
   /// Emitted when an intermediate update of the data is available to show progress.
   void updated(int);
   /// Update progress
@@ -48,6 +48,10 @@
 #include "vtkMaptkInteractorStyle.h"
 #include "vtkMaptkScalarDataFilter.h"
 
+#include <maptk/parallel_for.h>
+#include <maptk/point_cloud_writer.h>
+#include <maptk/residual_statistics.h>
+#include <maptk/robust_bounds.h>
 #include <maptk/write_pdal.h>
 
 #include <vital/types/camera.h>
@@ -62,6 +66,7 @@
 #include <vtkCubeAxesActor.h>
 #include <vtkDoubleArray.h>
 #include <vtkEventQtSlotConnect.h>
+#include <vtkFloatArray.h>
 #include <vtkFlyingEdges3D.h>
 #include <vtkGenericOpenGLRenderWindow.h>
 #include <vtkGeometryFilter.h>
@@ -106,10 +111,43 @@
 #include <QToolButton>
 #include <QWidgetAction>
 
+#include <mutex>
+#include <numeric>
+
 using namespace LandmarkArrays;
 
 QTE_IMPLEMENT_D_FUNC(WorldView)
 
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void writePoints(QString const& path, kwiver::vital::local_geo_cs const& lgcs,
+                 T const* points, size_t numPts, unsigned char const* colors)
+{
+  auto const filename = stdString(path);
+  auto const ext = QFileInfo(path).suffix().toLower();
+  if (ext == "las" || ext == "laz")
+  {
+    // The whole cloud is already in memory, so let PDAL pull from it directly
+    kwiver::maptk::write_pdal(filename, lgcs, points, numPts, colors);
+    return;
+  }
+
+  // Write in chunks so that only one chunk is packed at a time
+  static constexpr size_t chunkSize = 1 << 20;
+  kwiver::maptk::point_cloud_writer writer{filename, lgcs, !!colors};
+  for (size_t i = 0; i < numPts; i += chunkSize)
+  {
+    auto const n = std::min(chunkSize, numPts - i);
+    writer.write(points + 3 * i, n, colors ? colors + 3 * i : nullptr);
+  }
+  writer.close();
+}
+
+} // namespace <anonymous>
+
 //-----------------------------------------------------------------------------
 class WorldViewPrivate
 {
@@ -144,11 +182,9 @@ public:
   void setRobustROI();
   bool computeRobustROI(double bounds[6]);
 
-  void
-  vtkToPointList(vtkSmartPointer<vtkPolyData> mesh,
-                 std::string const& colorArrayName,
-                 std::vector<kwiver::vital::vector_3d>& points,
-                 std::vector<kwiver::vital::rgb_color>& colors);
+  void writePointCloud(QString const& path,
+                       kwiver::vital::local_geo_cs const& lgcs,
+                       vtkPolyData* data, char const* colorArrayName);
 
   Ui::WorldView UI;
   Am::WorldView AM;
@@ -158,11 +194,14 @@ public:
 
   vtkNew<vtkMaptkCameraRepresentation> cameraRep;
 
+  std::vector<kwiver::vital::landmark_id_t> landmarkIds;
   vtkNew<vtkPoints> landmarkPoints;
   vtkNew<vtkCellArray> landmarkVerts;
   vtkNew<vtkDoubleArray> landmarkElevations;
   vtkNew<vtkUnsignedCharArray> landmarkColors;
   vtkNew<vtkUnsignedIntArray> landmarkObservations;
+  vtkNew<vtkFloatArray> landmarkResiduals;
+  QHash<QString, FieldInformation> landmarkFields;
   vtkNew<vtkPolyDataMapper> landmarkMapper;
   vtkNew<vtkActor> landmarkActor;
 
@@ -336,88 +375,67 @@ void WorldViewPrivate::setRobustROI()
 //-----------------------------------------------------------------------------
 bool WorldViewPrivate::computeRobustROI(double bounds[6])
 {
-  constexpr double percentile = 0.1;
-  // use a different percentile for z-max, that's typically where you have
-  // small structures (poles, towers) with few points.
-  constexpr double zmax_percentile = 0.01;
-  constexpr double margin = 0.5;
   this->landmarkActor->GetMapper()->Update();
-  vtkIdType numPts = this->landmarkPoints->GetNumberOfPoints();
-  if (numPts < 2)
-  {
-    return false;
-  }
-  std::vector<double> x, y, z;
-  x.reserve(numPts);
-  y.reserve(numPts);
-  z.reserve(numPts);
-  for (vtkIdType i = 0; i < numPts; ++i)
+
+  // Landmark points are stored as floats; compute the bounds directly from
+  // the point buffer rather than copying it
+  auto const numPts =
+    static_cast<size_t>(this->landmarkPoints->GetNumberOfPoints());
+  auto* const data = this->landmarkPoints->GetData();
+  if (auto* const floatData = vtkFloatArray::SafeDownCast(data))
   {
-    double pt[3];
-    this->landmarkPoints->GetPoint(i, pt);
-    x.push_back(pt[0]);
-    y.push_back(pt[1]);
-    z.push_back(pt[2]);
+    return kwiver::maptk::compute_robust_bounds(
+      floatData->GetPointer(0), numPts, bounds);
   }
-  std::sort(x.begin(), x.end());
-  std::sort(y.begin(), y.end());
-  std::sort(z.begin(), z.end());
-  vtkIdType minIdx = static_cast<vtkIdType>(percentile * (numPts - 1));
-  vtkIdType maxIdx = static_cast<vtkIdType>(numPts - 1 - minIdx);
-  vtkIdType zmaxIdx = static_cast<vtkIdType>((numPts - 1) *
-                                              (1.0 - zmax_percentile));
-  bounds[0] = x[minIdx];
-  bounds[1] = x[maxIdx];
-  bounds[2] = y[minIdx];
-  bounds[3] = y[maxIdx];
-  bounds[4] = z[minIdx];
-  bounds[5] = z[zmaxIdx];
-  for (unsigned i = 0; i < 3; ++i)
+  if (auto* const doubleData = vtkDoubleArray::SafeDownCast(data))
   {
-    unsigned i_min = 2 * i;
-    unsigned i_max = i_min + 1;
-    double offset = (bounds[i_max] - bounds[i_min]) * margin;
-    bounds[i_min] -= offset;
-    bounds[i_max] += offset;
+    return kwiver::maptk::compute_robust_bounds(
+      doubleData->GetPointer(0), numPts, bounds);
   }
-  return true;
+  return false;
 }
 
 //-----------------------------------------------------------------------------
-void
-WorldViewPrivate::vtkToPointList(vtkSmartPointer<vtkPolyData> data,
-                                 std::string const& colorArrayName,
-                                 std::vector<kwiver::vital::vector_3d>& points,
-                                 std::vector<kwiver::vital::rgb_color>& colors)
+void WorldViewPrivate::writePointCloud(QString const& path,
+                                       kwiver::vital::local_geo_cs const& lgcs,
+                                       vtkPolyData* data,
+                                       char const* colorArrayName)
 {
-  namespace kv = kwiver::vital;
-  vtkPoints *inPts = data->GetPoints();
-  vtkIdType numPts = inPts->GetNumberOfPoints();
-  points.resize(numPts);
-  colors.clear();
+  // Hand the VTK buffers directly to the writers rather than copying the
+  // points into an intermediate list
+  auto const points = data->GetPoints();
+  auto const numPts =
+    static_cast<size_t>(points ? points->GetNumberOfPoints() : 0);
+
+  // Colors are written whenever the caller names a color array
+  unsigned char const* colors = nullptr;
+  if (colorArrayName)
+  {
+    auto const rgbArray = vtkArrayDownCast<vtkUnsignedCharArray>(
+      data->GetPointData()->GetArray(colorArrayName));
+    if (rgbArray && rgbArray->GetNumberOfComponents() == 3)
+    {
+      colors = rgbArray->GetPointer(0);
+    }
+  }
 
-  vtkDataArray* da = nullptr;
-  if (this->volumeOptions->isColorOptionsEnabled())
+  auto const pointData = (points ? points->GetData() : nullptr);
+  if (auto* const floatData = vtkFloatArray::SafeDownCast(pointData))
   {
-    da = data->GetPointData()->GetArray(colorArrayName.c_str());
+    writePoints(path, lgcs, floatData->GetPointer(0), numPts, colors);
   }
-  vtkUnsignedCharArray* rgbArray = nullptr;
-  if (da != nullptr && da->GetNumberOfComponents() == 3)
+  else if (auto* const doubleData = vtkDoubleArray::SafeDownCast(pointData))
   {
-    rgbArray = vtkArrayDownCast<vtkUnsignedCharArray>(da);
-    colors.resize(numPts);
+    writePoints(path, lgcs, doubleData->GetPointer(0), numPts, colors);
   }
-
-  for (vtkIdType i = 0; i < numPts; ++i)
+  else
   {
-    inPts->GetPoint(i, points[i].data());
-    if (rgbArray)
+    vtkNew<vtkDoubleArray> converted;
+    if (pointData)
     {
-      vtkIdType idx = 3 * i;
-      colors[i] = kv::rgb_color(rgbArray->GetValue(idx),
-                                rgbArray->GetValue(idx + 1),
-                                rgbArray->GetValue(idx + 2));
+      converted->DeepCopy(pointData);
     }
+    writePoints(path, lgcs, converted->GetPointer(0), numPts, colors);
   }
 }
 
@@ -594,6 +612,8 @@ WorldView::WorldView(QWidget* parent, Qt::WindowFlags flags)
 
   auto const landmarkPointData = landmarkPolyData->GetPointData();
 
+  d->landmarkPoints->SetDataTypeToFloat();
+
   d->landmarkColors->SetName(TrueColor);
   d->landmarkColors->SetNumberOfComponents(3);
 
@@ -603,11 +623,15 @@ WorldView::WorldView(QWidget* parent, Qt::WindowFlags flags)
   d->landmarkObservations->SetName(Observations);
   d->landmarkObservations->SetNumberOfComponents(1);
 
+  d->landmarkResiduals->SetName(ReprojectionError);
+  d->landmarkResiduals->SetNumberOfComponents(1);
+
   landmarkPolyData->SetPoints(d->landmarkPoints);
   landmarkPolyData->SetVerts(d->landmarkVerts);
   landmarkPointData->AddArray(d->landmarkColors);
   landmarkPointData->AddArray(d->landmarkElevations);
   landmarkPointData->AddArray(d->landmarkObservations);
+  landmarkPointData->AddArray(d->landmarkResiduals);
   d->landmarkMapper->SetInputData(landmarkPolyData);
 
   d->landmarkActor->SetMapper(d->landmarkMapper);
@@ -1024,67 +1048,183 @@ void WorldView::setLandmarks(kwiver::vital::landmark_map const& lm)
 {
   QTE_D();
 
+  // Take a flat snapshot of the landmark map so that the VTK arrays can be
+  // filled in parallel; if the set of landmark IDs is unchanged (e.g. during
+  // bundle adjustment updates), only the arrays that differ are marked as
+  // modified so that colors and observations are not uploaded again
   auto const& landmarks = lm.landmarks();
   auto const size = static_cast<vtkIdType>(landmarks.size());
 
+  auto sameLayout = (d->landmarkIds.size() == landmarks.size());
+  auto snapshot = std::vector<kwiver::vital::landmark const*>{};
+  snapshot.reserve(landmarks.size());
+  d->landmarkIds.resize(landmarks.size());
+  auto idIter = d->landmarkIds.begin();
+  foreach (auto const& lm, landmarks)
+  {
+    sameLayout = sameLayout && (*idIter == lm.first);
+    *idIter++ = lm.first;
+    snapshot.push_back(lm.second.get());
+  }
+
+  if (!sameLayout)
+  {
+    d->landmarkPoints->SetNumberOfPoints(size);
+    d->landmarkColors->SetNumberOfTuples(size);
+    d->landmarkElevations->SetNumberOfTuples(size);
+    d->landmarkObservations->SetNumberOfTuples(size);
+    d->landmarkResiduals->SetNumberOfTuples(size);
+    d->landmarkResiduals->FillValue(0.0f);
+
+    // Use a single poly-vertex rather than one vertex cell per landmark
+    d->landmarkVerts->Reset();
+    if (size)
+    {
+      auto const verts = d->landmarkVerts->WritePointer(1, size + 1);
+      verts[0] = size;
+      std::iota(verts + 1, verts + size + 1, vtkIdType{0});
+    }
+    d->landmarkVerts->Modified();
+  }
+
+  auto const points =
+    static_cast<float*>(d->landmarkPoints->GetVoidPointer(0));
+  auto const colors = d->landmarkColors->GetPointer(0);
+  auto const elevations = d->landmarkElevations->GetPointer(0);
+  auto const observations = d->landmarkObservations->GetPointer(0);
+
   auto const defaultColor = kwiver::vital::rgb_color{};
   auto haveColor = false;
+  auto colorsChanged = !sameLayout;
+  auto observationsChanged = !sameLayout;
   auto maxObservations = unsigned{0};
   auto minZ = qInf(), maxZ = -qInf();
+  std::mutex mutex;
 
-  d->landmarkPoints->Reset();
-  d->landmarkVerts->Reset();
-  d->landmarkColors->Reset();
-  d->landmarkElevations->Reset();
-  d->landmarkObservations->Reset();
-  d->landmarkPoints->Allocate(size);
-  d->landmarkVerts->Allocate(size);
-  d->landmarkColors->Allocate(3 * size);
-  d->landmarkElevations->Allocate(size);
-  d->landmarkObservations->Allocate(size);
-
-  vtkIdType vertIndex = 0;
-  foreach (auto const& lm, landmarks)
-  {
-    auto const& pos = lm.second->loc();
-    auto const& color = lm.second->color();
-    auto const observations = lm.second->observations();
-
-    d->landmarkPoints->InsertNextPoint(pos.data());
-    d->landmarkVerts->InsertNextCell(1);
-    d->landmarkVerts->InsertCellPoint(vertIndex++);
-    d->landmarkColors->InsertNextValue(color.r);
-    d->landmarkColors->InsertNextValue(color.g);
-    d->landmarkColors->InsertNextValue(color.b);
-    d->landmarkElevations->InsertNextValue(pos[2]);
-    d->landmarkObservations->InsertNextValue(observations);
-
-    haveColor = haveColor || (color != defaultColor);
-    maxObservations = qMax(maxObservations, observations);
-    minZ = qMin(minZ, pos[2]);
-    maxZ = qMax(maxZ, pos[2]);
-  }
+  kwiver::maptk::parallel_for(
+    0, snapshot.size(), [&](size_t begin, size_t end){
+      auto chunkHaveColor = false;
+      auto chunkColorsChanged = false;
+      auto chunkObservationsChanged = false;
+      auto chunkMaxObservations = unsigned{0};
+      auto chunkMinZ = qInf(), chunkMaxZ = -qInf();
 
-  auto fields = QHash<QString, FieldInformation>{};
+      for (auto i = begin; i < end; ++i)
+      {
+        auto const& lm = *snapshot[i];
+        auto const& pos = lm.loc();
+        auto const& color = lm.color();
+        auto const n = lm.observations();
+
+        points[3 * i + 0] = static_cast<float>(pos[0]);
+        points[3 * i + 1] = static_cast<float>(pos[1]);
+        points[3 * i + 2] = static_cast<float>(pos[2]);
+        elevations[i] = pos[2];
+
+        auto const c = colors + (3 * i);
+        chunkColorsChanged = chunkColorsChanged ||
+          c[0] != color.r || c[1] != color.g || c[2] != color.b;
+        c[0] = color.r;
+        c[1] = color.g;
+        c[2] = color.b;
+
+        chunkObservationsChanged =
+          chunkObservationsChanged || observations[i] != n;
+        observations[i] = n;
+
+        chunkHaveColor = chunkHaveColor || (color != defaultColor);
+        chunkMaxObservations = qMax(chunkMaxObservations, n);
+        chunkMinZ = qMin(chunkMinZ, pos[2]);
+        chunkMaxZ = qMax(chunkMaxZ, pos[2]);
+      }
+
+      std::lock_guard<std::mutex> lock{mutex};
+      haveColor = haveColor || chunkHaveColor;
+      colorsChanged = colorsChanged || chunkColorsChanged;
+      observationsChanged = observationsChanged || chunkObservationsChanged;
+      maxObservations = qMax(maxObservations, chunkMaxObservations);
+      minZ = qMin(minZ, chunkMinZ);
+      maxZ = qMax(maxZ, chunkMaxZ);
+    });
+
+  // Residuals remain valid while the landmarks only move, but must be
+  // recomputed if the set of landmarks changes
+  auto& fields = d->landmarkFields;
+  auto const residualField = fields.value("Reprojection Error");
+  fields.clear();
   fields.insert("Elevation", FieldInformation{Elevation, {minZ, maxZ}});
   if (maxObservations)
   {
     auto const upper = static_cast<double>(maxObservations);
     fields.insert("Observations", FieldInformation{Observations, {0.0, upper}});
   }
+  if (sameLayout && !residualField.name.isEmpty())
+  {
+    fields.insert("Reprojection Error", residualField);
+  }
 
   d->landmarkOptions->setTrueColorAvailable(haveColor);
   d->landmarkOptions->setDataFields(fields);
 
   d->landmarkPoints->Modified();
-  d->landmarkVerts->Modified();
-  d->landmarkColors->Modified();
-  d->landmarkObservations->Modified();
+  d->landmarkElevations->Modified();
+  if (colorsChanged)
+  {
+    d->landmarkColors->Modified();
+  }
+  if (observationsChanged)
+  {
+    d->landmarkObservations->Modified();
+  }
 
   d->updateScale(this);
   d->updateAxes(this);
 }
 
+//-----------------------------------------------------------------------------
+void WorldView::setLandmarkResiduals(
+  kwiver::maptk::residual_statistics const& stats)
+{
+  QTE_D();
+
+  // Look up the RMSE of each landmark's track; the track summaries and the
+  // landmark IDs are both sorted, so a single merge pass suffices
+  auto const& tracks = stats.tracks();
+  auto const residuals = d->landmarkResiduals->GetPointer(0);
+  auto maxResidual = 0.0;
+
+  auto trackIter = tracks.begin();
+  for (size_t i = 0; i < d->landmarkIds.size(); ++i)
+  {
+    auto const id = d->landmarkIds[i];
+    while (trackIter != tracks.end() && trackIter->first < id)
+    {
+      ++trackIter;
+    }
+
+    auto residual = 0.0;
+    if (trackIter != tracks.end() && trackIter->first == id)
+    {
+      residual = trackIter->second.rmse();
+    }
+    residuals[i] = static_cast<float>(residual);
+    maxResidual = qMax(maxResidual, residual);
+  }
+  d->landmarkResiduals->Modified();
+
+  if (d->landmarkIds.empty())
+  {
+    return;
+  }
+
+  d->landmarkFields.insert(
+    "Reprojection Error",
+    FieldInformation{ReprojectionError, {0.0, maxResidual}});
+  d->landmarkOptions->setDataFields(d->landmarkFields);
+
+  this->render();
+}
+
 //-----------------------------------------------------------------------------
 void WorldView::setImageVisible(bool state)
 {
@@ -1409,17 +1549,11 @@ void WorldView::saveDepthPoints(QString const& path,
                                 kwiver::vital::local_geo_cs const& lgcs)
 {
   QTE_D();
-  namespace kv = kwiver::vital;
-  if (QFileInfo(path).suffix().toLower() == "las")
+  if (kwiver::maptk::point_cloud_writer::is_supported(stdString(path)))
   {
-    // convert the point cloud into a set of landmarks,
-    // then use the PDAL writer for landmarks
-    vtkSmartPointer<vtkPolyData> data =
+    auto const data =
       vtkPolyData::SafeDownCast(d->depthScalarFilter->GetOutput());
-    std::vector<kv::vector_3d> points;
-    std::vector<kv::rgb_color> colors;
-    d->vtkToPointList(data, DepthMapArrays::TrueColor, points, colors);
-    kwiver::maptk::write_pdal(stdString(path), lgcs, points, colors);
+    d->writePointCloud(path, lgcs, data, DepthMapArrays::TrueColor);
   }
   else
   {
@@ -1495,7 +1629,6 @@ void WorldView::saveFusedMesh(const QString &path,
                               kwiver::vital::local_geo_cs const& lgcs)
 {
   QTE_D();
-  namespace kv = kwiver::vital;
   const QString ext = QFileInfo(path).suffix().toLower();
   if (ext == "ply")
   {
@@ -1511,14 +1644,15 @@ void WorldView::saveFusedMesh(const QString &path,
     writer->AddInputDataObject(mesh);
     writer->Write();
   }
-  else if (ext == "las")
+  else if (ext == "las" || ext == "laz" || ext == "pcd")
   {
+    // Point cloud formats only keep the mesh vertices; as for PLY, colors
+    // are only written if the volume is colored
     vtkSmartPointer<vtkPolyData> mesh = d->contourFilter->GetOutput();
-    std::vector<kv::vector_3d> points;
-    std::vector<kv::rgb_color> colors;
-    d->vtkToPointList(mesh, mesh->GetPointData()->GetScalars()->GetName(),
-                      points, colors);
-    kwiver::maptk::write_pdal(stdString(path), lgcs, points, colors);
+    auto const scalars = mesh->GetPointData()->GetScalars();
+    auto const colored = d->volumeOptions->isColorOptionsEnabled();
+    d->writePointCloud(path, lgcs, mesh,
+                       colored && scalars ? scalars->GetName() : nullptr);
   }
   else
   {
@@ -48,6 +48,7 @@ class vtkPolyData;
 class vtkStructuredGrid;
 
 namespace kwiver { namespace vital { class landmark_map; } }
+namespace kwiver { namespace maptk { class residual_statistics; } }
 
 class GroundControlPointsWidget;
 class RulerWidget;
@@ -95,6 +96,7 @@ public slots:
   void addCamera(int id, vtkMaptkCamera* camera);
   void removeCamera(int id);
   void setLandmarks(kwiver::vital::landmark_map const&);
+  void setLandmarkResiduals(kwiver::maptk::residual_statistics const&);
 
   void setValidDepthInput(bool);
   void connectDepthPipeline();
@@ -73,6 +73,7 @@ int main(int argc, char** argv)
   using map_metadata_t = kwiver::vital::metadata_map::map_metadata_t;
   qRegisterMetaType<std::shared_ptr<ToolData>>();
   qRegisterMetaType<std::shared_ptr<map_metadata_t>>();
+  qRegisterMetaType<kwiver::maptk::metadata_table_sptr>();
 
   // Set up command line options
   qtCliArgs args(argc, argv);
@@ -46,6 +46,7 @@ public:
   virtual void run() override;
 
   std::shared_ptr<ToolData> data;
+  std::shared_ptr<SolutionSnapshot> snapshot;
 
   std::atomic<bool> cancelRequested;
 
@@ -61,9 +62,19 @@ void AbstractToolPrivate::run()
 {
   QTE_Q();
 
+  this->data->residuals.reset();
+
   try
   {
     q->run();
+
+    // Compute the reprojection errors of the final solution here, rather
+    // than on the GUI thread when the results are accepted
+    if (q->outputs() & (AbstractTool::Tracks | AbstractTool::Cameras |
+                        AbstractTool::Landmarks))
+    {
+      this->data->computeResiduals();
+    }
   }
   catch (const std::exception& e)
   {
@@ -162,6 +173,23 @@ void  ToolData::copyDepthLookup(depth_lookup_sptr const& newDepthLookup)
   }
 }
 
+//-----------------------------------------------------------------------------
+void ToolData::computeResiduals()
+{
+  this->residuals.reset();
+  if (!this->cameras || !this->landmarks || !this->tracks ||
+      !this->landmarks->size())
+  {
+    return;
+  }
+
+  auto stats = std::make_shared<kwiver::maptk::residual_statistics>();
+  stats->compute(this->cameras->cameras(),
+                 this->landmarks->landmarks(),
+                 this->tracks->tracks());
+  this->residuals = stats;
+}
+
 //-----------------------------------------------------------------------------
 AbstractTool::AbstractTool(QObject* parent)
   : QAction(parent), d_ptr(new AbstractToolPrivate(this))
@@ -212,6 +240,13 @@ kwiver::vital::feature_track_set_sptr AbstractTool::tracks() const
   return d->data->tracks;
 }
 
+//-----------------------------------------------------------------------------
+AbstractTool::match_matrix_sptr AbstractTool::matchMatrix() const
+{
+  QTE_D();
+  return d->data->matchMatrix;
+}
+
 //-----------------------------------------------------------------------------
 kwiver::vital::camera_map_sptr AbstractTool::cameras() const
 {
@@ -233,6 +268,13 @@ AbstractTool::sfm_constraints_sptr AbstractTool::sfmConstraints() const
   return d->data->constraints;
 }
 
+//-----------------------------------------------------------------------------
+kwiver::maptk::metadata_table_sptr AbstractTool::metadataTable() const
+{
+  QTE_D();
+  return d->data->metadataTable;
+}
+
 
 //-----------------------------------------------------------------------------
 void AbstractTool::cancel()
@@ -260,6 +302,7 @@ void AbstractTool::setTracks(feature_track_set_sptr const& newTracks)
 {
   QTE_D();
   d->data->copyTracks(newTracks);
+  d->data->matchMatrix = match_matrix_sptr();
 }
 
 //-----------------------------------------------------------------------------
@@ -297,6 +340,14 @@ void AbstractTool::setSfmConstraints(sfm_constraints_sptr const& newConstraints)
   }
 }
 
+//-----------------------------------------------------------------------------
+void AbstractTool::setMetadataTable(
+  kwiver::maptk::metadata_table_sptr const& newTable)
+{
+  QTE_D();
+  d->data->metadataTable = newTable;
+}
+
 //-----------------------------------------------------------------------------
 void AbstractTool::setROI(vtkBox *newROI)
 {
@@ -340,6 +391,7 @@ bool AbstractTool::execute(QWidget* window)
   // Reset progress reporting parameters
   this->updateProgress(0);
   this->setDescription("");
+  d->snapshot = std::make_shared<SolutionSnapshot>();
   d->cancelRequested = false;
   d->start();
   return true;
@@ -401,6 +453,29 @@ void AbstractTool::updateTracks(feature_track_set_sptr const& newTracks)
   d->data->tracks = newTracks;
 }
 
+//-----------------------------------------------------------------------------
+void AbstractTool::updateMatchMatrix(match_matrix_sptr const& newMatchMatrix)
+{
+  QTE_D();
+  d->data->matchMatrix = newMatchMatrix;
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<ToolData> AbstractTool::publishSolution(
+  camera_map_sptr const& newCameras, landmark_map_sptr const& newLandmarks)
+{
+  QTE_D();
+
+  auto const noCameras = kwiver::vital::simple_camera_map{};
+  auto const noLandmarks = kwiver::vital::simple_landmark_map{};
+  d->snapshot->publish(newCameras ? *newCameras : noCameras,
+                       newLandmarks ? *newLandmarks : noLandmarks);
+
+  auto data = std::make_shared<ToolData>();
+  data->snapshot = d->snapshot;
+  return data;
+}
+
 //-----------------------------------------------------------------------------
 void AbstractTool::updateDepth(depth_sptr const& newDepth)
 {
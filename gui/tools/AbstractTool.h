@@ -31,6 +31,12 @@
 #ifndef TELESCULPTOR_ABSTRACTTOOL_H_
 #define TELESCULPTOR_ABSTRACTTOOL_H_
 
+#include "SolutionSnapshot.h"
+
+#include <maptk/match_matrix.h>
+#include <maptk/metadata_table.h>
+#include <maptk/residual_statistics.h>
+
 #include <vital/config/config_block_types.h>
 #include <vital/logger/logger.h>
 #include <vital/types/camera_map.h>
@@ -63,6 +69,10 @@ public:
   typedef kwiver::vital::config_block_sptr config_block_sptr;
   typedef vtkSmartPointer<vtkImageData> depth_sptr;
   typedef std::shared_ptr<std::map<kwiver::vital::frame_id_t, std::string> > depth_lookup_sptr;
+  typedef kwiver::maptk::match_matrix_accumulator_sptr match_matrix_sptr;
+  typedef std::shared_ptr<SolutionSnapshot> snapshot_sptr;
+  typedef kwiver::maptk::metadata_table_sptr metadata_table_sptr;
+  typedef std::shared_ptr<kwiver::maptk::residual_statistics> residuals_sptr;
 
   /// Deep copy the feature tracks into this data class
   void copyTracks(feature_track_set_sptr const&);
@@ -82,16 +92,31 @@ public:
   /// Deep copy the list of depthmaps into this data class
   void copyDepthLookup(depth_lookup_sptr const&);
 
+  /// Compute the reprojection error statistics of the cameras, landmarks
+  /// and tracks in this data class
+  void computeResiduals();
+
   int maxFrame;
   unsigned int activeFrame;
   std::string videoPath;
   std::string maskPath;
   feature_track_set_sptr tracks;
   feature_track_set_changes_sptr track_changes;
+  match_matrix_sptr matchMatrix;
   depth_sptr active_depth;
   camera_map_sptr cameras;
   landmark_map_sptr landmarks;
   sfm_constraints_sptr constraints;
+  /// Columnar video metadata; shared rather than copied since it is
+  /// never modified
+  metadata_table_sptr metadataTable;
+  /// Intermediate camera and landmark parameters, shared with the tool
+  /// rather than copied; used instead of cameras and landmarks for interim
+  /// updates from tools that publish solutions frequently
+  snapshot_sptr snapshot;
+  /// Reprojection error statistics of the final cameras, landmarks and
+  /// tracks; computed by the tool thread once the tool has finished
+  residuals_sptr residuals;
   config_block_sptr config;
   kwiver::vital::logger_handle_t logger;
   int progress;
@@ -114,6 +139,8 @@ public:
   typedef kwiver::vital::landmark_map_sptr landmark_map_sptr;
   typedef kwiver::vital::sfm_constraints_sptr sfm_constraints_sptr;
   typedef kwiver::vital::config_block_sptr config_block_sptr;
+  typedef kwiver::maptk::match_matrix_accumulator_sptr match_matrix_sptr;
+  typedef std::shared_ptr<SolutionSnapshot> snapshot_sptr;
   typedef vtkSmartPointer<vtkImageData> depth_sptr;
 
   enum Output
@@ -173,6 +200,9 @@ public:
   /// Set the sfm constraints to be used as input to the tool.
   void setSfmConstraints(sfm_constraints_sptr const&);
 
+  /// Set the columnar video metadata to be used as input to the tool.
+  void setMetadataTable(kwiver::maptk::metadata_table_sptr const&);
+
   /// Set the 3D region of interest
   void setROI(vtkBox *);
 
@@ -219,6 +249,16 @@ public:
   ///          as doing so may not be thread safe.
   feature_track_set_sptr tracks() const;
 
+  /// Get the match matrix.
+  ///
+  /// This returns the match matrix of the tracks resulting from the tool
+  /// execution, if the tool maintains one. Otherwise this returns a null
+  /// pointer, and the caller must compute the match matrix from tracks().
+  ///
+  /// \warning Users must not call this method while the tool is executing,
+  ///          as doing so may not be thread safe.
+  match_matrix_sptr matchMatrix() const;
+
   /// Get cameras.
   ///
   /// This returns the new cameras resulting from the tool execution. If the
@@ -256,6 +296,13 @@ public:
   ///          as doing so may not be thread safe.
   sfm_constraints_sptr sfmConstraints() const;
 
+  /// Get the columnar video metadata.
+  ///
+  /// This returns the metadata of the video in columnar form, or a null
+  /// pointer if the video metadata has not been loaded. The table is shared
+  /// and must not be modified.
+  kwiver::maptk::metadata_table_sptr metadataTable() const;
+
   /// Get tool progress.
   ///
   /// This returns the tool execution progress as an integer.
@@ -333,6 +380,12 @@ protected:
   /// setTracks, this does not make a deep copy of the provided tracks.
   void updateTracks(feature_track_set_sptr const&);
 
+  /// Set the match matrix of the tracks produced by the tool.
+  ///
+  /// This sets the match matrix that is maintained by the tool as the tracks
+  /// are produced. This does not make a deep copy of the provided matrix.
+  void updateMatchMatrix(match_matrix_sptr const&);
+
   /// Set the cameras produced by the tool.
   ///
   /// This sets the cameras that are produced by the tool as output. Unlike
@@ -348,6 +401,15 @@ protected:
   /// setCameras, this does not make a deep copy of the provided landmarks.
   void updateLandmarks(landmark_map_sptr const&);
 
+  /// Publish an intermediate solution.
+  ///
+  /// This writes the cameras and landmarks into the solution snapshot of the
+  /// current execution without cloning them, and returns tool data referring
+  /// to the snapshot which may be emitted via updated(). Successive calls
+  /// reuse the snapshot buffers.
+  std::shared_ptr<ToolData> publishSolution(camera_map_sptr const&,
+                                            landmark_map_sptr const&);
+
   /// Set tool progress.
   ///
   /// This returns the tool execution progress as an integer.
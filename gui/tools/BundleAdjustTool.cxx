@@ -31,27 +31,230 @@
 #include "BundleAdjustTool.h"
 #include "GuiCommon.h"
 
+#include <maptk/camera_resection.h>
+
 #include <vital/algo/bundle_adjust.h>
+#include <vital/types/camera_perspective.h>
+#include <vital/types/camera_perspective_map.h>
 
 #include <QMessageBox>
 
+#include <algorithm>
+#include <iterator>
+#include <set>
+
 using kwiver::vital::algo::bundle_adjust;
 using kwiver::vital::algo::bundle_adjust_sptr;
 
+namespace kv = kwiver::vital;
+
 namespace
 {
 static char const* const BLOCK = "bundle_adjuster";
+static char const* const BLOCK_INC = "incremental_bundle_adjust";
+static char const* const BLOCK_RESECT = "resect_missing_cameras";
+
+//-----------------------------------------------------------------------------
+struct CameraState
+{
+  kv::vector_3d center;
+  kv::vector_4d rotation;
+  double focalLength;
+
+  bool operator==(CameraState const& other) const
+  {
+    return this->center == other.center &&
+           this->rotation == other.rotation &&
+           this->focalLength == other.focalLength;
+  }
+};
+
+//-----------------------------------------------------------------------------
+CameraState cameraState(kv::camera_perspective const& camera)
+{
+  return {camera.center(), camera.rotation().quaternion().coeffs(),
+          camera.intrinsics()->focal_length()};
+}
+
 }
 
 //-----------------------------------------------------------------------------
 class BundleAdjustToolPrivate
 {
 public:
+  std::set<kv::frame_id_t> changedFrames(
+    kv::camera_map::map_camera_t const& cameras,
+    kv::landmark_map::map_landmark_t const& landmarks,
+    kv::feature_track_set const& tracks) const;
+
+  void saveSolution(kv::camera_map::map_camera_t const& cameras,
+                    kv::landmark_map::map_landmark_t const& landmarks,
+                    kv::feature_track_set const& tracks);
+
   bundle_adjust_sptr algorithm;
+
+  // Incremental mode settings
+  bool incremental = false;
+  int windowSize = 10;
+  int globalInterval = 5;
+
+  // The solution produced by the previous run, used to find what has changed
+  std::map<kv::frame_id_t, CameraState> lastCameras;
+  std::map<kv::landmark_id_t, kv::vector_3d> lastLandmarks;
+  std::map<kv::track_id_t, std::vector<kv::frame_id_t>> lastTrackFrames;
+  int runsSinceGlobal = 0;
+
+  // Resection of frames without cameras after refinement
+  bool resect = false;
+  kv::config_block_sptr resectionConfig;
 };
 
 QTE_IMPLEMENT_D_FUNC(BundleAdjustTool)
 
+//-----------------------------------------------------------------------------
+std::set<kv::frame_id_t> BundleAdjustToolPrivate::changedFrames(
+  kv::camera_map::map_camera_t const& cameras,
+  kv::landmark_map::map_landmark_t const& landmarks,
+  kv::feature_track_set const& tracks) const
+{
+  std::set<kv::frame_id_t> changed;
+
+  // Cameras which are new or differ from the previous solution
+  for (auto const& c : cameras)
+  {
+    auto const cam =
+      std::dynamic_pointer_cast<kv::camera_perspective>(c.second);
+    if (!cam)
+    {
+      continue;
+    }
+    auto const last = this->lastCameras.find(c.first);
+    if (last == this->lastCameras.end() || !(last->second == cameraState(*cam)))
+    {
+      changed.insert(c.first);
+    }
+  }
+
+  // Cameras of the previous solution which have since been removed
+  for (auto const& c : this->lastCameras)
+  {
+    auto const cam = cameras.find(c.first);
+    if (cam == cameras.end() ||
+        !std::dynamic_pointer_cast<kv::camera_perspective>(cam->second))
+    {
+      changed.insert(c.first);
+    }
+  }
+
+  // Frames observing landmarks which are new, removed or differ from the
+  // previous solution, and frames of observations which have been added to or
+  // removed from a track with a landmark
+  auto const markFrames = [&](std::vector<kv::frame_id_t> const& frames)
+  {
+    for (auto const f : frames)
+    {
+      if (cameras.count(f))
+      {
+        changed.insert(f);
+      }
+    }
+  };
+
+  std::set<kv::track_id_t> trackIds;
+  std::vector<kv::frame_id_t> frames, addedOrRemoved;
+  for (auto const& t : tracks.tracks())
+  {
+    trackIds.insert(t->id());
+
+    frames.clear();
+    for (auto const& ts : *t)
+    {
+      frames.push_back(ts->frame());
+    }
+
+    auto const lm = landmarks.find(t->id());
+    auto const hasLandmark = (lm != landmarks.end() && lm->second);
+    auto const last = this->lastLandmarks.find(t->id());
+    auto const hadLandmark = (last != this->lastLandmarks.end());
+    if (hasLandmark != hadLandmark ||
+        (hasLandmark && !(last->second == lm->second->loc())))
+    {
+      markFrames(frames);
+      continue;
+    }
+    if (!hasLandmark)
+    {
+      continue;
+    }
+
+    auto const lastFrames = this->lastTrackFrames.find(t->id());
+    if (lastFrames == this->lastTrackFrames.end())
+    {
+      markFrames(frames);
+      continue;
+    }
+    addedOrRemoved.clear();
+    std::set_symmetric_difference(
+      frames.begin(), frames.end(),
+      lastFrames->second.begin(), lastFrames->second.end(),
+      std::back_inserter(addedOrRemoved));
+    markFrames(addedOrRemoved);
+  }
+
+  // Tracks of the previous solution which have since been removed
+  for (auto const& t : this->lastTrackFrames)
+  {
+    if (!trackIds.count(t.first))
+    {
+      markFrames(t.second);
+    }
+  }
+
+  return changed;
+}
+
+//-----------------------------------------------------------------------------
+void BundleAdjustToolPrivate::saveSolution(
+  kv::camera_map::map_camera_t const& cameras,
+  kv::landmark_map::map_landmark_t const& landmarks,
+  kv::feature_track_set const& tracks)
+{
+  this->lastCameras.clear();
+  for (auto const& c : cameras)
+  {
+    auto const cam =
+      std::dynamic_pointer_cast<kv::camera_perspective>(c.second);
+    if (cam)
+    {
+      this->lastCameras.emplace(c.first, cameraState(*cam));
+    }
+  }
+
+  this->lastLandmarks.clear();
+  for (auto const& l : landmarks)
+  {
+    if (l.second)
+    {
+      this->lastLandmarks.emplace(l.first, l.second->loc());
+    }
+  }
+
+  // Only the observations of tracks with landmarks affect the solution
+  this->lastTrackFrames.clear();
+  for (auto const& t : tracks.tracks())
+  {
+    if (!this->lastLandmarks.count(t->id()))
+    {
+      continue;
+    }
+    auto& frames = this->lastTrackFrames[t->id()];
+    for (auto const& ts : *t)
+    {
+      frames.push_back(ts->frame());
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 BundleAdjustTool::BundleAdjustTool(QObject* parent)
   : AbstractTool(parent), d_ptr(new BundleAdjustToolPrivate)
@@ -108,9 +311,26 @@ bool BundleAdjustTool::execute(QWidget* window)
     return false;
   }
 
+  d->resect = config->get_value<bool>(std::string{BLOCK_RESECT} + ":enabled",
+                                      false);
+  d->resectionConfig = config->subblock(BLOCK_RESECT);
+  if (d->resect &&
+      !kwiver::maptk::check_resection_configuration(d->resectionConfig))
+  {
+    QMessageBox::critical(
+      window, "Configuration error",
+      "An error was found in the resection algorithm configuration.");
+    return false;
+  }
+
   // Create algorithm from configuration
   bundle_adjust::set_nested_algo_configuration(BLOCK, config, d->algorithm);
 
+  auto const block = std::string{BLOCK_INC};
+  d->incremental = config->get_value<bool>(block + ":enabled", false);
+  d->windowSize = config->get_value<int>(block + ":window_size", 10);
+  d->globalInterval = config->get_value<int>(block + ":global_interval", 5);
+
   // Set the callback to receive updates
   using std::placeholders::_1;
   using std::placeholders::_2;
@@ -132,7 +352,145 @@ void BundleAdjustTool::run()
   auto tp = this->tracks();
   auto sp = this->sfmConstraints();
 
-  d->algorithm->optimize(cp, lp, tp, sp);
+  auto cameras = cp->cameras();
+  auto landmarks = lp->landmarks();
+
+  // Decide whether a local optimization is sufficient; fall back to a global
+  // pass periodically, when there is no previous solution, or when most of
+  // the cameras have changed
+  auto local = false;
+  std::set<kv::frame_id_t> variableCameras;
+  if (d->incremental && !d->lastCameras.empty() &&
+      d->runsSinceGlobal + 1 < d->globalInterval)
+  {
+    auto const changed = d->changedFrames(cameras, landmarks, *tp);
+    if (!changed.empty() && 2 * changed.size() < cameras.size())
+    {
+      // Optimize the cameras within the window of any changed frame
+      std::vector<kv::frame_id_t> frames;
+      for (auto const& c : cameras)
+      {
+        if (std::dynamic_pointer_cast<kv::camera_perspective>(c.second))
+        {
+          frames.push_back(c.first);
+        }
+      }
+
+      // The window of a removed camera is centered where the camera was
+      auto const n = static_cast<int>(frames.size());
+      auto const w = std::max(0, d->windowSize);
+      for (auto const f : changed)
+      {
+        auto const i = static_cast<int>(
+          std::lower_bound(frames.begin(), frames.end(), f) - frames.begin());
+        for (int j = std::max(0, i - w); j <= std::min(n - 1, i + w); ++j)
+        {
+          variableCameras.insert(frames[j]);
+        }
+      }
+
+      local = 2 * variableCameras.size() < frames.size();
+    }
+  }
+
+  if (local)
+  {
+    // Optimize the landmarks observed by the window, together with the
+    // window cameras; other cameras observing those landmarks are included
+    // as fixed constraints
+    kv::simple_camera_perspective_map localCameras;
+    kv::landmark_map::map_landmark_t localLandmarks;
+    std::set<kv::frame_id_t> fixedCameras;
+    for (auto const& t : tp->tracks())
+    {
+      auto const lm = landmarks.find(t->id());
+      if (lm == landmarks.end() || !lm->second)
+      {
+        continue;
+      }
+
+      auto const inWindow =
+        std::any_of(t->begin(), t->end(), [&](kv::track_state_sptr const& ts){
+          return variableCameras.count(ts->frame()) > 0;
+        });
+      if (!inWindow)
+      {
+        continue;
+      }
+
+      localLandmarks.insert(*lm);
+      for (auto const& ts : *t)
+      {
+        auto const c = cameras.find(ts->frame());
+        auto const cam = (c == cameras.end() ? nullptr :
+          std::dynamic_pointer_cast<kv::camera_perspective>(c->second));
+        if (cam)
+        {
+          localCameras.insert(ts->frame(), cam);
+          if (!variableCameras.count(ts->frame()))
+          {
+            fixedCameras.insert(ts->frame());
+          }
+        }
+      }
+    }
+
+    d->algorithm->optimize(localCameras, localLandmarks, tp,
+                           fixedCameras, {}, sp);
+
+    for (auto const& c : localCameras.T_cameras())
+    {
+      cameras[c.first] = c.second;
+    }
+    for (auto const& l : localLandmarks)
+    {
+      landmarks[l.first] = l.second;
+    }
+    cp = std::make_shared<kv::simple_camera_map>(cameras);
+    lp = std::make_shared<kv::simple_landmark_map>(landmarks);
+
+    ++d->runsSinceGlobal;
+  }
+  else
+  {
+    d->algorithm->optimize(cp, lp, tp, sp);
+
+    d->runsSinceGlobal = 0;
+  }
+
+  if (d->resect && !this->isCanceled())
+  {
+    // Fill in the frames which have tracks but no camera
+    auto resectedCameras = cp->cameras();
+    std::vector<kv::frame_id_t> missing;
+    for (auto const f : tp->all_frame_ids())
+    {
+      auto const c = resectedCameras.find(f);
+      if (c == resectedCameras.end() || !c->second)
+      {
+        missing.push_back(f);
+      }
+    }
+
+    auto const minInliers =
+      d->resectionConfig->get_value<size_t>("min_inliers", 10);
+    auto const resected = kwiver::maptk::resect_cameras(
+      d->resectionConfig, missing, resectedCameras, lp->landmarks(), *tp,
+      minInliers);
+    if (!resected.empty())
+    {
+      for (auto const& c : resected)
+      {
+        resectedCameras[c.first] = c.second;
+      }
+      cp = std::make_shared<kv::simple_camera_map>(resectedCameras);
+    }
+  }
+
+  if (d->incremental)
+  {
+    d->saveSolution(cp->cameras(), lp->landmarks(), *tp);
+  }
 
   this->updateCameras(cp);
   this->updateLandmarks(lp);
@@ -142,11 +500,9 @@ void BundleAdjustTool::run()
 bool BundleAdjustTool::callback_handler(camera_map_sptr cameras,
                                         landmark_map_sptr landmarks)
 {
-  // make a copy of the tool data
-  auto data = std::make_shared<ToolData>();
-  data->copyCameras(cameras);
-  data->copyLandmarks(landmarks);
-
-  emit updated(data);
+  // Publish the current parameters rather than copying the cameras and
+  // landmarks; when optimizing locally, only the local cameras and landmarks
+  // are published, and the others are left as they are
+  emit updated(this->publishSolution(cameras, landmarks));
   return !this->isCanceled();
 }
@@ -32,17 +32,23 @@
 #include "ComputeAllDepthTool.h"
 #include "GuiCommon.h"
 
+#include <maptk/point_cloud_writer.h>
+
 #include <arrows/core/depth_utils.h>
 #include <vital/algo/compute_depth.h>
 #include <vital/algo/image_io.h>
 #include <vital/algo/video_input.h>
 #include <vital/config/config_block_io.h>
+#include <vital/exceptions/base.h>
+#include <vital/types/camera_perspective.h>
 #include <vital/types/metadata.h>
 
 #include <QMessageBox>
 #include <qtStlUtil.h>
 
 #include <algorithm>
+#include <cmath>
+#include <memory>
 
 #include <vtkDoubleArray.h>
 #include <vtkImageData.h>
@@ -63,6 +69,58 @@ namespace
 {
 static char const* const BLOCK_VR = "video_reader";
 static char const* const BLOCK_CD = "compute_depth";
+
+//-----------------------------------------------------------------------------
+// Back-project the valid pixels of a depth map and append them as one chunk
+void writeDepthPoints(kwiver::maptk::point_cloud_writer& writer,
+                      kwiver::vital::image_container_sptr const& depth,
+                      kwiver::vital::image_container_sptr const& color,
+                      kwiver::vital::camera_perspective const& camera,
+                      kwiver::vital::bounding_box<int> const& crop)
+{
+  auto const& depthImage = depth->get_image();
+  auto const& colorImage = color->get_image();
+  auto const ni = depthImage.width();
+  auto const nj = depthImage.height();
+  auto const colorPlanes = colorImage.depth();
+
+  auto const K = camera.intrinsics();
+  auto const Rt = camera.rotation().inverse();
+  auto const center = camera.center();
+
+  std::vector<double> points;
+  std::vector<unsigned char> colors;
+  points.reserve(3 * ni * nj);
+  colors.reserve(3 * ni * nj);
+  for (size_t j = 0; j < nj; ++j)
+  {
+    for (size_t i = 0; i < ni; ++i)
+    {
+      auto const d = depthImage.at<double>(i, j);
+      if (!(d > 0.0) || !std::isfinite(d))
+      {
+        continue;
+      }
+
+      auto const u = static_cast<size_t>(crop.min_x()) + i;
+      auto const v = static_cast<size_t>(crop.min_y()) + j;
+      kwiver::vital::vector_2d const pixel(u + 0.5, v + 0.5);
+      kwiver::vital::vector_3d const ray =
+        Rt * K->unmap(pixel).homogeneous();
+      kwiver::vital::vector_3d const pt = center + d * ray;
+      points.insert(points.end(), pt.data(), pt.data() + 3);
+
+      for (size_t c = 0; c < 3; ++c)
+      {
+        colors.push_back(
+          colorImage.at<unsigned char>(u, v, colorPlanes < 3 ? 0 : c));
+      }
+    }
+  }
+
+  writer.write(points.data(), points.size() / 3, colors.data());
+}
+
 }
 
 //-----------------------------------------------------------------------------
@@ -73,6 +131,7 @@ public:
   video_input_sptr video_reader;
   compute_depth_sptr depth_algo;
   int start_frame, end_frame, num_depth, num_support;
+  std::string point_cloud_file;
 };
 
 QTE_IMPLEMENT_D_FUNC(ComputeAllDepthTool)
@@ -151,6 +210,8 @@ bool ComputeAllDepthTool::execute(QWidget* window)
   d->num_depth = config->get_value<int>("batch_depth:num_depth", -1);
 
   d->num_support = config->get_value<int>("compute_depth:num_support", 10);
+  d->point_cloud_file =
+    config->get_value<std::string>("batch_depth:point_cloud_file", "");
 
 
   return AbstractTool::execute(window);
@@ -192,6 +253,45 @@ void ComputeAllDepthTool::run()
     landmarks_out.push_back(l.second);
   }
 
+  // Optionally stream the points of every depth map into one point cloud
+  std::unique_ptr<kwiver::maptk::point_cloud_writer> cloud_writer;
+  if (!d->point_cloud_file.empty())
+  {
+    auto const sfm = this->sfmConstraints();
+    auto const lgcs =
+      sfm ? sfm->get_local_geo_cs() : kwiver::vital::local_geo_cs{};
+    try
+    {
+      cloud_writer.reset(new kwiver::maptk::point_cloud_writer{
+        d->point_cloud_file, lgcs, true});
+    }
+    catch (kwiver::vital::vital_exception const& e)
+    {
+      LOG_ERROR(this->data()->logger,
+                "Not writing depth point cloud: " << e.what());
+    }
+  }
+  auto closeCloud = [&]()
+  {
+    if (!cloud_writer)
+    {
+      return;
+    }
+    try
+    {
+      cloud_writer->close();
+      LOG_INFO(this->data()->logger,
+               "Wrote " << cloud_writer->size() << " depth points to "
+                        << d->point_cloud_file);
+    }
+    catch (kwiver::vital::vital_exception const& e)
+    {
+      LOG_ERROR(this->data()->logger,
+                "Failed to write depth point cloud: " << e.what());
+    }
+    cloud_writer.reset();
+  };
+
   this->setDescription("Estimating Depth");
   this->updateProgress(0, 100);
   auto data = std::make_shared<ToolData>();
@@ -285,13 +385,33 @@ void ComputeAllDepthTool::run()
     auto image_data = depth_to_vtk(depth, frames_out[ref_frame], crop.min_x(), crop.width(),
                                    crop.min_y(), crop.height());
 
+    if (cloud_writer)
+    {
+      try
+      {
+        writeDepthPoints(*cloud_writer, depth, ref_img,
+                         *cameras_out[ref_frame], crop);
+      }
+      catch (kwiver::vital::vital_exception const& e)
+      {
+        LOG_ERROR(this->data()->logger,
+                  "Failed to write depth points: " << e.what());
+        cloud_writer.reset();
+      }
+    }
+
     auto data = std::make_shared<ToolData>();
     data->copyDepth(image_data);
     data->activeFrame = *fitr;
     emit updated(data);
     if (this->isCanceled())
+    {
+      closeCloud();
       return;
+    }
     //this->updateDepth(image_data);
   }
+
+  closeCloud();
 }
 
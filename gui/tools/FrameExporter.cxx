@@ -0,0 +1,192 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FrameExporter.h"
+
+#include <vital/types/image.h>
+#include <vital/util/thread_pool.h>
+
+#include <algorithm>
+
+using kwiver::vital::algo::image_io;
+using kwiver::vital::algo::image_io_sptr;
+
+namespace
+{
+static char const* const BLOCK_IW = "image_writer";
+static char const* const FORMAT_TAG = "output_format";
+static char const* const BIT_DEPTH_TAG = "output_bit_depth";
+static char const* const ENCODERS_TAG = "output_encoders";
+
+//-----------------------------------------------------------------------------
+size_t encoderCount(kwiver::vital::config_block_sptr const& config)
+{
+  auto const count = config->get_value<int>(ENCODERS_TAG, 0);
+  if (count > 0)
+  {
+    return static_cast<size_t>(count);
+  }
+  return std::max<size_t>(
+    kwiver::vital::thread_pool::instance().num_threads(), 1);
+}
+
+//-----------------------------------------------------------------------------
+template <typename In, typename Out, typename Convert>
+kwiver::vital::image_container_sptr convertImage(
+  kwiver::vital::image const& image, Convert convert)
+{
+  kwiver::vital::image_of<In> const in{image};
+  kwiver::vital::image_of<Out> out{in.width(), in.height(), in.depth()};
+  for (size_t k = 0; k < in.depth(); ++k)
+  {
+    for (size_t j = 0; j < in.height(); ++j)
+    {
+      for (size_t i = 0; i < in.width(); ++i)
+      {
+        out(i, j, k) = convert(in(i, j, k));
+      }
+    }
+  }
+  return std::make_shared<kwiver::vital::simple_image_container>(out);
+}
+
+//-----------------------------------------------------------------------------
+kwiver::vital::image_container_sptr convertBitDepth(
+  kwiver::vital::image_container_sptr const& image, int bitDepth)
+{
+  auto const& in = image->get_image();
+  auto const& traits = in.pixel_traits();
+  if (bitDepth == 16 &&
+      traits == kwiver::vital::image_pixel_traits_of<uint8_t>())
+  {
+    return convertImage<uint8_t, uint16_t>(
+      in, [](uint8_t v){ return static_cast<uint16_t>(v * 257); });
+  }
+  if (bitDepth == 8 &&
+      traits == kwiver::vital::image_pixel_traits_of<uint16_t>())
+  {
+    return convertImage<uint16_t, uint8_t>(
+      in, [](uint16_t v){ return static_cast<uint8_t>((v + 128) / 257); });
+  }
+  return image;
+}
+
+}
+
+//-----------------------------------------------------------------------------
+FrameExporter::FrameExporter(kwiver::vital::config_block_sptr const& config,
+                             kwiver::vital::logger_handle_t const& logger)
+  : Logger{logger},
+    Extension{"." + config->get_value<std::string>(FORMAT_TAG, "png")},
+    BitDepth{config->get_value<int>(BIT_DEPTH_TAG, 8)},
+    Queue{encoderCount(config)}
+{
+  // Create the writers here, as algorithm creation may not be thread safe;
+  // there is one for each frame which may be queued at once
+  auto const count = encoderCount(config);
+  for (size_t i = 0; i < count; ++i)
+  {
+    image_io_sptr writer;
+    image_io::set_nested_algo_configuration(BLOCK_IW, config, writer);
+    this->IdleWriters.push_back(writer);
+  }
+}
+
+//-----------------------------------------------------------------------------
+FrameExporter::~FrameExporter()
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FrameExporter::checkConfiguration(
+  kwiver::vital::config_block_sptr const& config)
+{
+  auto const bitDepth = config->get_value<int>(BIT_DEPTH_TAG, 8);
+  return (bitDepth == 8 || bitDepth == 16) &&
+         !config->get_value<std::string>(FORMAT_TAG, "png").empty() &&
+         image_io::check_nested_algo_configuration(BLOCK_IW, config);
+}
+
+//-----------------------------------------------------------------------------
+void FrameExporter::write(std::string const& path,
+                          kwiver::vital::image_container_sptr const& image)
+{
+  if (!image)
+  {
+    LOG_WARN(this->Logger, "No image to write to " << path);
+    return;
+  }
+
+  this->Queue.push([this, path, image]{
+    // Writers are not shared between threads but are reused by later frames
+    auto const writer = this->acquireWriter();
+    try
+    {
+      writer->save(path, convertBitDepth(image, this->BitDepth));
+    }
+    catch (std::exception const& e)
+    {
+      LOG_WARN(this->Logger, "Error writing frame to "
+                             << path << ": " << e.what());
+    }
+    this->releaseWriter(writer);
+  });
+  this->Queue.poll();
+}
+
+//-----------------------------------------------------------------------------
+size_t FrameExporter::finished()
+{
+  this->Queue.poll();
+  return this->Queue.completed();
+}
+
+//-----------------------------------------------------------------------------
+void FrameExporter::wait()
+{
+  this->Queue.wait();
+}
+
+//-----------------------------------------------------------------------------
+image_io_sptr FrameExporter::acquireWriter()
+{
+  // The queue never runs more frames than there are writers
+  std::lock_guard<std::mutex> lock{this->WritersMutex};
+  auto const writer = this->IdleWriters.back();
+  this->IdleWriters.pop_back();
+  return writer;
+}
+
+//-----------------------------------------------------------------------------
+void FrameExporter::releaseWriter(image_io_sptr const& writer)
+{
+  std::lock_guard<std::mutex> lock{this->WritersMutex};
+  this->IdleWriters.push_back(writer);
+}
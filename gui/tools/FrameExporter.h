@@ -0,0 +1,98 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TELESCULPTOR_FRAMEEXPORTER_H_
+#define TELESCULPTOR_FRAMEEXPORTER_H_
+
+// maptk includes
+#include <maptk/bounded_task_queue.h>
+
+// KWIVER includes
+#include <vital/algo/image_io.h>
+#include <vital/config/config_block_types.h>
+#include <vital/logger/logger.h>
+#include <vital/types/image_container.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Writes frame images asynchronously with a pool of image writers
+//
+// The caller, typically a tool reading a video, queues each frame with
+// write() and continues decoding the next one while the thread pool encodes
+// the queued frames, each with its own instance of the nested "image_writer"
+// algorithm.  The number of frames queued at once is bounded, so write()
+// waits when the encoders fall behind.  Frames finish in the order they were
+// queued, which makes finished() suitable for progress reporting.
+class FrameExporter
+{
+public:
+  FrameExporter(kwiver::vital::config_block_sptr const& config,
+                kwiver::vital::logger_handle_t const& logger);
+  ~FrameExporter();
+
+  FrameExporter(FrameExporter const&) = delete;
+  FrameExporter& operator=(FrameExporter const&) = delete;
+
+  // Check the image writer configuration and the export options
+  static bool checkConfiguration(
+    kwiver::vital::config_block_sptr const& config);
+
+  // Get the file extension, including the leading '.', of exported frames
+  std::string const& extension() const { return this->Extension; }
+
+  // Queue a frame image to be written to the given path
+  void write(std::string const& path,
+             kwiver::vital::image_container_sptr const& image);
+
+  // Get the number of frames finished, in the order they were queued
+  size_t finished();
+
+  // Wait for every queued frame to be written
+  void wait();
+
+protected:
+  kwiver::vital::algo::image_io_sptr acquireWriter();
+  void releaseWriter(kwiver::vital::algo::image_io_sptr const& writer);
+
+  kwiver::vital::logger_handle_t Logger;
+  std::string Extension;
+  int BitDepth;
+
+  std::mutex WritersMutex;
+  std::vector<kwiver::vital::algo::image_io_sptr> IdleWriters;
+
+  // Declared last so that it is destroyed, waiting for the queued frames,
+  // before the writers they use
+  kwiver::maptk::bounded_task_queue Queue;
+};
+
+#endif
@@ -189,10 +189,8 @@ bool InitCamerasLandmarksTool::callback_handler(camera_map_sptr cameras,
 {
   this->updateProgress(0);
   this->setDescription("Keyframe-centric structure from motion");
-  // make a copy of the tool data
-  auto data = std::make_shared<ToolData>();
-  data->copyCameras(cameras);
-  data->copyLandmarks(landmarks);
+  // Publish the current cameras and landmarks rather than copying them
+  auto data = this->publishSolution(cameras, landmarks);
   data->copyTrackChanges(track_changes);
   data->description = description().toStdString();
   data->progress = progress();
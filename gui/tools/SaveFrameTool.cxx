@@ -29,11 +29,11 @@
  */
 
 #include "SaveFrameTool.h"
+#include "FrameExporter.h"
 #include "GuiCommon.h"
 
 #include <iomanip>
 
-#include <vital/algo/image_io.h>
 #include <vital/algo/video_input.h>
 #include <kwiversys/SystemTools.hxx>
 
@@ -43,13 +43,10 @@
 
 using kwiver::vital::algo::video_input;
 using kwiver::vital::algo::video_input_sptr;
-using kwiver::vital::algo::image_io;
-using kwiver::vital::algo::image_io_sptr;
 
 namespace
 {
 static char const* const BLOCK_VR = "video_reader";
-static char const* const BLOCK_IW = "image_writer";
 static char const* const FRAMES_TAG = "output_frames_dir";
 static char const* const FRAMES_PATH = "results/frames";
 }
@@ -61,7 +58,7 @@ class SaveFrameToolPrivate
 {
 public:
   video_input_sptr video_reader;
-  image_io_sptr image_writer;
+  kwiver::vital::config_block_sptr writer_config;
 };
 
 //-----------------------------------------------------------------------------
@@ -122,18 +119,17 @@ bool SaveFrameTool::execute(QWidget* window)
   }
 
   config->merge_config(this->data()->config);
-  if (!image_io::check_nested_algo_configuration(BLOCK_IW, config))
+  if (!FrameExporter::checkConfiguration(config))
   {
     QMessageBox::critical(
       window, "Configuration error",
-      "An error was found in the image writer algorithm configuration.");
+      "An error was found in the image writer configuration.");
     return false;
   }
 
   video_input::set_nested_algo_configuration(
     BLOCK_VR, this->data()->config, d->video_reader);
-  image_io::set_nested_algo_configuration(
-    BLOCK_IW, config, d->image_writer);
+  d->writer_config = config;
 
   return AbstractTool::execute(window);
 }
@@ -159,21 +155,22 @@ void SaveFrameTool::run()
     kwiversys::SystemTools::MakeDirectory(framesDir);
   }
 
+  // Decode frames here while the exporter encodes them in the thread pool
+  FrameExporter exporter{d->writer_config, this->data()->logger};
   kwiver::vital::timestamp currentTimestamp;
   d->video_reader->open(this->data()->videoPath);
+  auto const numFrames = static_cast<int>(d->video_reader->num_frames());
   while (d->video_reader->next_frame(currentTimestamp))
   {
     auto frame = currentTimestamp.get_frame();
     auto md = d->video_reader->frame_metadata();
-    auto filename = framesDir + "/" + frameName(frame, md) + ".png";
-    try
-    {
-      d->image_writer->save(filename, d->video_reader->frame_image());
-    }
-    catch (std::exception const& e)
+    auto filename =
+      framesDir + "/" + frameName(frame, md) + exporter.extension();
+    exporter.write(filename, d->video_reader->frame_image());
+
+    if (numFrames > 0)
     {
-      LOG_WARN(this->data()->logger, "Error writing frame to "
-                                     << filename << ": " <<  e.what());
+      this->updateProgress(static_cast<int>(exporter.finished()), numFrames);
     }
 
     if( this->isCanceled() )
@@ -181,6 +178,7 @@ void SaveFrameTool::run()
       break;
     }
   }
+  exporter.wait();
 
   if (!this->data()->config->has_value(FRAMES_TAG))
   {
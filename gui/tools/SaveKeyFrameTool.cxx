@@ -29,11 +29,11 @@
  */
 
 #include "SaveKeyFrameTool.h"
+#include "FrameExporter.h"
 #include "GuiCommon.h"
 
 #include <iomanip>
 
-#include <vital/algo/image_io.h>
 #include <vital/algo/video_input.h>
 #include <kwiversys/SystemTools.hxx>
 
@@ -43,13 +43,10 @@
 
 using kwiver::vital::algo::video_input;
 using kwiver::vital::algo::video_input_sptr;
-using kwiver::vital::algo::image_io;
-using kwiver::vital::algo::image_io_sptr;
 
 namespace
 {
 static char const* const BLOCK_VR = "video_reader";
-static char const* const BLOCK_IW = "image_writer";
 static char const* const KEYFRAMES_TAG = "output_frames_dir";
 static char const* const KEYFRAMES_PATH = "results/frames";
 }
@@ -61,7 +58,7 @@ class SaveKeyFrameToolPrivate
 {
 public:
   video_input_sptr video_reader;
-  image_io_sptr image_writer;
+  kwiver::vital::config_block_sptr writer_config;
 };
 
 //-----------------------------------------------------------------------------
@@ -122,18 +119,17 @@ bool SaveKeyFrameTool::execute(QWidget* window)
   }
 
   config->merge_config(this->data()->config);
-  if (!image_io::check_nested_algo_configuration(BLOCK_IW, config))
+  if (!FrameExporter::checkConfiguration(config))
   {
     QMessageBox::critical(
       window, "Configuration error",
-      "An error was found in the image writer algorithm configuration.");
+      "An error was found in the image writer configuration.");
     return false;
   }
 
   video_input::set_nested_algo_configuration(
     BLOCK_VR, this->data()->config, d->video_reader);
-  image_io::set_nested_algo_configuration(
-    BLOCK_IW, config, d->image_writer);
+  d->writer_config = config;
 
   return AbstractTool::execute(window);
 }
@@ -159,36 +155,39 @@ void SaveKeyFrameTool::run()
     kwiversys::SystemTools::MakeDirectory(keyframesDir);
   }
 
+  // Decode frames here while the exporter encodes them in the thread pool
+  FrameExporter exporter{d->writer_config, this->data()->logger};
   kwiver::vital::timestamp currentTimestamp;
   d->video_reader->open(this->data()->videoPath);
 
-  for (auto const& frame: this->tracks()->keyframes())
+  auto const keyframes = this->tracks()->keyframes();
+  auto const numKeyframes = static_cast<int>(keyframes.size());
+  auto skipped = 0;
+  for (auto const& frame: keyframes)
   {
     if (d->video_reader->seek_frame(currentTimestamp, frame))
     {
       auto md = d->video_reader->frame_metadata();
-      auto filename = keyframesDir + "/" + frameName(frame, md) + ".png";
-      try
-      {
-        d->image_writer->save(filename, d->video_reader->frame_image());
-      }
-      catch (std::exception const& e)
-      {
-        LOG_WARN(this->data()->logger, "Error writing frame to "
-                                       << filename << ": " <<  e.what());
-      }
+      auto filename =
+        keyframesDir + "/" + frameName(frame, md) + exporter.extension();
+      exporter.write(filename, d->video_reader->frame_image());
     }
     else
     {
       LOG_WARN(this->data()->logger, "Key frame " << frame
                                      << " not available in video source.");
+      ++skipped;
     }
 
+    this->updateProgress(static_cast<int>(exporter.finished()) + skipped,
+                         numKeyframes);
+
     if( this->isCanceled() )
     {
       break;
     }
   }
+  exporter.wait();
 
   if (!this->data()->config->has_value(KEYFRAMES_TAG))
   {
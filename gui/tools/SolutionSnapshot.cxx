@@ -0,0 +1,99 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SolutionSnapshot.h"
+
+#include <vital/types/camera_perspective.h>
+
+//-----------------------------------------------------------------------------
+bool SolutionSnapshot::publish(kwiver::vital::camera_map const& cameras,
+                               kwiver::vital::landmark_map const& landmarks)
+{
+  // The back buffer is never read, since only this thread changes which
+  // buffer is in front; fill it without locking, reusing its allocations
+  auto& buffer = this->buffers[1 - this->front];
+
+  buffer.frames.clear();
+  buffer.cameraCenters.clear();
+  buffer.cameraRotations.clear();
+  buffer.cameraIntrinsics.clear();
+  for (auto const& c : cameras.cameras())
+  {
+    auto const* const camera =
+      dynamic_cast<kwiver::vital::camera_perspective const*>(c.second.get());
+    if (!camera)
+    {
+      continue;
+    }
+
+    auto const center = kwiver::vital::vector_3d{camera->center()};
+    auto const rotation =
+      kwiver::vital::vector_4d{camera->rotation().quaternion().coeffs()};
+    auto const intrinsics = camera->intrinsics();
+    auto const pp = kwiver::vital::vector_2d{intrinsics->principal_point()};
+
+    buffer.frames.push_back(c.first);
+    buffer.cameraCenters.insert(buffer.cameraCenters.end(),
+                                center.data(), center.data() + 3);
+    buffer.cameraRotations.insert(buffer.cameraRotations.end(),
+                                  rotation.data(), rotation.data() + 4);
+    buffer.cameraIntrinsics.push_back(intrinsics->focal_length());
+    buffer.cameraIntrinsics.push_back(pp[0]);
+    buffer.cameraIntrinsics.push_back(pp[1]);
+    buffer.cameraIntrinsics.push_back(intrinsics->aspect_ratio());
+    buffer.cameraIntrinsics.push_back(intrinsics->skew());
+  }
+
+  buffer.landmarks.clear();
+  buffer.landmarkPositions.clear();
+  for (auto const& l : landmarks.landmarks())
+  {
+    if (!l.second)
+    {
+      continue;
+    }
+
+    auto const& loc = l.second->loc();
+    buffer.landmarks.push_back(l.first);
+    buffer.landmarkPositions.insert(buffer.landmarkPositions.end(),
+                                    loc.data(), loc.data() + 3);
+  }
+
+  // Swap the buffers, unless the reader is busy with the front buffer
+  std::unique_lock<std::mutex> lock{this->mutex, std::try_to_lock};
+  if (!lock.owns_lock())
+  {
+    return false;
+  }
+
+  buffer.version = ++this->version;
+  this->front = 1 - this->front;
+  return true;
+}
@@ -0,0 +1,110 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TELESCULPTOR_SOLUTIONSNAPSHOT_H_
+#define TELESCULPTOR_SOLUTIONSNAPSHOT_H_
+
+#include <vital/types/camera_map.h>
+#include <vital/types/landmark_map.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/// A double-buffered, versioned snapshot of camera and landmark parameters
+///
+/// This class allows a tool to publish intermediate solutions without cloning
+/// every camera and landmark. The tool thread writes the parameters into
+/// flat, reused buffers and publishes them; the GUI thread reads the most
+/// recently published buffer in place. Publishing never blocks the tool; if
+/// the GUI is reading at that moment, the solution is dropped and a later one
+/// will be published instead.
+class SolutionSnapshot
+{
+public:
+  struct Buffer
+  {
+    std::uint64_t version = 0;
+
+    std::vector<kwiver::vital::frame_id_t> frames;
+    /// Camera centers, three values per camera
+    std::vector<double> cameraCenters;
+    /// Camera rotation quaternions (x, y, z, w), four values per camera
+    std::vector<double> cameraRotations;
+    /// Camera focal length, principal point, aspect ratio and skew, five
+    /// values per camera
+    std::vector<double> cameraIntrinsics;
+
+    std::vector<kwiver::vital::landmark_id_t> landmarks;
+    /// Landmark positions, three values per landmark
+    std::vector<double> landmarkPositions;
+  };
+
+  /// Write and publish a solution.
+  ///
+  /// This must only be called from one thread (the tool thread). Cameras
+  /// which are not perspective cameras, and null landmarks, are skipped.
+  ///
+  /// \return \c true if the solution was published, or \c false if it was
+  ///         dropped because the previous solution was being read
+  bool publish(kwiver::vital::camera_map const& cameras,
+               kwiver::vital::landmark_map const& landmarks);
+
+  /// Read the most recently published solution, if it is newer.
+  ///
+  /// If a solution with a version newer than \p lastVersion has been
+  /// published, \p func is called with its buffer and \p lastVersion is
+  /// updated. The buffer must not be used after \p func returns.
+  ///
+  /// \return \c true if \p func was called
+  template <typename Func>
+  bool read(std::uint64_t& lastVersion, Func func)
+  {
+    std::lock_guard<std::mutex> lock{this->mutex};
+
+    auto const& buffer = this->buffers[this->front];
+    if (buffer.version <= lastVersion)
+    {
+      return false;
+    }
+
+    func(buffer);
+    lastVersion = buffer.version;
+    return true;
+  }
+
+protected:
+  Buffer buffers[2];
+  int front = 0;
+  std::uint64_t version = 0;
+  std::mutex mutex;
+};
+
+#endif
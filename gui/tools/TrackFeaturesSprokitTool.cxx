@@ -31,7 +31,10 @@
 #include "TrackFeaturesSprokitTool.h"
 #include "GuiCommon.h"
 
+#include <chrono>
 #include <fstream>
+#include <iterator>
+#include <map>
 #include <sstream>
 
 #include <vital/algo/convert_image.h>
@@ -58,6 +61,52 @@ namespace
 {
   static char const* const BLOCK_CI = "image_converter";
   static char const* const BLOCK_VR = "video_reader";
+  static char const* const BLOCK_EP = "embedded_pipeline";
+
+  using steady_clock = std::chrono::steady_clock;
+
+  /// Edge capacities keyed by downstream process and port ("process:port")
+  using edge_capacity_map = std::map<std::string, unsigned>;
+
+  /// Write the capacity of each edge in \p capacities as pipeline config
+  void write_edge_capacities(std::ostream& ss,
+                             edge_capacity_map const& capacities)
+  {
+    if (capacities.empty())
+    {
+      return;
+    }
+
+    ss << SPROKIT_CONFIG_BLOCK("_pipeline:_edge_by_conn");
+    for (auto const& c : capacities)
+    {
+      auto const split = c.first.rfind(':');
+      ss << SPROKIT_CONFIG(c.first.substr(0, split) + ":down" +
+                           c.first.substr(split) + ":capacity",
+                           std::to_string(c.second));
+    }
+  }
+
+  /// Running average time spent per frame in one stage of the tool
+  class stage_timer
+  {
+  public:
+    void add(steady_clock::duration d)
+    {
+      ++count;
+      total += d;
+    }
+
+    double mean_ms() const
+    {
+      using ms = std::chrono::duration<double, std::milli>;
+      return count ? ms(total).count() / static_cast<double>(count) : 0.0;
+    }
+
+  private:
+    size_t count = 0;
+    steady_clock::duration total = steady_clock::duration::zero();
+  };
 }  // end anonymous namespace
 
 
@@ -70,6 +119,22 @@ public:
   convert_image_sptr image_converter;
   video_input_sptr video_reader;
   kwiver::embedded_pipeline ep;
+
+  // Queue capacities of the pipeline edges
+  unsigned edge_capacity = 2;
+  unsigned keyframe_edge_capacity = 16;
+  edge_capacity_map edge_capacities;
+
+  // Time spent per frame in each stage, and the pipeline latency
+  stage_timer decode_time;
+  stage_timer convert_time;
+  stage_timer send_time;
+  stage_timer latency;
+  steady_clock::time_point start_time;
+  size_t frames_received = 0;
+  std::map<kwiver::vital::frame_id_t, steady_clock::time_point> send_times;
+
+  QString statistics() const;
 };
 
 TrackFeaturesSprokitToolPrivate
@@ -77,6 +142,23 @@ TrackFeaturesSprokitToolPrivate
 {
 }
 
+//-----------------------------------------------------------------------------
+QString TrackFeaturesSprokitToolPrivate::statistics() const
+{
+  using seconds = std::chrono::duration<double>;
+  auto const elapsed = seconds(steady_clock::now() - this->start_time).count();
+  auto const rate = elapsed > 0.0 ? this->frames_received / elapsed : 0.0;
+
+  return QString("Tracking features at %1 frames/s "
+                 "(ms per frame: decode %2, convert %3, blocked %4; "
+                 "pipeline latency %5 ms)")
+    .arg(rate, 0, 'f', 1)
+    .arg(this->decode_time.mean_ms(), 0, 'f', 1)
+    .arg(this->convert_time.mean_ms(), 0, 'f', 1)
+    .arg(this->send_time.mean_ms(), 0, 'f', 1)
+    .arg(this->latency.mean_ms(), 0, 'f', 0);
+}
+
 QTE_IMPLEMENT_D_FUNC(TrackFeaturesSprokitTool)
 
 //-----------------------------------------------------------------------------
@@ -139,6 +221,27 @@ bool TrackFeaturesSprokitTool::execute(QWidget* window)
   convert_image::set_nested_algo_configuration(BLOCK_CI, config, d->image_converter);
   video_input::set_nested_algo_configuration(BLOCK_VR, config, d->video_reader);
 
+  // Get the queue capacities of the pipeline edges
+  auto const ep_config = config->subblock_view(BLOCK_EP);
+  d->edge_capacity = ep_config->get_value<unsigned>(
+    "edge_capacity", d->edge_capacity);
+  d->keyframe_edge_capacity = ep_config->get_value<unsigned>(
+    "keyframe_edge_capacity", d->keyframe_edge_capacity);
+  d->edge_capacities.clear();
+  auto const edge_config = ep_config->subblock_view("edge");
+  for (auto const& key : edge_config->available_values())
+  {
+    if (key.find(':') == std::string::npos)
+    {
+      QMessageBox::critical(
+        window, "Configuration error",
+        QString("Pipeline edge \"%1\" must be given as process:port.")
+          .arg(qtString(key)));
+      return false;
+    }
+    d->edge_capacities[key] = edge_config->get_value<unsigned>(key);
+  }
+
   std::stringstream pipe_str(create_pipeline_config(window));
   if (pipe_str.str().empty())
   {
@@ -161,10 +264,13 @@ bool TrackFeaturesSprokitTool::execute(QWidget* window)
   return AbstractTool::execute(window);
 }
 
+//-----------------------------------------------------------------------------
 std::string
 TrackFeaturesSprokitTool
 ::create_pipeline_config(QWidget* window)
 {
+  QTE_D();
+
   std::stringstream ss;
 
   std::string pipe_file = findConfig("track_features_embedded.pipe");
@@ -182,7 +288,8 @@ TrackFeaturesSprokitTool
         QString::fromStdString("Unable to open file: " + pipe_file));
       return "";
     }
-    ss << pipe_str.rdbuf();
+    ss << pipe_str.rdbuf() << "\n";
+    write_edge_capacities(ss, d->edge_capacities);
     return ss.str();
   }
   else
@@ -233,14 +340,17 @@ TrackFeaturesSprokitTool
 
       << SPROKIT_PROCESS("output_adapter", "output")
       << SPROKIT_CONFIG_BLOCK("_pipeline:_edge")
-      << SPROKIT_CONFIG("capacity", "2")
+      << SPROKIT_CONFIG("capacity", std::to_string(d->edge_capacity))
 
+      // Tracking branch; runs on every frame
       << SPROKIT_CONNECT("input", "image", "tracker", "image")
       << SPROKIT_CONNECT("input", "timestamp", "tracker", "timestamp")
       << SPROKIT_CONNECT("tracker", "feature_track_set", "tracker", "feature_track_set")
       << SPROKIT_CONNECT("tracker", "feature_track_set", "keyframes", "next_tracks")
       << SPROKIT_CONNECT("input", "timestamp", "keyframes", "timestamp")
       << SPROKIT_CONNECT("keyframes", "feature_track_set", "keyframes", "loop_back_tracks")
+
+      // Keyframe branch; extracts descriptors on keyframes and closes loops
       << SPROKIT_CONNECT("keyframes", "feature_track_set", "detect_if_keyframe", "next_tracks")
       << SPROKIT_CONNECT("detect_if_keyframe", "feature_track_set", "detect_if_keyframe", "loop_back_tracks")
       << SPROKIT_CONNECT("input", "image", "detect_if_keyframe", "image")
@@ -248,7 +358,28 @@ TrackFeaturesSprokitTool
       << SPROKIT_CONNECT("detect_if_keyframe", "feature_track_set", "loop_detector", "next_tracks")
       << SPROKIT_CONNECT("loop_detector", "feature_track_set", "loop_detector", "loop_back_tracks")
       << SPROKIT_CONNECT("input", "timestamp", "loop_detector", "timestamp")
-      << SPROKIT_CONNECT("loop_detector", "feature_track_set", "output", "feature_track_set");
+      << SPROKIT_CONNECT("loop_detector", "feature_track_set", "output", "feature_track_set")
+      << SPROKIT_CONNECT("input", "timestamp", "output", "timestamp");
+
+    // The keyframe branch does much more work on keyframes than tracking
+    // does on any frame, so give its inputs longer queues; tracking then
+    // runs ahead of loop closure until they fill, rather than stalling at
+    // each keyframe
+    edge_capacity_map capacities;
+    for (auto const& edge : { "detect_if_keyframe:next_tracks",
+                              "detect_if_keyframe:image",
+                              "detect_if_keyframe:timestamp",
+                              "loop_detector:next_tracks",
+                              "loop_detector:timestamp",
+                              "output:timestamp" })
+    {
+      capacities[edge] = d->keyframe_edge_capacity;
+    }
+    for (auto const& c : d->edge_capacities)
+    {
+      capacities[c.first] = c.second;
+    }
+    write_edge_capacities(ss, capacities);
   }
 
   return ss.str();
@@ -268,6 +399,67 @@ TrackFeaturesSprokitTool
 
   kwiver::vital::frame_id_t frame = this->activeFrame();
   kwiver::vital::timestamp currentTimestamp;
+  auto matchMatrix = std::make_shared<kwiver::maptk::match_matrix_accumulator>();
+  kwiver::vital::feature_track_set_sptr out_tracks;
+
+  d->decode_time = d->convert_time = d->send_time = d->latency = {};
+  d->frames_received = 0;
+  d->send_times.clear();
+  d->start_time = steady_clock::now();
+
+  // Take the tracks out of an output data set
+  auto receive = [&](kwiver::adapter::adapter_data_set_t const& rds)
+  {
+    auto ix = rds->find("feature_track_set");
+    if (ix == rds->end())
+    {
+      return false;
+    }
+
+    out_tracks = ix->second->get_datum<kwiver::vital::feature_track_set_sptr>();
+    auto const last_frame = out_tracks->last_frame();
+
+    // Measure the time from sending a frame to receiving its tracks
+    auto const now = steady_clock::now();
+    auto const ts = rds->find("timestamp");
+    auto const out_frame =
+      ts != rds->end()
+        ? ts->second->get_datum<kwiver::vital::timestamp>().get_frame()
+        : last_frame;
+    auto const sent = d->send_times.find(out_frame);
+    if (sent != d->send_times.end())
+    {
+      d->latency.add(now - sent->second);
+      d->send_times.erase(d->send_times.begin(), std::next(sent));
+    }
+    ++d->frames_received;
+
+    matchMatrix->update(*out_tracks, last_frame);
+    return true;
+  };
+
+  // Receive every available output, then publish only the latest tracks
+  auto drain = [&]()
+  {
+    auto received = false;
+    while (!d->ep.empty())
+    {
+      received = receive(d->ep.receive()) || received;
+    }
+    if (!received)
+    {
+      return;
+    }
+
+    // make a copy of the tool data; the match matrix is only passed with the
+    // final result
+    auto data = std::make_shared<ToolData>();
+    data->copyTracks(out_tracks);
+    data->activeFrame = out_tracks->last_frame();
+    data->progress = progress();
+    data->description = stdString(d->statistics());
+    emit updated(data);
+  };
 
   d->video_reader->open(this->data()->videoPath);
 
@@ -280,14 +472,20 @@ TrackFeaturesSprokitTool
   this->updateProgress(static_cast<int>(frame), maxFrame);
   this->setDescription("Parsing video frames");
 
-  while (d->video_reader->next_frame(currentTimestamp))
+  for (auto t0 = steady_clock::now();
+       d->video_reader->next_frame(currentTimestamp); t0 = steady_clock::now())
   {
     auto const image = d->video_reader->frame_image();
+    auto const t1 = steady_clock::now();
     auto const converted_image = d->image_converter->convert(image);
+    auto const t2 = steady_clock::now();
+    d->decode_time.add(t1 - t0);
+    d->convert_time.add(t2 - t1);
 
     // Update tool progress
     this->updateProgress(
       static_cast<int>(currentTimestamp.get_frame()), maxFrame);
+    this->setDescription(d->statistics());
 
     auto const mdv = d->video_reader->frame_metadata();
     if (!mdv.empty())
@@ -295,53 +493,32 @@ TrackFeaturesSprokitTool
       converted_image->set_metadata(mdv[0]);
     }
 
-    // Create dataset for input
+    // Create dataset for input; sending blocks while the pipeline's input
+    // queues are full, so the time spent here measures its back-pressure
     auto ds = kwiver::adapter::adapter_data_set::create();
     ds->add_value("image", converted_image);
     ds->add_value("timestamp", currentTimestamp);
+    auto const t3 = steady_clock::now();
+    d->send_times.emplace(currentTimestamp.get_frame(), t3);
     d->ep.send(ds);
+    d->send_time.add(steady_clock::now() - t3);
 
     if (this->isCanceled())
     {
       d->video_reader->close();
       break;
     }
-    if (!d->ep.empty())
-    {
-      auto rds = d->ep.receive();
-      auto ix = rds->find("feature_track_set");
-      if (ix != rds->end())
-      {
-        auto out_tracks = ix->second->get_datum<kwiver::vital::feature_track_set_sptr>();
-        // make a copy of the tool data
-        auto data = std::make_shared<ToolData>();
-        data->copyTracks(out_tracks);
-        data->activeFrame = out_tracks->last_frame();
-        data->progress = progress();
-        data->description = description().toStdString();
-        emit updated(data);
-      }
-    }
+    drain();
   }
   d->ep.send_end_of_input();
 
-  kwiver::vital::feature_track_set_sptr out_tracks;
   while (!d->ep.at_end())
   {
-    auto rds = d->ep.receive();
-    auto ix = rds->find("feature_track_set");
-    if (ix != rds->end())
-    {
-      out_tracks = ix->second->get_datum<kwiver::vital::feature_track_set_sptr>();
-      // make a copy of the tool data
-      auto data = std::make_shared<ToolData>();
-      data->copyTracks(out_tracks);
-      data->activeFrame = out_tracks->last_frame();
-      emit updated(data);
-    }
+    receive(d->ep.receive());
   }
   d->ep.wait();
 
   this->updateTracks(out_tracks);
+  this->updateMatchMatrix(matchMatrix);
 
 }
@@ -172,15 +172,21 @@ void TrackFeaturesTool::run()
   auto const maxFrame = this->data()->maxFrame;
   auto const hasMask = !this->data()->maskPath.empty();
 
+  // get the frames from the metadata table, or else the metadata from the
+  // tool, if possible, so we do not need to scan the whole video again
+  auto const md_table = this->metadataTable();
   kwiver::vital::metadata_map_sptr md_map;
-  // get metadata from the tool, if possible, so we do not
-  // need to scan the whole video again
-  if (this->sfmConstraints())
+  if (!md_table && this->sfmConstraints())
   {
     md_map = this->sfmConstraints()->get_metadata();
   }
 
   auto tracks = this->tracks();
+  auto matchMatrix = std::make_shared<kwiver::maptk::match_matrix_accumulator>();
+  if (tracks)
+  {
+    matchMatrix->rebuild(*tracks);
+  }
   kwiver::vital::frame_id_t start_frame = this->activeFrame();
   kwiver::vital::timestamp currentTimestamp;
 
@@ -190,13 +196,17 @@ void TrackFeaturesTool::run()
     d->mask_reader->open(this->data()->maskPath);
   }
 
-  if (!md_map)
+  if (!md_table && !md_map)
   {
     md_map = d->video_reader->metadata_map();
   }
 
   std::vector<kwiver::vital::frame_id_t> valid_frames;
-  if (md_map)
+  if (md_table)
+  {
+    valid_frames = md_table->frames();
+  }
+  else if (md_map)
   {
     auto fs = md_map->frames();
     valid_frames = std::vector<kwiver::vital::frame_id_t>(fs.begin(), fs.end());
@@ -276,9 +286,12 @@ void TrackFeaturesTool::run()
     if (tracks)
     {
       tracks = kwiver::maptk::extract_feature_colors(tracks, *image, frame);
+      matchMatrix->update(*tracks, frame);
     }
 
-    // make a copy of the tool data
+    // make a copy of the tool data; the match matrix is only passed with the
+    // final result, since copying it on every frame would cost more than
+    // updating it
     auto data = std::make_shared<ToolData>();
     data->copyTracks(tracks);
     data->activeFrame = frame;
@@ -297,6 +310,7 @@ void TrackFeaturesTool::run()
     d->mask_reader->close();
   }
   this->updateTracks(tracks);
+  this->updateMatchMatrix(matchMatrix);
   this->setActiveFrame(start_frame);
   // mark progress 100% complete
   this->updateProgress(100);
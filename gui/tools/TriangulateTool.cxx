@@ -31,16 +31,18 @@
 #include "TriangulateTool.h"
 #include "GuiCommon.h"
 
+#include <maptk/triangulation.h>
+
 #include <vital/algo/triangulate_landmarks.h>
 
 #include <QMessageBox>
 
 using kwiver::vital::algo::triangulate_landmarks;
-using kwiver::vital::algo::triangulate_landmarks_sptr;
 
 namespace
 {
 static char const* const BLOCK = "triangulator";
+static char const* const BLOCK_FILTER = "triangulation_filter";
 static char const* const CONFIG_FILE = "gui_triangulate.conf";
 }
 
@@ -48,7 +50,11 @@ static char const* const CONFIG_FILE = "gui_triangulate.conf";
 class TriangulateToolPrivate
 {
 public:
-  triangulate_landmarks_sptr algorithm;
+  // Each triangulation task creates its own algorithm from the configuration
+  kwiver::vital::config_block_sptr config;
+
+  double minAngle = 0.0;
+  double maxReprojectionError = 0.0;
 };
 
 QTE_IMPLEMENT_D_FUNC(TriangulateTool)
@@ -112,9 +118,12 @@ bool TriangulateTool::execute(QWidget* window)
     return false;
   }
 
-  // Create algorithm from configuration
-  triangulate_landmarks::set_nested_algo_configuration(
-    BLOCK, config, d->algorithm);
+  d->config = config;
+
+  auto const block = std::string{BLOCK_FILTER};
+  d->minAngle = config->get_value<double>(block + ":min_angle", 0.0);
+  d->maxReprojectionError =
+    config->get_value<double>(block + ":max_reprojection_error", 0.0);
 
   // Hand off to base class
   return AbstractTool::execute(window);
@@ -142,7 +151,8 @@ void TriangulateTool::run()
   kwiver::vital::landmark_map_sptr lp =
     std::make_shared<kwiver::vital::simple_landmark_map>(init_lms);
 
-  d->algorithm->triangulate(cp, tp, lp);
+  kwiver::maptk::triangulate_tracks(d->config, BLOCK, cp, tp, lp, nullptr,
+                                    d->minAngle, d->maxReprojectionError);
 
   LOG_INFO(this->data()->logger, "Triangulated " << lp->size()
            << " out of " << init_lms.size() << " tracks.");
@@ -32,24 +32,26 @@
 
 #include "vtkMaptkCamera.h"
 
-#include <vital/types/vector.h>
+#include <maptk/parallel_for.h>
 
+#include <vital/types/vector.h>
 
 #include <vtkActor.h>
-#include <vtkAppendPolyData.h>
 #include <vtkCellArray.h>
-#include <vtkCollection.h>
-#include <vtkFrustumSource.h>
+#include <vtkFloatArray.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
-#include <vtkPlanes.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
 
+#include <algorithm>
+#include <cmath>
 #include <map>
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 vtkStandardNewMacro(vtkMaptkCameraRepresentation);
 
@@ -58,93 +60,105 @@ using kwiver::vital::vector_3d;
 namespace // anonymous
 {
 
-typedef vtkSmartPointer<vtkPolyData> PolyDataPointer;
+// Each frustum is made of the four far corners, the four near corners and the
+// apex of a triangle above the far face to indicate the up direction (like the
+// roof of a "house"), which is drawn as six quads and one triangle
+constexpr vtkIdType PointsPerCamera = 9;
+constexpr vtkIdType CellsPerCamera = 7;
+constexpr vtkIdType CellIdsPerCamera = (6 * 5) + (1 * 4);
 
 //-----------------------------------------------------------------------------
-void BuildCameraFrustum(
-  vtkCamera* camera, double farClipDistance, vtkPolyData* polyData)
+void ComputeCameraFrustum(
+  vtkCamera* camera, double farClipDistance, float* out)
 {
-  // Build frustum from camera data
-  vtkNew<vtkPlanes> planes;
-  double planeCoeffs[24];
-  if (vtkMaptkCamera::SafeDownCast(camera))
+  // Compute the frustum directly from the camera parameters; this is
+  // equivalent to intersecting the planes of the camera's projection with
+  // clipping range (0.01, farClipDistance), but does not modify the camera,
+  // so distinct cameras may be processed concurrently
+  auto* const maptkCamera = vtkMaptkCamera::SafeDownCast(camera);
+  // use aspect of 1.0 if not a Maptk camera
+  auto const aspect = (maptkCamera ? maptkCamera->GetAspectRatio() : 1.0);
+  auto const t = std::tan(0.5 * camera->GetViewAngle() * vtkMath::Pi() / 180.0);
+
+  vector_3d position, direction, up;
+  camera->GetPosition(position.data());
+  camera->GetDirectionOfProjection(direction.data());
+  camera->GetViewUp(up.data());
+  vector_3d const right = direction.cross(up).normalized();
+  up = right.cross(direction).normalized();
+
+  double const* const wc = camera->GetWindowCenter();
+  double const xs[2] = { (wc[0] - 1.0) * t * aspect, (wc[0] + 1.0) * t * aspect };
+  double const ys[2] = { (wc[1] - 1.0) * t, (wc[1] + 1.0) * t };
+
+  // corners in the order bottom-left, bottom-right, top-right, top-left
+  static int const xi[4] = { 0, 1, 1, 0 };
+  static int const yi[4] = { 0, 0, 1, 1 };
+
+  auto const store = [out](int index, vector_3d const& p){
+    out[3 * index + 0] = static_cast<float>(p[0]);
+    out[3 * index + 1] = static_cast<float>(p[1]);
+    out[3 * index + 2] = static_cast<float>(p[2]);
+  };
+
+  vector_3d corners[4];
+  for (int k = 0; k < 4; ++k)
   {
-    vtkNew<vtkMaptkCamera> tempCamera;
-    tempCamera->DeepCopy(vtkMaptkCamera::SafeDownCast(camera));
-    tempCamera->SetClippingRange(0.01, farClipDistance);
-    tempCamera->GetFrustumPlanes(planeCoeffs);
+    auto const ray =
+      vector_3d{ direction + (xs[xi[k]] * right) + (ys[yi[k]] * up) };
+    corners[k] = position + (farClipDistance * ray);
+    store(k, corners[k]);
+    store(k + 4, position + (0.01 * ray));
   }
-  else
-  {
-    vtkNew<vtkCamera> tempCamera;
-    tempCamera->DeepCopy(camera);
-    tempCamera->SetClippingRange(0.01, farClipDistance);
-    // use aspect of 1.0 if not a Maptk camera
-    tempCamera->GetFrustumPlanes(1.0, planeCoeffs);
-  }
-  planes->SetFrustumPlanes(planeCoeffs);
-
-  vtkNew<vtkFrustumSource> frustum;
-  frustum->SetPlanes(planes.GetPointer());
-  frustum->SetShowLines(false);
-  frustum->Update();
-
-  // Make a copy of the frustum mesh so we can modify it
-  polyData->DeepCopy(frustum->GetOutput());
-  auto const frustumPoints = polyData->GetPoints();
-
-  // Add a polygon to indicate the up direction (the far plane uses points
-  // 0, 1, 2, and 3, with 2 and 3 on the top; we use those with the center of
-  // the far polygon to compute a point "above" the far face to form a triangle
-  // like the roof of a "house")
-  //
-  // TODO vtkFrustumSource indicates that this is actually the near plane, but
-  //      appears to be wrong - need to verify
-  vector_3d points[4];
-  frustumPoints->GetPoint(0, points[0].data());
-  frustumPoints->GetPoint(1, points[1].data());
-  frustumPoints->GetPoint(2, points[2].data());
-  frustumPoints->GetPoint(3, points[3].data());
-
-  // Compute new point:
+
+  // Compute apex point:
   //   center = (p0 + p1 + p2 + p3) / 4.0
   //   top = (p2 + p3) / 2.0
-  //   new = top + (top - center)
-  //       = p2 + p3 - center
-  auto const center = 0.25 * (points[0] + points[1] + points[2] + points[3]);
-  auto const newPoint = vector_3d(points[2] + points[3] - center);
-
-  // Insert new point and new face
-  vtkIdType const newIndex = frustumPoints->InsertNextPoint(newPoint.data());
-  vtkIdType const pts[3] = {2, 3, newIndex};
-  polyData->GetPolys()->InsertNextCell(3, pts);
+  //   apex = top + (top - center)
+  //        = p2 + p3 - center
+  auto const center =
+    0.25 * (corners[0] + corners[1] + corners[2] + corners[3]);
+  store(8, vector_3d{ corners[2] + corners[3] - center });
 }
 
 //-----------------------------------------------------------------------------
-void SetInputs(vtkAppendPolyData* apd, std::unordered_set<vtkPolyData*> inputs)
+vtkIdType* WriteFrustumCells(vtkIdType* cells, vtkIdType base)
 {
-  // Walk the list of existing inputs, removing any that aren't in the new list
-  auto i = apd->GetNumberOfInputConnections(0);
-  while (i--)
+  static vtkIdType const faces[6][4] = {
+    { 0, 1, 2, 3 }, { 4, 5, 6, 7 },
+    { 0, 1, 5, 4 }, { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 3, 0, 4, 7 },
+  };
+
+  for (auto const& face : faces)
   {
-    auto const input = apd->GetInput(i);
-    auto const ii = inputs.find(input);
-    if (ii != inputs.end())
+    *cells++ = 4;
+    for (auto const i : face)
     {
-      inputs.erase(ii);
-    }
-    else
-    {
-      apd->RemoveInputConnection(0, apd->GetInputConnection(0, i));
+      *cells++ = base + i;
     }
   }
+  *cells++ = 3;
+  *cells++ = base + 2;
+  *cells++ = base + 3;
+  *cells++ = base + 8;
+
+  return cells;
+}
 
-  // Anything still in the new inputs list is missing from the existing inputs,
-  // so now we can add those
-  for (auto const input : inputs)
+//-----------------------------------------------------------------------------
+vtkIdType* WriteCollapsedFrustumCells(vtkIdType* cells, vtkIdType base)
+{
+  // Write the same cells as WriteFrustumCells, but with every vertex at the
+  // first point, so that the frustum occupies the same cell ids and
+  // connectivity but draws nothing
+  for (vtkIdType c = 0; c < CellsPerCamera; ++c)
   {
-    apd->AddInputData(input);
+    auto const n = (c < CellsPerCamera - 1 ? 4 : 3);
+    *cells++ = n;
+    cells = std::fill_n(cells, n, base);
   }
+
+  return cells;
 }
 
 } // namespace <anonymous>
@@ -153,25 +167,155 @@ void SetInputs(vtkAppendPolyData* apd, std::unordered_set<vtkPolyData*> inputs)
 class vtkMaptkCameraRepresentation::vtkInternal
 {
 public:
-  vtkCamera* NextCamera();
+  void UpdateLayout();
+  void UpdateNonActiveCells(int displayDensity);
+  void HideNonActiveCamera(vtkCamera* activeCamera);
 
   std::map<int, vtkCamera*> Cameras;
 
-  vtkNew<vtkPolyData> ActivePolyData;
-  vtkNew<vtkAppendPolyData> NonActiveAppendPolyData;
+  // Each camera owns a fixed slot of PointsPerCamera points in a single
+  // contiguous array; slots are stable as cameras are added, and removing a
+  // camera moves the last slot into the hole
+  std::unordered_map<vtkCamera*, size_t> Slots;
+  std::vector<vtkCamera*> SlotCameras;
+  std::vector<vtkMTimeType> SlotMTimes;
+  std::vector<vtkIdType> SlotPathIndices;
+  std::vector<vtkIdType> SlotCellOffsets;
+  std::vector<float> FrustumPoints;
 
-  vtkNew<vtkPolyData> DummyPolyData;
+  vtkNew<vtkPolyData> ActivePolyData;
+  vtkNew<vtkFloatArray> NonActivePointData;
+  vtkNew<vtkPolyData> NonActivePolyData;
+  vtkNew<vtkCellArray> NonActivePolys;
 
   vtkNew<vtkPolyData> PathPolyData;
 
-  std::unordered_map<vtkCamera*, PolyDataPointer> CameraNonActivePolyData;
-
-  vtkCamera* LastActiveCamera;
+  vtkCamera* HiddenCamera;
+  int LastDisplayDensity;
   double LastNonActiveCameraRepLength;
 
-  bool PathNeedsUpdate;
+  bool LayoutNeedsUpdate;
+  bool CellsNeedUpdate;
 };
 
+//-----------------------------------------------------------------------------
+void vtkMaptkCameraRepresentation::vtkInternal::UpdateLayout()
+{
+  // Hand the (possibly reallocated) frustum point buffer to VTK without
+  // copying
+  auto const numCameras = this->SlotCameras.size();
+  this->FrustumPoints.resize(3 * PointsPerCamera * numCameras);
+  this->NonActivePointData->SetArray(
+    this->FrustumPoints.data(),
+    static_cast<vtkIdType>(this->FrustumPoints.size()), 1);
+  this->NonActivePointData->Modified();
+
+  // Rebuild the path topology in camera order
+  vtkNew<vtkCellArray> lines;
+  this->SlotPathIndices.resize(numCameras);
+  this->PathPolyData->GetPoints()->SetNumberOfPoints(
+    static_cast<vtkIdType>(numCameras));
+  if (numCameras)
+  {
+    auto const n = static_cast<vtkIdType>(numCameras);
+    auto* const ids = lines->WritePointer(1, n + 1);
+    *ids++ = n;
+
+    auto* const points = this->PathPolyData->GetPoints();
+    vtkIdType pathIndex = 0;
+    for (auto const& camData : this->Cameras)
+    {
+      this->SlotPathIndices[this->Slots[camData.second]] = pathIndex;
+      points->SetPoint(pathIndex, camData.second->GetPosition());
+      *ids++ = pathIndex++;
+    }
+  }
+  this->PathPolyData->SetLines(lines.GetPointer());
+  this->PathPolyData->Modified();
+
+  this->LayoutNeedsUpdate = false;
+  this->CellsNeedUpdate = true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMaptkCameraRepresentation::vtkInternal::UpdateNonActiveCells(
+  int displayDensity)
+{
+  // Decimation only changes which slots are referenced by the cells; the
+  // frustum points themselves are left untouched. The active camera is
+  // included here and hidden by HideNonActiveCamera, so that changing the
+  // active camera does not rebuild the cells
+  auto const density = (displayDensity > 0 ? displayDensity : 1);
+
+  std::vector<size_t> displayed;
+  displayed.reserve(this->Cameras.size() / density + 1);
+
+  int skipCount = 0;
+  for (auto const& camData : this->Cameras)
+  {
+    if (!((skipCount++) % density))
+    {
+      displayed.push_back(this->Slots[camData.second]);
+    }
+  }
+
+  this->SlotCellOffsets.assign(this->SlotCameras.size(), -1);
+  this->NonActivePolys->Reset();
+  if (!displayed.empty())
+  {
+    auto const n = static_cast<vtkIdType>(displayed.size());
+    auto* const first =
+      this->NonActivePolys->WritePointer(n * CellsPerCamera,
+                                         n * CellIdsPerCamera);
+    auto* ids = first;
+    for (auto const slot : displayed)
+    {
+      this->SlotCellOffsets[slot] = ids - first;
+      ids = WriteFrustumCells(
+        ids, static_cast<vtkIdType>(slot) * PointsPerCamera);
+    }
+  }
+  this->NonActivePolys->Modified();
+  this->NonActivePolyData->DeleteCells();
+  this->NonActivePolyData->Modified();
+
+  this->HiddenCamera = nullptr;
+  this->LastDisplayDensity = displayDensity;
+  this->CellsNeedUpdate = false;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMaptkCameraRepresentation::vtkInternal::HideNonActiveCamera(
+  vtkCamera* activeCamera)
+{
+  // Restore the cells of the previously hidden camera and collapse those of
+  // the new active camera in place; only these two frustums are rewritten
+  auto* const cells = this->NonActivePolys->GetPointer();
+  auto const cellOffset = [this](vtkCamera* camera) -> vtkIdType {
+    auto const iter = (camera ? this->Slots.find(camera) : this->Slots.end());
+    return (iter == this->Slots.end() ? -1
+                                      : this->SlotCellOffsets[iter->second]);
+  };
+
+  auto const oldOffset = cellOffset(this->HiddenCamera);
+  if (oldOffset >= 0)
+  {
+    auto const slot = static_cast<vtkIdType>(this->Slots[this->HiddenCamera]);
+    WriteFrustumCells(cells + oldOffset, slot * PointsPerCamera);
+  }
+
+  auto const newOffset = cellOffset(activeCamera);
+  if (newOffset >= 0)
+  {
+    auto const slot = static_cast<vtkIdType>(this->Slots[activeCamera]);
+    WriteCollapsedFrustumCells(cells + newOffset, slot * PointsPerCamera);
+  }
+
+  this->NonActivePolys->Modified();
+  this->NonActivePolyData->Modified();
+
+  this->HiddenCamera = activeCamera;
+}
 
 //-----------------------------------------------------------------------------
 vtkMaptkCameraRepresentation::vtkMaptkCameraRepresentation()
@@ -183,9 +327,11 @@ vtkMaptkCameraRepresentation::vtkMaptkCameraRepresentation()
 
   this->ActiveCamera = 0;
 
-  this->Internal->LastActiveCamera = 0;
+  this->Internal->HiddenCamera = 0;
+  this->Internal->LastDisplayDensity = 1;
   this->Internal->LastNonActiveCameraRepLength = -1.0;
-  this->Internal->PathNeedsUpdate = false;
+  this->Internal->LayoutNeedsUpdate = false;
+  this->Internal->CellsNeedUpdate = false;
 
   // Set up camera actors and data
   vtkNew<vtkPolyDataMapper> activeCameraMapper;
@@ -198,12 +344,16 @@ vtkMaptkCameraRepresentation::vtkMaptkCameraRepresentation()
   this->ActiveActor->GetProperty()->SetLineWidth(2.0);
   this->ActiveActor->PickableOff();
 
-  this->Internal->NonActiveAppendPolyData->AddInputData(
-    this->Internal->DummyPolyData.GetPointer());
+  vtkNew<vtkPoints> nonActivePoints;
+  this->Internal->NonActivePointData->SetNumberOfComponents(3);
+  nonActivePoints->SetData(this->Internal->NonActivePointData.GetPointer());
+
+  this->Internal->NonActivePolyData->SetPoints(nonActivePoints.GetPointer());
+  this->Internal->NonActivePolyData->SetPolys(
+    this->Internal->NonActivePolys.GetPointer());
 
   vtkNew<vtkPolyDataMapper> nonActiveMapper;
-  nonActiveMapper->SetInputConnection(
-    this->Internal->NonActiveAppendPolyData->GetOutputPort());
+  nonActiveMapper->SetInputData(this->Internal->NonActivePolyData.GetPointer());
 
   this->NonActiveActor = vtkActor::New();
   this->NonActiveActor->SetMapper(nonActiveMapper.GetPointer());
@@ -249,7 +399,13 @@ void vtkMaptkCameraRepresentation::AddCamera(int id, vtkCamera* camera)
 
   this->Internal->Cameras[id] = camera;
   camera->Register(this);
-  this->Internal->PathNeedsUpdate = true;
+
+  // Append a slot for the new camera; its frustum is computed on next update
+  this->Internal->Slots[camera] = this->Internal->SlotCameras.size();
+  this->Internal->SlotCameras.push_back(camera);
+  this->Internal->SlotMTimes.push_back(0);
+
+  this->Internal->LayoutNeedsUpdate = true;
   this->Modified();
 }
 
@@ -263,13 +419,35 @@ void vtkMaptkCameraRepresentation::RemoveCamera(int id)
     return;
   }
 
-  // Remove camera from non-active polydata collection
-  auto const pd = this->Internal->CameraNonActivePolyData.find(camIter->second);
-  if (pd != this->Internal->CameraNonActivePolyData.end())
+  // Move the last slot into the slot of the removed camera
+  auto& internal = *this->Internal;
+  auto const slotIter = internal.Slots.find(camIter->second);
+  auto const slot = slotIter->second;
+  auto const last = internal.SlotCameras.size() - 1;
+  if (slot != last)
   {
-    this->Internal->NonActiveAppendPolyData->RemoveInputData(pd->second);
-    this->Internal->CameraNonActivePolyData.erase(pd);
+    auto const moved = internal.SlotCameras[last];
+    internal.SlotCameras[slot] = moved;
+    internal.Slots[moved] = slot;
+
+    // The last slot has no points yet if it was added since the last update;
+    // in that case, its frustum is computed on the next update instead
+    auto const end = 3 * PointsPerCamera * (last + 1);
+    if (internal.FrustumPoints.size() >= static_cast<size_t>(end))
+    {
+      internal.SlotMTimes[slot] = internal.SlotMTimes[last];
+      std::copy_n(internal.FrustumPoints.begin() + (3 * PointsPerCamera * last),
+                  3 * PointsPerCamera,
+                  internal.FrustumPoints.begin() + (3 * PointsPerCamera * slot));
+    }
+    else
+    {
+      internal.SlotMTimes[slot] = 0;
+    }
   }
+  internal.Slots.erase(slotIter);
+  internal.SlotCameras.pop_back();
+  internal.SlotMTimes.pop_back();
 
   if (this->ActiveCamera == camIter->second)
   {
@@ -278,15 +456,15 @@ void vtkMaptkCameraRepresentation::RemoveCamera(int id)
 
   camIter->second->UnRegister(this);
   this->Internal->Cameras.erase(camIter);
-  this->Internal->PathNeedsUpdate = true;
+  this->Internal->LayoutNeedsUpdate = true;
   this->Modified();
 }
 
 //-----------------------------------------------------------------------------
 void vtkMaptkCameraRepresentation::CamerasModified()
 {
-  this->Internal->PathNeedsUpdate = true;
-  this->Internal->CameraNonActivePolyData.clear();
+  // Cameras whose modification time has changed since their frustum was
+  // last computed are found and updated by Update()
   this->Modified();
 }
 
@@ -309,83 +487,91 @@ void vtkMaptkCameraRepresentation::SetActiveCamera(int id)
 //-----------------------------------------------------------------------------
 void vtkMaptkCameraRepresentation::Update()
 {
-  if (this->Internal->LastNonActiveCameraRepLength !=
-      this->NonActiveCameraRepLength)
+  auto& internal = *this->Internal;
+
+  if (internal.LayoutNeedsUpdate)
   {
-    // If the non-active camera length has changed, the old polydata's are not
-    // useful, and every camera needs to be updated
-    this->Internal->CameraNonActivePolyData.clear();
+    internal.UpdateLayout();
   }
-  this->Internal->LastNonActiveCameraRepLength = this->NonActiveCameraRepLength;
 
-  // (Re)build non-active cameras representation and build polydata for any
-  // cameras that are missing
-  std::unordered_set<vtkPolyData*> nonActivePolyData;
-  int skipCount = 0;
-  for(auto const camData : this->Internal->Cameras)
+  if (internal.LastNonActiveCameraRepLength != this->NonActiveCameraRepLength)
   {
-    if (!((skipCount++) % this->DisplayDensity))
+    // If the non-active camera length has changed, every camera needs to be
+    // updated
+    std::fill(internal.SlotMTimes.begin(), internal.SlotMTimes.end(), 0);
+  }
+  internal.LastNonActiveCameraRepLength = this->NonActiveCameraRepLength;
+
+  // Find the cameras which have changed since their frustum was computed
+  std::vector<size_t> modifiedSlots;
+  for (size_t slot = 0; slot < internal.SlotCameras.size(); ++slot)
+  {
+    if (internal.SlotCameras[slot]->GetMTime() != internal.SlotMTimes[slot])
     {
-      if (camData.second != this->ActiveCamera)
-      {
-        auto& pd = this->Internal->CameraNonActivePolyData[camData.second];
-        if (!pd)
-        {
-          // If we don't already have polydata for this non-active camera,
-          // build it now
-          pd = PolyDataPointer::New();
-          BuildCameraFrustum(camData.second, this->NonActiveCameraRepLength, pd);
-        }
-        nonActivePolyData.insert(pd);
-      }
+      modifiedSlots.push_back(slot);
     }
   }
 
-  if (nonActivePolyData.empty())
+  // Rewrite only the frustums (and path points) of the modified cameras
+  if (!modifiedSlots.empty())
   {
-    // vtkAppendPolyData complains if it has no inputs, so if there aren't any
-    // non-active cameras, add the dummy polydata
-    nonActivePolyData.insert(this->Internal->DummyPolyData.GetPointer());
-  }
+    auto const length = this->NonActiveCameraRepLength;
+    auto* const frustumPoints = internal.FrustumPoints.data();
+    kwiver::maptk::parallel_for(
+      0, modifiedSlots.size(), [&](size_t begin, size_t end){
+        for (auto i = begin; i < end; ++i)
+        {
+          auto const slot = modifiedSlots[i];
+          auto* const camera = internal.SlotCameras[slot];
+          ComputeCameraFrustum(
+            camera, length, frustumPoints + (3 * PointsPerCamera * slot));
+          internal.SlotMTimes[slot] = camera->GetMTime();
+        }
+      }, 256);
+    internal.NonActivePointData->Modified();
 
-  SetInputs(this->Internal->NonActiveAppendPolyData.GetPointer(),
-            nonActivePolyData);
+    auto* const pathPoints = internal.PathPolyData->GetPoints();
+    for (auto const slot : modifiedSlots)
+    {
+      pathPoints->SetPoint(internal.SlotPathIndices[slot],
+                           internal.SlotCameras[slot]->GetPosition());
+    }
+    pathPoints->Modified();
+  }
 
-  // (Re)build active camera representation if needed
-  if (!this->ActiveCamera)
+  // Rebuild the non-active cells if the set of displayed cameras changed,
+  // and hide the active camera among them if it changed
+  if (internal.CellsNeedUpdate ||
+      internal.LastDisplayDensity != this->DisplayDensity)
   {
-    this->Internal->ActivePolyData->Reset();
-    this->Internal->ActivePolyData->Modified();
+    internal.UpdateNonActiveCells(this->DisplayDensity);
   }
-  else if (this->ActiveCamera != this->Internal->LastActiveCamera)
+  if (internal.HiddenCamera != this->ActiveCamera)
   {
-    this->Internal->ActivePolyData->Reset();
-    BuildCameraFrustum(this->ActiveCamera, this->ActiveCameraRepLength,
-                       this->Internal->ActivePolyData.GetPointer());
+    internal.HideNonActiveCamera(this->ActiveCamera);
   }
 
-  // Path Actor
-  if (this->Internal->PathNeedsUpdate)
+  // (Re)build active camera representation
+  internal.ActivePolyData->Reset();
+  if (this->ActiveCamera)
   {
-    this->Internal->PathPolyData->Reset();
+    vtkNew<vtkFloatArray> activePointData;
+    activePointData->SetNumberOfComponents(3);
+    activePointData->SetNumberOfTuples(PointsPerCamera);
+    ComputeCameraFrustum(this->ActiveCamera, this->ActiveCameraRepLength,
+                         activePointData->GetPointer(0));
 
-    vtkNew<vtkPoints> points;
-    this->Internal->PathPolyData->SetPoints(points.GetPointer());
-    points->Allocate(this->Internal->Cameras.size());
+    vtkNew<vtkPoints> activePoints;
+    activePoints->SetData(activePointData.GetPointer());
 
-    vtkNew<vtkCellArray> lines;
-    this->Internal->PathPolyData->SetLines(lines.GetPointer());
-    lines->InsertNextCell(static_cast<int>(this->Internal->Cameras.size()));
+    vtkNew<vtkCellArray> activePolys;
+    WriteFrustumCells(
+      activePolys->WritePointer(CellsPerCamera, CellIdsPerCamera), 0);
 
-    for(auto const& camData : this->Internal->Cameras)
-    {
-      double position[3];
-      camData.second->GetPosition(position);
-      lines->InsertCellPoint(points->InsertNextPoint(position));
-    }
-    this->Internal->PathPolyData->Modified();
-    this->Internal->PathNeedsUpdate = false;
+    internal.ActivePolyData->SetPoints(activePoints.GetPointer());
+    internal.ActivePolyData->SetPolys(activePolys.GetPointer());
   }
+  internal.ActivePolyData->Modified();
 }
 
 //-----------------------------------------------------------------------------
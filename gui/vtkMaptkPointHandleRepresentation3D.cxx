@@ -45,6 +45,28 @@ void vtkMaptkPointHandleRepresentation3D::PrintSelf(ostream& os,
   this->Superclass::PrintSelf(os, indent);
 }
 
+//----------------------------------------------------------------------------
+void vtkMaptkPointHandleRepresentation3D::DeepCopy(vtkProp* prop)
+{
+  this->Superclass::DeepCopy(prop);
+  auto* const rep = vtkMaptkPointHandleRepresentation3D::SafeDownCast(prop);
+  if (rep)
+  {
+    this->Nearby = rep->Nearby;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMaptkPointHandleRepresentation3D::ShallowCopy(vtkProp* prop)
+{
+  this->Superclass::ShallowCopy(prop);
+  auto* const rep = vtkMaptkPointHandleRepresentation3D::SafeDownCast(prop);
+  if (rep)
+  {
+    this->Nearby = rep->Nearby;
+  }
+}
+
 // Override to ensure that the pick tolerance is always about the same as
 // handle size.
 //----------------------------------------------------------------------------
@@ -53,6 +75,17 @@ int vtkMaptkPointHandleRepresentation3D::ComputeInteractionState(
   int Y,
   int vtkNotUsed(modify))
 {
+  // Skip the (expensive) pick for handles which are known not to be near
+  if (this->Nearby && !this->Nearby(this, X, Y))
+  {
+    this->InteractionState = vtkHandleRepresentation::Outside;
+    if (this->ActiveRepresentation)
+    {
+      this->VisibilityOff();
+    }
+    return this->InteractionState;
+  }
+
   this->VisibilityOn(); // actor must be on to be picked
 
   vtkAssemblyPath* path = this->GetAssemblyPath(X, Y, 0., this->CursorPicker);
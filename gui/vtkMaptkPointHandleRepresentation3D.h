@@ -34,6 +34,9 @@
 // VTK includes
 #include <vtkPointHandleRepresentation3D.h>
 
+// STL includes
+#include <functional>
+
 // Forward declarations
 class vtkRenderer;
 
@@ -47,6 +50,17 @@ public:
 
   static vtkMaptkPointHandleRepresentation3D* New();
 
+  // Function telling whether a handle may be near a display position; if
+  // set, only handles for which it returns true are picked
+  using NearbyFunction =
+    std::function<bool(vtkHandleRepresentation*, int X, int Y)>;
+  void SetNearbyFunction(NearbyFunction const& f) { this->Nearby = f; }
+
+  // Override to copy the nearby function to the handles of a seed widget,
+  // which are created as copies of its handle representation
+  void DeepCopy(vtkProp* prop) override;
+  void ShallowCopy(vtkProp* prop) override;
+
 protected:
   vtkMaptkPointHandleRepresentation3D() = default;
   ~vtkMaptkPointHandleRepresentation3D() = default;
@@ -55,6 +69,8 @@ protected:
   // handle size.
   int ComputeInteractionState(int X, int Y, int modify) override;
 
+  NearbyFunction Nearby;
+
 private:
   vtkMaptkPointHandleRepresentation3D(
     const vtkMaptkPointHandleRepresentation3D&) = delete;
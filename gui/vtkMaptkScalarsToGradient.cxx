@@ -30,11 +30,16 @@
 
 #include "vtkMaptkScalarsToGradient.h"
 
+#include <maptk/parallel_for.h>
+
 #include <vtkObjectFactory.h>
 #include <vtkTemplateAliasMacro.h>
 
 #include <qtGradient.h>
-#include <qtIndexRange.h>
+
+#include <array>
+#include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkMaptkScalarsToGradient);
 
@@ -47,25 +52,57 @@ QTE_IMPLEMENT_D_FUNC(vtkMaptkScalarsToGradient)
 namespace // anonymous
 {
 
-typedef double (*GetValue)(void const*, int);
+// Number of entries in the quantized gradient lookup table
+constexpr int TableSize = 4096;
+
+// Minimum number of values mapped by each task when mapping in parallel
+constexpr size_t MinimumChunkSize = 65536;
+
+using Color = std::array<unsigned char, 4>;
 
 //-----------------------------------------------------------------------------
-template <typename T>
-double getValue(void const* data, int offset)
+template <typename T, int Components>
+void mapValues(T const* input, int inputIncrement, unsigned char* output,
+               size_t begin, size_t end, double lower, double scale,
+               Color const* table)
 {
-  auto const realData = static_cast<T const*>(data);
-  return static_cast<double>(realData[offset]);
+  // Scale values directly to table indices
+  auto const tableScale = scale * static_cast<double>(TableSize - 1);
+  auto const maxIndex = static_cast<double>(TableSize - 1);
+
+  auto in = input + (begin * static_cast<size_t>(inputIncrement));
+  auto out = output + (begin * Components);
+  for (auto i = begin; i < end; ++i)
+  {
+    auto const k = (static_cast<double>(*in) - lower) * tableScale;
+
+    // Note: written so that NaN maps to the first entry
+    auto const index =
+      (k > 0.0 ? static_cast<int>((k < maxIndex ? k : maxIndex) + 0.5) : 0);
+    auto const& c = table[index];
+
+    for (int n = 0; n < Components; ++n)
+    {
+      out[n] = c[n];
+    }
+
+    in += inputIncrement;
+    out += Components;
+  }
 }
 
 //-----------------------------------------------------------------------------
-GetValue typedGetValue(int type)
+template <typename T, int Components>
+void mapScalars(void const* input, int inputIncrement, unsigned char* output,
+                size_t numberOfValues, double lower, double scale,
+                Color const* table)
 {
-  switch (type)
-  {
-    vtkTemplateAliasMacro(return &getValue<VTK_TT>);
-    default:
-      return 0;
-  }
+  auto const typedInput = static_cast<T const*>(input);
+  kwiver::maptk::parallel_for(
+    0, numberOfValues, [&](size_t begin, size_t end){
+      mapValues<T, Components>(typedInput, inputIncrement, output,
+                               begin, end, lower, scale, table);
+    }, MinimumChunkSize);
 }
 
 } // namespace <anonymous>
@@ -74,12 +111,34 @@ GetValue typedGetValue(int type)
 class vtkMaptkScalarsToGradientPrivate
 {
 public:
+  void updateTable();
+
   double lower;
   double scale;
 
   qtGradient gradient;
+  std::vector<Color> table;
 };
 
+//-----------------------------------------------------------------------------
+void vtkMaptkScalarsToGradientPrivate::updateTable()
+{
+  // Sample the gradient once per table entry, so that mapping scalars does
+  // not need to interpolate the gradient stops for every value
+  this->table.resize(TableSize);
+  for (int i = 0; i < TableSize; ++i)
+  {
+    auto const k = static_cast<double>(i) / static_cast<double>(TableSize - 1);
+    auto const c = this->gradient.at(k);
+
+    this->table[i] = Color{{
+      static_cast<unsigned char>(c.red()),
+      static_cast<unsigned char>(c.green()),
+      static_cast<unsigned char>(c.blue()),
+      static_cast<unsigned char>(c.alpha())}};
+  }
+}
+
 //-----------------------------------------------------------------------------
 vtkMaptkScalarsToGradient::vtkMaptkScalarsToGradient()
   : d_ptr(new vtkMaptkScalarsToGradientPrivate)
@@ -87,6 +146,7 @@ vtkMaptkScalarsToGradient::vtkMaptkScalarsToGradient()
   QTE_D();
   d->lower = 0.0;
   d->scale = 1.0;
+  d->updateTable();
 
   this->vtkScalarsToColors::SetRange(0.0, 1.0);
 }
@@ -103,6 +163,7 @@ void vtkMaptkScalarsToGradient::SetGradient(qtGradient const& gradient)
   QTE_D();
 
   d->gradient = gradient;
+  d->updateTable();
 
   this->Modified();
 }
@@ -112,6 +173,8 @@ void vtkMaptkScalarsToGradient::SetRange(double min, double max)
 {
   QTE_D();
 
+  // The table is sampled over the normalized range of the gradient, so only
+  // the mapping of scalars to the table needs to change here
   d->lower = min;
   d->scale = 1.0 / (max - min);
 
@@ -138,41 +201,32 @@ void vtkMaptkScalarsToGradient::MapScalarsThroughTable2(
 {
   QTE_D();
 
-  auto const get = typedGetValue(inputDataType);
-  if (!get)
-  {
-    vtkErrorMacro(<< __func__ << ": Unknown input data type");
-    return;
-  }
+  auto const count = static_cast<size_t>(numberOfValues);
+  auto const table = d->table.data();
 
   switch (outputFormat)
   {
     case VTK_RGBA:
-      foreach (auto const i, qtIndexRange(numberOfValues))
+      switch (inputDataType)
       {
-        auto const value = (*get)(input, i);
-        auto const k = (value - d->lower) * d->scale;
-        auto const c = d->gradient.at(k);
-
-        auto const out = output + (4 * i);
-        out[0] = c.red();
-        out[1] = c.green();
-        out[2] = c.blue();
-        out[3] = c.alpha();
+        vtkTemplateAliasMacro(
+          mapScalars<VTK_TT, 4>(input, inputIncrement, output, count,
+                                d->lower, d->scale, table));
+        default:
+          vtkErrorMacro(<< __func__ << ": Unknown input data type");
+          return;
       }
       break;
 
     case VTK_RGB:
-      foreach (auto const i, qtIndexRange(numberOfValues))
+      switch (inputDataType)
       {
-        auto const value = (*get)(input, i);
-        auto const k = (value - d->lower) * d->scale;
-        auto const c = d->gradient.at(k);
-
-        auto const out = output + (3 * i);
-        out[0] = c.red();
-        out[1] = c.green();
-        out[2] = c.blue();
+        vtkTemplateAliasMacro(
+          mapScalars<VTK_TT, 3>(input, inputIncrement, output, count,
+                                d->lower, d->scale, table));
+        default:
+          vtkErrorMacro(<< __func__ << ": Unknown input data type");
+          return;
       }
       break;
 
@@ -71,6 +71,7 @@ vtkMaptkSeedWidget::~vtkMaptkSeedWidget()
 void vtkMaptkSeedWidget::DeleteSeed(int i)
 {
   this->Superclass::DeleteSeed(i);
+  this->InvokeEvent(vtkMaptkSeedWidget::SeedDeletedEvent, &i);
   this->HighlightActiveSeed();
 }
 
@@ -65,7 +65,7 @@ public:
   void HighlightActiveSeed();
 
   /**
-   * Delete the nth seed.
+   * Delete the nth seed. Fires SeedDeletedEvent once the seed is gone.
    */
   void DeleteSeed(int n);
 
@@ -79,7 +79,8 @@ public:
    */
   enum vtkMaptkSeedWidgetEvents
   {
-    ActiveSeedChangedEvent = vtkCommand::UserEvent + 1
+    ActiveSeedChangedEvent = vtkCommand::UserEvent + 1,
+    SeedDeletedEvent
   };
 
 protected:
@@ -0,0 +1,171 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for a bounded queue of asynchronous tasks
+ */
+
+#ifndef MAPTK_BOUNDED_TASK_QUEUE_H_
+#define MAPTK_BOUNDED_TASK_QUEUE_H_
+
+#include <vital/util/thread_pool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <future>
+#include <utility>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// A queue of tasks run by the vital thread pool with a bounded backlog
+/**
+ * Tasks pushed to the queue run asynchronously in the vital thread pool.
+ * Once \c max_pending tasks are outstanding, \c push waits for the oldest
+ * task to finish, so that a fast producer (e.g. a video decoder) cannot
+ * queue an unbounded amount of work and memory.  The first exception thrown
+ * by any task is re-thrown by \c push or \c wait.  The destructor waits for
+ * all outstanding tasks but discards their exceptions.
+ *
+ * \note Do not push tasks from a task that is itself running in the vital
+ *       thread pool, as waiting on the backlog could then dead-lock.
+ */
+class bounded_task_queue
+{
+public:
+  /// Constructor
+  /**
+   *  \param [in] max_pending the most tasks which may be outstanding; if
+   *              zero, four tasks per pool thread are allowed
+   */
+  explicit bounded_task_queue(size_t max_pending = 0)
+    : max_pending_(max_pending ? max_pending :
+        4 * std::max<size_t>(vital::thread_pool::instance().num_threads(), 1))
+  {
+  }
+
+  ~bounded_task_queue()
+  {
+    for (auto& task : pending_)
+    {
+      try
+      {
+        task.get();
+      }
+      catch (...)
+      {
+      }
+    }
+  }
+
+  bounded_task_queue(bounded_task_queue const&) = delete;
+  bounded_task_queue& operator=(bounded_task_queue const&) = delete;
+
+  /// Queue \p func to run asynchronously
+  template <typename Func>
+  void push(Func&& func)
+  {
+    while (pending_.size() >= max_pending_)
+    {
+      pop();
+    }
+    pending_.push_back(
+      vital::thread_pool::instance().enqueue(std::forward<Func>(func)));
+  }
+
+  /// Wait for all outstanding tasks to finish
+  void wait()
+  {
+    std::exception_ptr error;
+    while (!pending_.empty())
+    {
+      try
+      {
+        pop();
+      }
+      catch (...)
+      {
+        if (!error)
+        {
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+
+  /// Retire the oldest tasks which have already finished, without waiting
+  /**
+   * Tasks are retired in the order they were pushed, so a finished task
+   * stays outstanding until all older tasks have finished.  The exception
+   * of a retired task, if any, is re-thrown.
+   */
+  void poll()
+  {
+    while (!pending_.empty() &&
+           pending_.front().wait_for(std::chrono::seconds(0)) ==
+             std::future_status::ready)
+    {
+      pop();
+    }
+  }
+
+  /// The number of outstanding tasks
+  size_t size() const { return pending_.size(); }
+
+  /// The number of tasks retired so far, in the order they were pushed
+  size_t completed() const { return completed_; }
+
+protected:
+  /// Wait for the oldest task, re-throwing its exception
+  void pop()
+  {
+    auto task = std::move(pending_.front());
+    pending_.pop_front();
+    ++completed_;
+    task.get();
+  }
+
+  size_t max_pending_;
+  size_t completed_ = 0;
+  std::deque<std::future<void>> pending_;
+};
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_BOUNDED_TASK_QUEUE_H_
@@ -0,0 +1,153 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of binary camera file I/O
+ */
+
+#include "camera_binary_io.h"
+
+#include <vital/exceptions/io.h>
+#include <vital/types/camera_intrinsics.h>
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+char const signature[8] = { 'M', 'A', 'P', 'T', 'K', 'C', 'A', 'M' };
+uint32_t const format_version = 1;
+
+/// The fixed size record of one camera
+struct camera_record
+{
+  int64_t frame;
+  double values[12];
+};
+
+}
+
+/// Open \p path for writing, throwing vital::file_write_exception on error
+camera_binary_writer
+::camera_binary_writer(vital::path_t const& path)
+  : path_(path),
+    stream_(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc)
+{
+  if (!stream_)
+  {
+    throw vital::file_write_exception(path, "Could not open file for writing");
+  }
+  stream_.write(signature, sizeof(signature));
+  stream_.write(reinterpret_cast<char const*>(&format_version),
+                sizeof(format_version));
+}
+
+/// Append the camera of frame \p frame
+void
+camera_binary_writer
+::write(vital::frame_id_t frame, vital::camera_perspective const& camera)
+{
+  camera_record r;
+  r.frame = static_cast<int64_t>(frame);
+
+  vital::vector_3d const c = camera.center();
+  vital::vector_4d const q = camera.rotation().quaternion().coeffs();
+  auto const K = camera.intrinsics();
+  vital::vector_2d const pp = K->principal_point();
+  double const values[12] = {
+    c[0], c[1], c[2], q[0], q[1], q[2], q[3],
+    K->focal_length(), pp[0], pp[1], K->aspect_ratio(), K->skew() };
+  std::memcpy(r.values, values, sizeof(values));
+
+  stream_.write(reinterpret_cast<char const*>(&r), sizeof(r));
+  if (!stream_)
+  {
+    throw vital::file_write_exception(path_, "Failed to write camera");
+  }
+}
+
+/// Flush and close the file
+void
+camera_binary_writer
+::close()
+{
+  stream_.close();
+  if (stream_.fail())
+  {
+    throw vital::file_write_exception(path_, "Failed to close file");
+  }
+}
+
+/// Read all cameras from a binary camera file
+vital::camera_map::map_camera_t
+read_camera_binary_file(vital::path_t const& path)
+{
+  std::ifstream stream(path.c_str(), std::ios::in | std::ios::binary);
+  if (!stream)
+  {
+    throw vital::file_not_found_exception(path, "Could not open file");
+  }
+
+  char sig[sizeof(signature)];
+  uint32_t version = 0;
+  stream.read(sig, sizeof(sig));
+  stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+  if (!stream || std::memcmp(sig, signature, sizeof(sig)) != 0 ||
+      version != format_version)
+  {
+    throw vital::invalid_data("Not a binary camera file: " + path);
+  }
+
+  vital::camera_map::map_camera_t cameras;
+  camera_record r;
+  while (stream.read(reinterpret_cast<char*>(&r), sizeof(r)))
+  {
+    double const* v = r.values;
+    vital::simple_camera_intrinsics K(v[7], vital::vector_2d(v[8], v[9]),
+                                      v[10], v[11]);
+    vital::rotation_d R(vital::vector_4d(v[3], v[4], v[5], v[6]));
+    cameras[static_cast<vital::frame_id_t>(r.frame)] =
+      std::make_shared<vital::simple_camera_perspective>(
+        vital::vector_3d(v[0], v[1], v[2]), R, K);
+  }
+  if (stream.gcount() != 0)
+  {
+    throw vital::invalid_data("Truncated binary camera file: " + path);
+  }
+  return cameras;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,91 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for binary camera file I/O
+ */
+
+#ifndef MAPTK_CAMERA_BINARY_IO_H_
+#define MAPTK_CAMERA_BINARY_IO_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/camera_map.h>
+#include <vital/types/camera_perspective.h>
+#include <vital/vital_types.h>
+
+#include <fstream>
+#include <string>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Writer of many cameras into a single binary file
+/**
+ * The file holds an 8 byte signature, \c "MAPTKCAM", a 32 bit version
+ * number, and then one fixed size record per camera in native byte order:
+ * the 64 bit frame number followed by 12 doubles, the camera center (3), the
+ * rotation quaternion (x, y, z, w) and the intrinsics (focal length,
+ * principal point x and y, aspect ratio, skew).  Lens distortion is not
+ * stored.  Records may be appended as cameras are produced, which is much
+ * faster than writing one KRTD file per frame for long sequences.
+ */
+class MAPTK_EXPORT camera_binary_writer
+{
+public:
+  /// Open \p path for writing, throwing vital::file_write_exception on error
+  explicit camera_binary_writer(vital::path_t const& path);
+
+  /// Append the camera of frame \p frame
+  void write(vital::frame_id_t frame, vital::camera_perspective const& camera);
+
+  /// Flush and close the file
+  void close();
+
+protected:
+  vital::path_t path_;
+  std::ofstream stream_;
+};
+
+/// Read all cameras from a binary camera file
+/**
+ * \throws vital::file_not_found_exception if the file cannot be opened
+ * \throws vital::invalid_data if the file is not a binary camera file
+ */
+MAPTK_EXPORT
+vital::camera_map::map_camera_t
+read_camera_binary_file(vital::path_t const& path);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_CAMERA_BINARY_IO_H_
@@ -0,0 +1,258 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of parallel camera resection
+ */
+
+#include "camera_resection.h"
+
+#include <maptk/parallel_for.h>
+
+#include <vital/algo/estimate_pnp.h>
+#include <vital/algo/optimize_cameras.h>
+#include <vital/types/camera_perspective.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <unordered_map>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+char const* const PNP_BLOCK = "estimate_pnp";
+char const* const OPTIMIZER_BLOCK = "camera_optimizer";
+
+/// The correspondences between features and landmarks in one frame
+struct frame_correspondences
+{
+  std::vector<vital::feature_sptr> features;
+  std::vector<vital::landmark_sptr> landmarks;
+};
+
+/// Check if \p config selects an implementation of the nested \p block
+bool
+has_nested_algo(vital::config_block_sptr const& config, std::string const& block)
+{
+  auto const key = block + vital::config_block::block_sep + "type";
+  return config->has_value(key) &&
+         !config->get_value<std::string>(key).empty();
+}
+
+}
+
+/// Check the configuration of the nested algorithms used for resection
+bool
+check_resection_configuration(vital::config_block_sptr const& config)
+{
+  if (!vital::algo::estimate_pnp::check_nested_algo_configuration(
+         PNP_BLOCK, config))
+  {
+    return false;
+  }
+  return !has_nested_algo(config, OPTIMIZER_BLOCK) ||
+         vital::algo::optimize_cameras::check_nested_algo_configuration(
+           OPTIMIZER_BLOCK, config);
+}
+
+/// Add the default configuration of the nested algorithms used for resection
+void
+get_resection_configuration(vital::config_block_sptr const& config)
+{
+  vital::algo::estimate_pnp::get_nested_algo_configuration(
+    PNP_BLOCK, config, vital::algo::estimate_pnp_sptr());
+  vital::algo::optimize_cameras::get_nested_algo_configuration(
+    OPTIMIZER_BLOCK, config, vital::algo::optimize_cameras_sptr());
+}
+
+/// Estimate the cameras of \p frames by resection against \p landmarks
+vital::camera_map::map_camera_t
+resect_cameras(vital::config_block_sptr const& config,
+               std::vector<vital::frame_id_t> const& frames,
+               vital::camera_map::map_camera_t const& cameras,
+               vital::landmark_map::map_landmark_t const& landmarks,
+               vital::feature_track_set const& tracks,
+               size_t min_inliers)
+{
+  vital::camera_map::map_camera_t resected;
+  if (frames.empty())
+  {
+    return resected;
+  }
+
+  std::unordered_map<vital::frame_id_t, size_t> frame_index;
+  for (size_t i = 0; i < frames.size(); ++i)
+  {
+    frame_index.emplace(frames[i], i);
+  }
+
+  // Gather the correspondences of every frame in one pass over the tracks
+  std::vector<frame_correspondences> correspondences(frames.size());
+  for (auto const& t : tracks.tracks())
+  {
+    auto const lm = landmarks.find(t->id());
+    if (lm == landmarks.end() || !lm->second)
+    {
+      continue;
+    }
+    for (auto const& ts : *t)
+    {
+      auto const i = frame_index.find(ts->frame());
+      if (i == frame_index.end())
+      {
+        continue;
+      }
+      auto const fts =
+        std::dynamic_pointer_cast<vital::feature_track_state>(ts);
+      if (fts && fts->feature)
+      {
+        auto& c = correspondences[i->second];
+        c.features.push_back(fts->feature);
+        c.landmarks.push_back(lm->second);
+      }
+    }
+  }
+
+  // Use the intrinsics of the nearest existing camera for each frame; null
+  // and non-perspective cameras are skipped, walking outward in both
+  // directions until a perspective camera is found
+  using camera_iterator = vital::camera_map::map_camera_t::const_iterator;
+  using reverse_camera_iterator = std::reverse_iterator<camera_iterator>;
+  auto const is_perspective =
+    [](vital::camera_map::map_camera_t::value_type const& c)
+    {
+      return !!std::dynamic_pointer_cast<vital::camera_perspective>(c.second);
+    };
+
+  std::vector<vital::camera_intrinsics_sptr> intrinsics(frames.size());
+  for (size_t i = 0; i < frames.size(); ++i)
+  {
+    auto const next = cameras.lower_bound(frames[i]);
+    auto const after = std::find_if(next, cameras.end(), is_perspective);
+    auto const before = std::find_if(reverse_camera_iterator{ next },
+                                     cameras.rend(), is_perspective);
+
+    auto best = after;
+    if (before != cameras.rend() &&
+        (best == cameras.end() ||
+         std::abs(before->first - frames[i]) < std::abs(best->first - frames[i])))
+    {
+      best = std::prev(before.base());
+    }
+    if (best != cameras.end())
+    {
+      intrinsics[i] = std::static_pointer_cast<vital::camera_perspective>(
+                        best->second)->intrinsics();
+    }
+  }
+
+  bool const refine = has_nested_algo(config, OPTIMIZER_BLOCK);
+  min_inliers = std::max<size_t>(min_inliers, 4);
+
+  // Resect each frame independently
+  std::vector<vital::camera_perspective_sptr> results(frames.size());
+  parallel_for(0, frames.size(), [&](size_t begin, size_t end){
+    vital::algo::estimate_pnp_sptr pnp;
+    vital::algo::estimate_pnp::set_nested_algo_configuration(
+      PNP_BLOCK, config, pnp);
+    vital::algo::optimize_cameras_sptr optimizer;
+    if (refine)
+    {
+      vital::algo::optimize_cameras::set_nested_algo_configuration(
+        OPTIMIZER_BLOCK, config, optimizer);
+    }
+    if (!pnp)
+    {
+      return;
+    }
+
+    std::vector<vital::vector_2d> pts2d;
+    std::vector<vital::vector_3d> pts3d;
+    std::vector<bool> inliers;
+    for (auto i = begin; i < end; ++i)
+    {
+      auto const& c = correspondences[i];
+      if (!intrinsics[i] || c.features.size() < min_inliers)
+      {
+        continue;
+      }
+
+      pts2d.clear();
+      pts3d.clear();
+      for (size_t k = 0; k < c.features.size(); ++k)
+      {
+        pts2d.push_back(c.features[k]->loc());
+        pts3d.push_back(c.landmarks[k]->loc());
+      }
+
+      inliers.clear();
+      auto cam = pnp->estimate(pts2d, pts3d, intrinsics[i], inliers);
+      auto const num_inliers =
+        static_cast<size_t>(std::count(inliers.begin(), inliers.end(), true));
+      if (!cam || num_inliers < min_inliers)
+      {
+        continue;
+      }
+
+      if (optimizer)
+      {
+        std::vector<vital::feature_sptr> in_features;
+        std::vector<vital::landmark_sptr> in_landmarks;
+        for (size_t k = 0; k < inliers.size(); ++k)
+        {
+          if (inliers[k])
+          {
+            in_features.push_back(c.features[k]);
+            in_landmarks.push_back(c.landmarks[k]);
+          }
+        }
+        optimizer->optimize(cam, in_features, in_landmarks);
+      }
+      results[i] = cam;
+    }
+  }, 1);
+
+  for (size_t i = 0; i < frames.size(); ++i)
+  {
+    if (results[i])
+    {
+      resected.emplace(frames[i], results[i]);
+    }
+  }
+  return resected;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
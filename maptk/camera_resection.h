@@ -0,0 +1,92 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for parallel camera resection
+ */
+
+#ifndef MAPTK_CAMERA_RESECTION_H_
+#define MAPTK_CAMERA_RESECTION_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/config/config_block.h>
+#include <vital/types/camera_map.h>
+#include <vital/types/feature_track_set.h>
+#include <vital/types/landmark_map.h>
+
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Estimate the cameras of \p frames by resection against \p landmarks
+/**
+ * Each frame is resected independently, in parallel, from the features of
+ * its track states whose tracks have a landmark.  The cameras are estimated
+ * by the nested \c estimate_pnp algorithm of \p config, using the intrinsics
+ * of the nearest frame in \p cameras.  If \p config also configures a nested
+ * \c camera_optimizer algorithm, each camera is then refined using its inlier
+ * correspondences.  Every task creates its own algorithm instances, so the
+ * algorithms need not be thread safe.
+ *
+ *  \param [in] config the configuration block of the nested algorithms
+ *  \param [in] frames the frames to resect
+ *  \param [in] cameras the existing cameras, providing the intrinsics
+ *  \param [in] landmarks the landmarks to resect against
+ *  \param [in] tracks the tracks observing \p landmarks
+ *  \param [in] min_inliers the fewest inliers to accept a camera
+ *  \return the cameras which were successfully resected
+ */
+MAPTK_EXPORT
+vital::camera_map::map_camera_t
+resect_cameras(vital::config_block_sptr const& config,
+               std::vector<vital::frame_id_t> const& frames,
+               vital::camera_map::map_camera_t const& cameras,
+               vital::landmark_map::map_landmark_t const& landmarks,
+               vital::feature_track_set const& tracks,
+               size_t min_inliers = 10);
+
+/// Check the configuration of the nested algorithms used for resection
+MAPTK_EXPORT
+bool
+check_resection_configuration(vital::config_block_sptr const& config);
+
+/// Add the default configuration of the nested algorithms used for resection
+MAPTK_EXPORT
+void
+get_resection_configuration(vital::config_block_sptr const& config);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_CAMERA_RESECTION_H_
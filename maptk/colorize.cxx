@@ -35,28 +35,125 @@
 
 #include "colorize.h"
 
+#include <maptk/parallel_for.h>
+
+#include <vital/types/camera_perspective.h>
+
+#include <algorithm>
+
 
 namespace kwiver {
 namespace maptk {
 
+namespace {
+
+/// Clamp a coordinate to [0, size - 1], splitting it into index and weight
+inline void
+split_coordinate(double v, size_t size, size_t& i0, size_t& i1, float& w)
+{
+  double const max_v = static_cast<double>(size - 1);
+  // written so that NaN clamps to zero
+  v = (v > 0.0) ? std::min(v, max_v) : 0.0;
+  i0 = static_cast<size_t>(v);
+  i1 = std::min(i0 + 1, size - 1);
+  w = static_cast<float>(v - static_cast<double>(i0));
+}
+
+}
+
+
+/// Sample image colors at many locations with bilinear interpolation
+void
+sample_image_colors(
+  vital::image const& image,
+  double const* locations, size_t num_locations,
+  vital::rgb_color* colors, bool parallel)
+{
+  const vital::image_of<uint8_t> image_data(image);
+  size_t const ni = image_data.width();
+  size_t const nj = image_data.height();
+  if (ni == 0 || nj == 0)
+  {
+    std::fill(colors, colors + num_locations, vital::rgb_color());
+    return;
+  }
+
+  uint8_t const* const origin = image_data.first_pixel();
+  ptrdiff_t const istep = image_data.w_step();
+  ptrdiff_t const jstep = image_data.h_step();
+  ptrdiff_t const pstep = image_data.depth() < 3 ? 0 : image_data.d_step();
+
+  auto const sample = [&](size_t begin, size_t end)
+  {
+    for (size_t k = begin; k < end; ++k)
+    {
+      size_t i0, i1, j0, j1;
+      float wi, wj;
+      split_coordinate(locations[2 * k], ni, i0, i1, wi);
+      split_coordinate(locations[2 * k + 1], nj, j0, j1, wj);
+
+      // offsets of the four neighbors and their bilinear weights
+      ptrdiff_t const o00 = static_cast<ptrdiff_t>(i0) * istep +
+                            static_cast<ptrdiff_t>(j0) * jstep;
+      ptrdiff_t const o10 = o00 + static_cast<ptrdiff_t>(i1 - i0) * istep;
+      ptrdiff_t const o01 = o00 + static_cast<ptrdiff_t>(j1 - j0) * jstep;
+      ptrdiff_t const o11 = o10 + (o01 - o00);
+      float const w00 = (1.0f - wi) * (1.0f - wj);
+      float const w10 = wi * (1.0f - wj);
+      float const w01 = (1.0f - wi) * wj;
+      float const w11 = wi * wj;
+
+      uint8_t rgb[3];
+      for (int c = 0; c < 3; ++c)
+      {
+        uint8_t const* const p = origin + c * pstep;
+        float const v = w00 * p[o00] + w10 * p[o10] +
+                        w01 * p[o01] + w11 * p[o11];
+        rgb[c] = static_cast<uint8_t>(v + 0.5f);
+      }
+      colors[k] = vital::rgb_color(rgb[0], rgb[1], rgb[2]);
+    }
+  };
+
+  if (parallel)
+  {
+    parallel_for(0, num_locations, sample);
+  }
+  else
+  {
+    sample(0, num_locations);
+  }
+}
+
 
 /// Extract feature colors from a frame image
 vital::feature_set_sptr
 extract_feature_colors(
   vital::feature_set const& features,
-  vital::image_container const& image)
+  vital::image_container const& image,
+  bool parallel)
 {
-  const vital::image_of<uint8_t> image_data(image.get_image());
   std::vector<vital::feature_sptr> in_feat = features.features();
-  std::vector<vital::feature_sptr> out_feat;
-  out_feat.reserve(in_feat.size());
+  size_t const num_feat = in_feat.size();
 
-  for (auto const& f : in_feat)
+  std::vector<double> locations(2 * num_feat);
+  for (size_t k = 0; k < num_feat; ++k)
   {
-    auto const& loc = f->loc();
-    auto const fd = std::make_shared<vital::feature_d>(*f);
-    fd->set_color(image_data.at(static_cast<unsigned>(loc[0]),
-                                static_cast<unsigned>(loc[1])));
+    auto const& loc = in_feat[k]->loc();
+    locations[2 * k] = loc[0];
+    locations[2 * k + 1] = loc[1];
+  }
+  std::vector<vital::rgb_color> colors(num_feat);
+  sample_image_colors(image.get_image(), locations.data(), num_feat,
+                      colors.data(), parallel);
+
+  // the input features may be shared, so color copies of them
+  std::vector<vital::feature_sptr> out_feat;
+  out_feat.reserve(num_feat);
+  for (size_t k = 0; k < num_feat; ++k)
+  {
+    auto const fd = std::make_shared<vital::feature_d>(*in_feat[k]);
+    fd->set_color(colors[k]);
     out_feat.push_back(fd);
   }
 
@@ -76,22 +173,45 @@ extract_feature_colors(
   {
     return nullptr;
   }
-  const vital::image_of<uint8_t> image_data(image.get_image());
 
-  for (auto& state : tracks->frame_states( frame_id ))
+  // gather the feature states of this frame and their locations
+  auto const states = tracks->frame_states( frame_id );
+  std::vector<vital::feature_track_state*> feature_states;
+  std::vector<double> locations;
+  feature_states.reserve(states.size());
+  locations.reserve(2 * states.size());
+  for (auto const& state : states)
   {
-    auto fts = std::dynamic_pointer_cast<vital::feature_track_state>(state);
-    if ( !fts )
+    auto const fts =
+      dynamic_cast<vital::feature_track_state*>(state.get());
+    if ( !fts || !fts->feature )
     {
       continue;
     }
+    auto const& loc = fts->feature->loc();
+    feature_states.push_back(fts);
+    locations.push_back(loc[0]);
+    locations.push_back(loc[1]);
+  }
 
-    auto const feat = std::make_shared<vital::feature_d>(*fts->feature);
-    auto const& loc = feat->get_loc();
-    feat->set_color(image_data.at(static_cast<unsigned>(loc[0]),
-                                  static_cast<unsigned>(loc[1])));
+  size_t const num_feat = feature_states.size();
+  std::vector<vital::rgb_color> colors(num_feat);
+  sample_image_colors(image.get_image(), locations.data(), num_feat,
+                      colors.data());
 
-    fts->feature = feat;
+  for (size_t k = 0; k < num_feat; ++k)
+  {
+    auto& feature = feature_states[k]->feature;
+    // recolor features owned only by this state in place
+    auto const fd = dynamic_cast<vital::feature_d*>(feature.get());
+    if (fd && feature.use_count() == 1)
+    {
+      fd->set_color(colors[k]);
+      continue;
+    }
+    auto const feat = std::make_shared<vital::feature_d>(*feature);
+    feat->set_color(colors[k]);
+    feature = feat;
   }
 
   return tracks;
@@ -102,42 +222,238 @@ extract_feature_colors(
 vital::landmark_map_sptr compute_landmark_colors(
   vital::landmark_map const& landmarks,
   vital::feature_track_set const& tracks)
+{
+  return compute_landmark_colors(landmarks, tracks, landmark_color_options());
+}
+
+
+/// Compute colors for landmarks in parallel
+vital::landmark_map_sptr compute_landmark_colors(
+  vital::landmark_map const& landmarks,
+  vital::feature_track_set const& tracks,
+  landmark_color_options const& options)
 {
   auto colored_landmarks = landmarks.landmarks();
-  auto const no_such_landmark = colored_landmarks.end();
 
-  for (auto const track : tracks.tracks())
+  // dense landmark indices, in ID order
+  std::vector<vital::landmark_id_t> lm_ids;
+  std::vector<vital::landmark_map::map_landmark_t::iterator> lm_iters;
+  lm_ids.reserve(colored_landmarks.size());
+  lm_iters.reserve(colored_landmarks.size());
+  for (auto lmi = colored_landmarks.begin(); lmi != colored_landmarks.end();
+       ++lmi)
+  {
+    lm_ids.push_back(lmi->first);
+    lm_iters.push_back(lmi);
+  }
+
+  // match tracks to landmarks and count their feature observations
+  auto const all_tracks = tracks.tracks();
+  size_t const num_tracks = all_tracks.size();
+  size_t const no_landmark = lm_ids.size();
+  std::vector<size_t> track_lm(num_tracks, no_landmark);
+  std::vector<size_t> obs_offsets(num_tracks + 1, 0);
+  parallel_for(0, num_tracks, [&](size_t begin, size_t end)
+  {
+    for (size_t t = begin; t < end; ++t)
+    {
+      auto const lmid = static_cast<vital::landmark_id_t>(all_tracks[t]->id());
+      auto const it = std::lower_bound(lm_ids.begin(), lm_ids.end(), lmid);
+      if (it == lm_ids.end() || *it != lmid)
+      {
+        continue;
+      }
+      track_lm[t] = static_cast<size_t>(it - lm_ids.begin());
+      size_t n = 0;
+      for (auto const& ts : *all_tracks[t])
+      {
+        auto const fts = dynamic_cast<vital::feature_track_state*>(ts.get());
+        n += (fts && fts->feature) ? 1 : 0;
+      }
+      obs_offsets[t + 1] = n;
+    }
+  }, 256);
+  for (size_t t = 0; t < num_tracks; ++t)
+  {
+    obs_offsets[t + 1] += obs_offsets[t];
+  }
+
+  // flatten the observations, contiguous per track
+  size_t const num_obs = obs_offsets[num_tracks];
+  std::vector<vital::frame_id_t> obs_frames(num_obs);
+  std::vector<double> obs_locs(2 * num_obs);
+  std::vector<vital::rgb_color> obs_colors(num_obs);
+  std::vector<float> obs_weights(num_obs, 1.0f);
+  bool const weighted =
+    options.mode == landmark_color_options::WEIGHTED && options.cameras;
+  vital::camera_map::map_camera_t const no_cameras;
+  auto const& cameras = weighted ? options.cameras->cameras() : no_cameras;
+  parallel_for(0, num_tracks, [&](size_t begin, size_t end)
   {
-    auto const lmid = static_cast<vital::landmark_id_t>(track->id());
-    auto lmi = colored_landmarks.find(lmid);
-    if (lmi != no_such_landmark)
+    for (size_t t = begin; t < end; ++t)
     {
-      int ra = 0, ga = 0, ba = 0, k = 0; // accumulators
-      for (auto const& ts : *track)
+      if (track_lm[t] == no_landmark)
+      {
+        continue;
+      }
+      auto const& X = lm_iters[track_lm[t]]->second->loc();
+      size_t k = obs_offsets[t];
+      for (auto const& ts : *all_tracks[t])
       {
-        auto fts = std::dynamic_pointer_cast<vital::feature_track_state>(ts);
-        if( !fts )
+        auto const fts = dynamic_cast<vital::feature_track_state*>(ts.get());
+        if (!fts || !fts->feature)
         {
           continue;
         }
-        auto const& color = fts->feature->color();
-        ra += color.r;
-        ga += color.g;
-        ba += color.b;
+        auto const& loc = fts->feature->loc();
+        obs_frames[k] = fts->frame();
+        obs_locs[2 * k] = loc[0];
+        obs_locs[2 * k + 1] = loc[1];
+        obs_colors[k] = fts->feature->color();
+        if (weighted)
+        {
+          auto const ci = cameras.find(fts->frame());
+          auto const cam = (ci == cameras.end()) ? nullptr :
+            dynamic_cast<vital::camera_perspective const*>(ci->second.get());
+          if (cam)
+          {
+            double const dist = (X - cam->center()).norm();
+            obs_weights[k] = dist > 0.0 ? static_cast<float>(1.0 / dist)
+                                        : 1.0f;
+          }
+        }
         ++k;
       }
+    }
+  }, 256);
 
-      if (k)
+  // optionally resample the observations from the images, one frame at a time
+  if (options.images && num_obs > 0)
+  {
+    std::vector<size_t> order(num_obs);
+    for (size_t k = 0; k < num_obs; ++k)
+    {
+      order[k] = k;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+      return obs_frames[a] < obs_frames[b];
+    });
+
+    std::vector<double> locs;
+    std::vector<vital::rgb_color> colors;
+    for (size_t b = 0; b < num_obs;)
+    {
+      auto const frame = obs_frames[order[b]];
+      size_t e = b;
+      while (e < num_obs && obs_frames[order[e]] == frame)
       {
-        auto const r = static_cast<unsigned char>(ra / k);
-        auto const g = static_cast<unsigned char>(ga / k);
-        auto const b = static_cast<unsigned char>(ba / k);
+        ++e;
+      }
 
-        auto lm = std::make_shared<kwiver::vital::landmark_d>(*(lmi->second));
-        lm->set_color({r, g, b});
-        lmi->second = lm;
+      auto const image = options.images(frame);
+      if (image)
+      {
+        locs.resize(2 * (e - b));
+        colors.resize(e - b);
+        for (size_t k = b; k < e; ++k)
+        {
+          locs[2 * (k - b)] = obs_locs[2 * order[k]];
+          locs[2 * (k - b) + 1] = obs_locs[2 * order[k] + 1];
+        }
+        sample_image_colors(image->get_image(), locs.data(), e - b,
+                            colors.data());
+        for (size_t k = b; k < e; ++k)
+        {
+          obs_colors[order[k]] = colors[k - b];
+        }
       }
+      b = e;
+    }
+  }
+
+  // combine the observations of each landmark
+  std::vector<vital::rgb_color> lm_colors(lm_ids.size());
+  std::vector<char> lm_colored(lm_ids.size(), 0);
+  parallel_for(0, num_tracks, [&](size_t begin, size_t end)
+  {
+    std::vector<unsigned char> channel;
+    for (size_t t = begin; t < end; ++t)
+    {
+      size_t const ob = obs_offsets[t];
+      size_t const oe = obs_offsets[t + 1];
+      if (track_lm[t] == no_landmark || ob == oe)
+      {
+        continue;
+      }
+
+      unsigned char rgb[3];
+      if (options.mode == landmark_color_options::MEDIAN)
+      {
+        size_t const mid = (oe - ob) / 2;
+        for (int c = 0; c < 3; ++c)
+        {
+          channel.clear();
+          for (size_t k = ob; k < oe; ++k)
+          {
+            auto const& color = obs_colors[k];
+            channel.push_back(c == 0 ? color.r : c == 1 ? color.g : color.b);
+          }
+          std::nth_element(channel.begin(), channel.begin() + mid,
+                           channel.end());
+          rgb[c] = channel[mid];
+        }
+      }
+      else if (weighted)
+      {
+        double ra = 0.0, ga = 0.0, ba = 0.0, wa = 0.0; // accumulators
+        for (size_t k = ob; k < oe; ++k)
+        {
+          auto const& color = obs_colors[k];
+          double const w = obs_weights[k];
+          ra += w * color.r;
+          ga += w * color.g;
+          ba += w * color.b;
+          wa += w;
+        }
+        rgb[0] = static_cast<unsigned char>(ra / wa + 0.5);
+        rgb[1] = static_cast<unsigned char>(ga / wa + 0.5);
+        rgb[2] = static_cast<unsigned char>(ba / wa + 0.5);
+      }
+      else
+      {
+        size_t ra = 0, ga = 0, ba = 0; // accumulators
+        for (size_t k = ob; k < oe; ++k)
+        {
+          auto const& color = obs_colors[k];
+          ra += color.r;
+          ga += color.g;
+          ba += color.b;
+        }
+        size_t const n = oe - ob;
+        rgb[0] = static_cast<unsigned char>(ra / n);
+        rgb[1] = static_cast<unsigned char>(ga / n);
+        rgb[2] = static_cast<unsigned char>(ba / n);
+      }
+
+      // each track ID is unique, so no other thread writes this landmark
+      size_t const i = track_lm[t];
+      lm_colors[i] = vital::rgb_color(rgb[0], rgb[1], rgb[2]);
+      lm_colored[i] = 1;
+    }
+  }, 256);
+
+  // only copy the landmarks whose color changed
+  for (size_t i = 0; i < lm_ids.size(); ++i)
+  {
+    auto& lm_ptr = lm_iters[i]->second;
+    if (!lm_colored[i] || lm_ptr->color() == lm_colors[i])
+    {
+      continue;
     }
+    auto lm = std::make_shared<kwiver::vital::landmark_d>(*lm_ptr);
+    lm->set_color(lm_colors[i]);
+    lm_ptr = lm;
   }
 
   return std::make_shared<kwiver::vital::simple_landmark_map>(colored_landmarks);
@@ -38,35 +38,62 @@
 
 #include <maptk/maptk_export.h>
 
+#include <vital/types/camera_map.h>
 #include <vital/types/feature_set.h>
 #include <vital/types/image_container.h>
 #include <vital/types/landmark_map.h>
 #include <vital/types/feature_track_set.h>
 
+#include <functional>
+
 
 namespace kwiver {
 namespace maptk {
 
+/// Sample image colors at many locations with bilinear interpolation
+/**
+ * This function samples an 8-bit image at a flat array of (x, y) locations,
+ * with pixel centers at integer coordinates and locations clamped to the
+ * image.  Images with fewer than three planes are sampled as gray.  Large
+ * batches are sampled in parallel unless \p parallel is false, which callers
+ * running in a vital thread pool task must pass (see parallel_for).
+ *
+ *  \param [in] image the 8-bit image from which to take colors
+ *  \param [in] locations \p num_locations (x, y) pairs
+ *  \param [in] num_locations the number of locations to sample
+ *  \param [out] colors \p num_locations colors to fill in
+ *  \param [in] parallel whether to split large batches across threads
+ */
+MAPTK_EXPORT
+void sample_image_colors(
+  vital::image const& image,
+  double const* locations, size_t num_locations,
+  vital::rgb_color* colors, bool parallel = true);
+
 /// Extract feature colors from a frame image
 /*
  * This function extracts the feature colors from a supplied frame image and
- * applies them to all features in a feature set by sampling the image at each
- * feature's location.
+ * applies them to all features in a feature set by bilinear sampling of the
+ * image at each feature's location.
  *
  *  \param [in] features a set of features for which to assign colors
  *  \param [in] image the image from which to take colors
+ *  \param [in] parallel whether to sample in parallel; pass false when
+ *                       calling from a vital thread pool task
  *  \return a feature set with updated features
  */
 MAPTK_EXPORT
 vital::feature_set_sptr extract_feature_colors(
   vital::feature_set const& features,
-  vital::image_container const& image);
+  vital::image_container const& image,
+  bool parallel = true);
 
 /// Extract feature colors from a frame image
 /**
  * This function extracts the feature colors from a supplied frame image and
  * applies them to all features in the input track set with the same frame
- * number.
+ * number.  Features which are not shared with any other owner are updated in
+ * place; others are replaced by colored copies.
  *
  *  \param [in] tracks a set of feature tracks in which to colorize feature points
  *  \param [in] image the image from which to take colors
@@ -93,6 +120,52 @@ vital::landmark_map_sptr compute_landmark_colors(
   vital::landmark_map const& landmarks,
   vital::feature_track_set const& tracks);
 
+/// Options controlling how landmark colors are computed
+struct landmark_color_options
+{
+  /// How the colors of the observations of a landmark are combined
+  enum combine_mode
+  {
+    /// Average of the observation colors
+    MEAN,
+    /// Per channel median of the observation colors, robust to occlusions
+    MEDIAN,
+    /// Average weighted by inverse distance to the observing camera, so that
+    /// closer, higher resolution views count more
+    WEIGHTED
+  };
+
+  combine_mode mode = MEAN;
+
+  /// Cameras used to weight observations in WEIGHTED mode; observations
+  /// without a camera get unit weight
+  vital::camera_map_sptr cameras;
+
+  /// If set, called with increasing frame numbers to get the image from
+  /// which to sample the observations of that frame, instead of using the
+  /// colors stored in the features.  Frames for which it returns null keep
+  /// the feature colors.
+  std::function<vital::image_container_sptr(vital::frame_id_t)> images;
+};
+
+/// Compute colors for landmarks in parallel
+/**
+ * This function computes landmark colors from the colors of all associated
+ * feature points, combined as selected by \p options.  Tracks are split
+ * across threads and each landmark is colored once; landmarks whose color
+ * does not change are shared with the input rather than copied.
+ *
+ *  \param [in] landmarks a set of landmarks to be colored
+ *  \param [in] tracks feature tracks to be used for computing landmark colors
+ *  \param [in] options how to sample and combine the observation colors
+ *  \return a set of colored landmarks
+ */
+MAPTK_EXPORT
+vital::landmark_map_sptr compute_landmark_colors(
+  vital::landmark_map const& landmarks,
+  vital::feature_track_set const& tracks,
+  landmark_color_options const& options);
+
 } // end namespace maptk
 } // end namespace kwiver
 
@@ -34,14 +34,17 @@
  */
 
 #include "geo_reference_points_io.h"
+#include <maptk/geodetic_conversion.h>
 #include <vital/exceptions.h>
-#include <vital/io/eigen_io.h>
 #include <vital/types/geodesy.h>
 #include <vital/logger/logger.h>
 
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
-#include <iomanip>
-#include <iostream>
+#include <sstream>
 #include <vector>
 
 
@@ -49,105 +52,388 @@
 namespace kwiver {
 namespace maptk {
 
+namespace {
 
-/// Load landmarks and feature tracks from reference points file
-void load_reference_file(vital::path_t const& reference_file,
-                         vital::local_geo_cs & lgcs,
-                         vital::landmark_map_sptr & ref_landmarks,
-                         vital::feature_track_set_sptr & ref_track_set)
-{
-  using namespace std;
+char const cache_signature[8] = { 'M', 'A', 'P', 'T', 'K', 'R', 'E', 'F' };
+uint32_t const cache_version = 1;
 
-  kwiver::vital::logger_handle_t logger( kwiver::vital::get_logger( "load_reference_file" ) );
+/// Hash the contents of a file with 64-bit FNV-1a
+uint64_t
+hash_contents(std::string const& contents)
+{
+  uint64_t h = 14695981039346656037ULL;
+  for (unsigned char const c : contents)
+  {
+    h = (h ^ c) * 1099511628211ULL;
+  }
+  return h;
+}
 
-  // Read in file, creating a landmark map and a vector of feature tracks, associated
-  // via IDs
-  std::ifstream input_stream(reference_file.c_str(), std::fstream::in);
-  if (!input_stream)
+/// Parser of the text of a reference points file, one line at a time
+class reference_parser
+{
+public:
+  reference_parser(vital::path_t const& path, char const* text)
+    : path_(path), p_(text), line_(0)
   {
-    throw vital::file_not_found_exception(reference_file, "Could not open reference points file!");
   }
 
-  // pre-allocated vars for loop
-  vital::landmark_id_t cur_id = 1;
-  vital::frame_id_t frm;
-  vital::vector_2d feat_loc;
-  vital::vector_3d vec(0,0,0);
+  /// Parse all lines into \p points
+  void parse(reference_points& points)
+  {
+    while (*p_)
+    {
+      ++line_;
+      skip_blanks();
+      if (at_line_end() || *p_ == '#')
+      {
+        skip_line();
+        continue;
+      }
 
-  // used to stream file lines into data types
-  std::istringstream ss;
+      vital::vector_3d loc;
+      for (int i = 0; i < 3; ++i)
+      {
+        if (!parse_double(loc[i]))
+        {
+          fail("expected longitude, latitude and altitude");
+        }
+      }
+      points.locations.push_back(loc);
 
-  vital::landmark_map::map_landmark_t reference_lms;
-  std::vector<vital::track_sptr> reference_tracks;
+      // while there's still input left on the line, read in track states
+      while (!at_line_end())
+      {
+        vital::frame_id_t frame;
+        vital::vector_2d pt;
+        if (!parse_frame(frame))
+        {
+          fail("expected a frame number");
+        }
+        if (!parse_double(pt[0]) || !parse_double(pt[1]))
+        {
+          fail("incomplete observation of frame " + std::to_string(frame));
+        }
+        points.frames.push_back(frame);
+        points.image_points.push_back(pt);
+      }
+      points.observation_offsets.push_back(points.frames.size());
+      skip_line();
+    }
+  }
 
-  // Mean position of all landmarks.
-  vital::vector_3d mean(0,0,0);
+private:
+  void skip_blanks()
+  {
+    while (*p_ == ' ' || *p_ == '\t' || *p_ == '\r')
+    {
+      ++p_;
+    }
+  }
 
-  // If the origin is invalid then use the reference points to compute a new origin
-  const bool set_lgcs_origin = lgcs.origin().is_empty();
-  int crs = lgcs.origin().crs();
+  bool at_line_end() const
+  {
+    return *p_ == '\n' || *p_ == '\0';
+  }
 
-  // TODO: put in try-catch around >>'s in case we have an ill-formatted file,
-  // or there's a parse error
-  LOG_INFO(logger, "Reading ground control points from file: " << reference_file);
-  for (std::string line; std::getline(input_stream, line);)
+  void skip_line()
+  {
+    while (!at_line_end())
+    {
+      ++p_;
+    }
+    if (*p_ == '\n')
+    {
+      ++p_;
+    }
+  }
+
+  /// Return true if \p end is the end of a token
+  bool token_ends_at(char const* end) const
   {
-    ss.clear();
-    ss.str(line);
+    return *end == ' ' || *end == '\t' || *end == '\r' ||
+           *end == '\n' || *end == '\0';
+  }
 
-    // input landmarks are given in lon/lat/alt format (ignoring alt for now)
-    ss >> vec;
+  /// Parse a number, which must not start on the next line
+  bool parse_double(double& value)
+  {
+    skip_blanks();
+    if (at_line_end())
+    {
+      return false;
+    }
+    char* end;
+    value = std::strtod(p_, &end);
+    if (end == p_ || !token_ends_at(end))
+    {
+      fail("invalid number \"" + token() + "\"");
+    }
+    p_ = end;
+    skip_blanks();
+    return true;
+  }
+
+  /// Parse an integer frame number, which must not start on the next line
+  bool parse_frame(vital::frame_id_t& frame)
+  {
+    skip_blanks();
+    if (at_line_end())
+    {
+      return false;
+    }
+    char* end;
+    errno = 0;
+    long long const value = std::strtoll(p_, &end, 10);
+    if (end == p_ || !token_ends_at(end) || errno == ERANGE)
+    {
+      fail("invalid frame number \"" + token() + "\"");
+    }
+    frame = static_cast<vital::frame_id_t>(value);
+    p_ = end;
+    skip_blanks();
+    return true;
+  }
 
-    vital::vector_2d lon_lat(vec.x(), vec.y());
-    vital::geo_point gp(lon_lat, vital::SRID::lat_lon_WGS84);
-    if ( lgcs.origin().is_empty() )
+  /// Return the token at the current position, for error messages
+  std::string token() const
+  {
+    char const* end = p_;
+    while (!token_ends_at(end))
     {
-      auto zone = vital::utm_ups_zone( lon_lat );
-      crs = (zone.north ? vital::SRID::UTM_WGS84_north : vital::SRID::UTM_WGS84_south) + zone.number;
-      LOG_DEBUG(logger, "lgcs origin zone: " << zone.number );
-      lgcs.set_origin( vital::geo_point( gp.location( crs ), crs ) );
+      ++end;
     }
-    vital::vector_3d utm = gp.location(crs);
+    return std::string(p_, end);
+  }
 
-    vec[0] = utm.x();
-    vec[1] = utm.y();
-    mean += vec;
+  [[noreturn]] void fail(std::string const& message) const
+  {
+    std::ostringstream ss;
+    ss << path_ << ":" << line_ << ": " << message;
+    throw vital::invalid_data(ss.str());
+  }
 
-    reference_lms[cur_id] = vital::landmark_sptr(new vital::landmark_d(vec));
+  vital::path_t const& path_;
+  char const* p_;
+  size_t line_;
+};
 
-    // while there's still input left, read in track states
-    vital::track_sptr lm_track = vital::track::create();
-    lm_track->set_id(static_cast<vital::track_id_t>(cur_id));
-    while (ss.peek() != std::char_traits<char>::eof())
+/// Write an array of trivially copyable values to a binary stream
+template <typename T>
+void
+write_array(std::ostream& stream, std::vector<T> const& values)
+{
+  stream.write(reinterpret_cast<char const*>(values.data()),
+               static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+/// Read an array of trivially copyable values from a binary stream
+template <typename T>
+bool
+read_array(std::istream& stream, std::vector<T>& values, uint64_t count)
+{
+  values.resize(static_cast<size_t>(count));
+  return !!stream.read(reinterpret_cast<char*>(values.data()),
+                       static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+/// Load reference points from the cache if it matches the hash
+bool
+read_cache(vital::path_t const& cache_file, uint64_t hash,
+           reference_points& points)
+{
+  std::ifstream stream(cache_file.c_str(), std::ios::in | std::ios::binary);
+  if (!stream)
+  {
+    return false;
+  }
+
+  char sig[sizeof(cache_signature)];
+  uint32_t version = 0;
+  uint64_t cached_hash = 0, num_points = 0, num_obs = 0;
+  stream.read(sig, sizeof(sig));
+  stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+  stream.read(reinterpret_cast<char*>(&cached_hash), sizeof(cached_hash));
+  stream.read(reinterpret_cast<char*>(&num_points), sizeof(num_points));
+  stream.read(reinterpret_cast<char*>(&num_obs), sizeof(num_obs));
+  if (!stream || std::memcmp(sig, cache_signature, sizeof(sig)) != 0 ||
+      version != cache_version || cached_hash != hash)
+  {
+    return false;
+  }
+
+  reference_points cached;
+  if (!read_array(stream, cached.locations, num_points) ||
+      !read_array(stream, cached.observation_offsets, num_points + 1) ||
+      !read_array(stream, cached.frames, num_obs) ||
+      !read_array(stream, cached.image_points, num_obs) ||
+      cached.observation_offsets.back() != num_obs)
+  {
+    return false;
+  }
+  points = std::move(cached);
+  return true;
+}
+
+/// Write reference points to the cache, returning false on failure
+bool
+write_cache(vital::path_t const& cache_file, uint64_t hash,
+            reference_points const& points)
+{
+  std::ofstream stream(cache_file.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+  uint64_t const num_points = points.locations.size();
+  uint64_t const num_obs = points.frames.size();
+  stream.write(cache_signature, sizeof(cache_signature));
+  stream.write(reinterpret_cast<char const*>(&cache_version),
+               sizeof(cache_version));
+  stream.write(reinterpret_cast<char const*>(&hash), sizeof(hash));
+  stream.write(reinterpret_cast<char const*>(&num_points), sizeof(num_points));
+  stream.write(reinterpret_cast<char const*>(&num_obs), sizeof(num_obs));
+  write_array(stream, points.locations);
+  write_array(stream, points.observation_offsets);
+  write_array(stream, points.frames);
+  write_array(stream, points.image_points);
+  stream.close();
+  return !stream.fail();
+}
+
+}
+
+
+/// Read the points and observations of a reference points file
+reference_points
+read_reference_points(vital::path_t const& reference_file,
+                      vital::path_t const& cache_file)
+{
+  kwiver::vital::logger_handle_t logger( kwiver::vital::get_logger( "read_reference_points" ) );
+
+  // read the whole file at once; parsing from memory is much faster than
+  // streaming each line through an istringstream
+  std::ifstream input_stream(reference_file.c_str(),
+                             std::ios::in | std::ios::binary);
+  if (!input_stream)
+  {
+    throw vital::file_not_found_exception(reference_file, "Could not open reference points file!");
+  }
+  std::ostringstream contents;
+  contents << input_stream.rdbuf();
+  std::string const text = contents.str();
+
+  reference_points points;
+  uint64_t hash = 0;
+  if (!cache_file.empty())
+  {
+    hash = hash_contents(text);
+    if (read_cache(cache_file, hash, points))
     {
-      ss >> frm;
-      ss >> feat_loc;
-      auto fts = std::make_shared<vital::feature_track_state>(frm,
-                       vital::feature_sptr(new vital::feature_d(feat_loc)),
-                       vital::descriptor_sptr());
-      lm_track->append(fts);
+      LOG_DEBUG(logger, "Loaded reference points from cache: " << cache_file);
+      return points;
     }
-    reference_tracks.push_back(lm_track);
+  }
 
-    ++cur_id;
+  reference_parser(reference_file, text.c_str()).parse(points);
+
+  if (!cache_file.empty() && !write_cache(cache_file, hash, points))
+  {
+    LOG_WARN(logger, "Could not write reference points cache: " << cache_file);
   }
-  LOG_INFO(logger, "Loaded "<< reference_tracks.size() <<" ground control points");
+  return points;
+}
+
+
+/// Load landmarks and feature tracks from reference points file
+void load_reference_file(vital::path_t const& reference_file,
+                         vital::local_geo_cs & lgcs,
+                         vital::landmark_map_sptr & ref_landmarks,
+                         vital::feature_track_set_sptr & ref_track_set,
+                         vital::path_t const& cache_file)
+{
+  kwiver::vital::logger_handle_t logger( kwiver::vital::get_logger( "load_reference_file" ) );
+
+  LOG_INFO(logger, "Reading ground control points from file: " << reference_file);
+  reference_points const points =
+    read_reference_points(reference_file, cache_file);
+  size_t const num_points = points.size();
+
+  // If the origin is invalid then use the reference points to compute a new
+  // origin, in the UTM zone of the first point
+  const bool set_lgcs_origin = lgcs.origin().is_empty();
+  int crs = lgcs.origin().crs();
+  if ( set_lgcs_origin && num_points > 0 )
+  {
+    auto const& first = points.locations.front();
+    auto zone = vital::utm_ups_zone( vital::vector_2d(first.x(), first.y()) );
+    crs = (zone.north ? vital::SRID::UTM_WGS84_north : vital::SRID::UTM_WGS84_south) + zone.number;
+    LOG_DEBUG(logger, "lgcs origin zone: " << zone.number );
+  }
+
+  // input landmarks are given in lon/lat/alt format; convert the horizontal
+  // position and keep the altitude, all at once when the CRS is UTM
+  std::vector<vital::vector_3d> utm(points.locations);
+  auto const proj = utm_projection::from_crs(crs);
+  if (proj && num_points > 0)
+  {
+    proj->forward(utm.front().data(), num_points, utm.front().data());
+  }
+  else if (!proj)
+  {
+    for (auto& loc : utm)
+    {
+      vital::geo_point gp(vital::vector_2d(loc.x(), loc.y()),
+                          vital::SRID::lat_lon_WGS84);
+      vital::vector_3d const xy = gp.location(crs);
+      loc = vital::vector_3d(xy.x(), xy.y(), loc.z());
+    }
+  }
+  vital::vector_3d mean(0,0,0);
+  for (auto const& loc : utm)
+  {
+    mean += loc;
+  }
+  LOG_INFO(logger, "Loaded "<< num_points <<" ground control points");
 
   if (set_lgcs_origin)
   {
-    // Initialize lgcs center
-    mean /= static_cast<double>(reference_lms.size());
-    lgcs.set_origin( vital::geo_point( mean, crs ) );
-    LOG_DEBUG(logger, "mean position (lgcs origin): " << mean.transpose());
+    if (num_points > 0)
+    {
+      // Initialize lgcs center
+      mean /= static_cast<double>(num_points);
+      lgcs.set_origin( vital::geo_point( mean, crs ) );
+      LOG_DEBUG(logger, "mean position (lgcs origin): " << mean.transpose());
+    }
+    else
+    {
+      LOG_WARN(logger, "No reference points to set the lgcs origin from");
+    }
   }
 
-  // Scan through reference landmarks, adjusting their location by the lgcs
-  // origin.
+  // Create the landmarks in local coordinates and their tracks, associated
+  // via IDs
   LOG_INFO(logger, "transforming ground control points to local coordinates");
-  for(vital::landmark_map::map_landmark_t::value_type & p : reference_lms)
+  vital::vector_3d const origin =
+    num_points > 0 ? lgcs.origin().location() : vital::vector_3d(0,0,0);
+  vital::landmark_map::map_landmark_t reference_lms;
+  std::vector<vital::track_sptr> reference_tracks;
+  reference_tracks.reserve(num_points);
+  for (size_t i = 0; i < num_points; ++i)
   {
-    auto loc = p.second->loc() - lgcs.origin().location();
-    dynamic_cast<vital::landmark_d*>(p.second.get())->set_loc(loc);
+    auto const cur_id = static_cast<vital::landmark_id_t>(i + 1);
+    reference_lms.emplace_hint(
+      reference_lms.end(), cur_id,
+      std::make_shared<vital::landmark_d>(utm[i] - origin));
+
+    vital::track_sptr lm_track = vital::track::create();
+    lm_track->set_id(static_cast<vital::track_id_t>(cur_id));
+    for (size_t k = points.observation_offsets[i];
+         k < points.observation_offsets[i + 1]; ++k)
+    {
+      auto fts = std::make_shared<vital::feature_track_state>(points.frames[k],
+                       std::make_shared<vital::feature_d>(points.image_points[k]),
+                       vital::descriptor_sptr());
+      lm_track->append(fts);
+    }
+    reference_tracks.push_back(lm_track);
   }
 
   ref_landmarks = std::make_shared<vital::simple_landmark_map>(reference_lms);
@@ -46,11 +46,56 @@
 #include <vital/types/feature_track_set.h>
 #include <vital/vital_types.h>
 
+#include <vector>
+
 
 namespace kwiver {
 namespace maptk {
 
 
+/// Reference points as read from a reference points file
+/**
+ * The points and their observations are stored in flat arrays; the
+ * observations of point \c i are those in the range
+ * [\c observation_offsets[i], \c observation_offsets[i+1]).
+ */
+struct reference_points
+{
+  /// Geographic location (longitude, latitude, altitude) of each point
+  std::vector<vital::vector_3d> locations;
+  /// Index of the first observation of each point, plus the total count
+  std::vector<size_t> observation_offsets = std::vector<size_t>(1, 0);
+  /// Frame number of each observation
+  std::vector<vital::frame_id_t> frames;
+  /// Image location of each observation
+  std::vector<vital::vector_2d> image_points;
+
+  /// Return the number of points
+  size_t size() const { return locations.size(); }
+};
+
+
+/// Read the points and observations of a reference points file
+/**
+ * Parses the file format described for load_reference_file.  Blank lines and
+ * lines starting with '#' are skipped.
+ *
+ * If \p cache_file is not empty, it is used as a binary cache of the parsed
+ * result keyed by a hash of the file contents: if it holds the result for
+ * the current contents it is loaded instead of parsing the text, otherwise
+ * the text is parsed and the cache is (re)written.  Failure to write the
+ * cache is not an error.
+ *
+ * \throws vital::file_not_found_exception if the file cannot be opened
+ * \throws vital::invalid_data if a line is malformed, with the file name and
+ *         line number in the message
+ */
+MAPTK_EXPORT
+reference_points
+read_reference_points(vital::path_t const& reference_file,
+                      vital::path_t const& cache_file = "");
+
+
 /// Load landmarks and feature tracks from reference points file
 /**
  * Initializes and uses a local_geo_cs object given to transform reference
@@ -71,13 +116,15 @@ namespace maptk {
  *
  * Landmark Z position, or altitude, should be given in meters.
  *
+ * See read_reference_points for the use of \p cache_file.
  */
 MAPTK_EXPORT
 void
 load_reference_file(vital::path_t const& reference_file,
                     vital::local_geo_cs & lgcs,
                     vital::landmark_map_sptr & ref_landmarks,
-                    vital::feature_track_set_sptr & ref_track_set);
+                    vital::feature_track_set_sptr & ref_track_set,
+                    vital::path_t const& cache_file = "");
 
 
 } // end namespace maptk
@@ -0,0 +1,322 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of batched conversion between geodetic and local
+ *        coordinates
+ */
+
+#include "geodetic_conversion.h"
+
+#include <maptk/parallel_for.h>
+
+#include <vital/exceptions.h>
+#include <vital/math_constants.h>
+#include <vital/types/geodesy.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+// WGS84 ellipsoid and UTM constants
+double const wgs84_a = 6378137.0;
+double const wgs84_f = 1.0 / 298.257223563;
+double const utm_k0 = 0.9996;
+double const utm_false_easting = 500000.0;
+double const utm_south_false_northing = 10000000.0;
+
+double const third_flattening = wgs84_f / (2.0 - wgs84_f);
+double const eccentricity = std::sqrt(wgs84_f * (2.0 - wgs84_f));
+
+/// Return k0 times the radius of the rectifying sphere
+double
+scaled_rectifying_radius()
+{
+  double const n2 = third_flattening * third_flattening;
+  return utm_k0 * wgs84_a / (1.0 + third_flattening) *
+         (1.0 + n2 / 4.0 + n2 * n2 / 64.0 + n2 * n2 * n2 / 256.0);
+}
+
+double const k0_A = scaled_rectifying_radius();
+
+/// Return the conformal latitude tangent for the geodetic latitude tangent
+inline double
+conformal_tangent(double tau)
+{
+  double const sigma =
+    std::sinh(eccentricity * std::atanh(eccentricity * tau /
+                                        std::sqrt(1.0 + tau * tau)));
+  return tau * std::sqrt(1.0 + sigma * sigma) -
+         sigma * std::sqrt(1.0 + tau * tau);
+}
+
+/// Return the geodetic latitude tangent for the conformal latitude tangent
+inline double
+geodetic_tangent(double taup)
+{
+  // Newton's method converges to full precision in two or three steps
+  double const e2m = 1.0 - eccentricity * eccentricity;
+  double tau = taup / e2m;
+  for (int i = 0; i < 5; ++i)
+  {
+    double const taupa = conformal_tangent(tau);
+    double const dtau = (taup - taupa) * (1.0 + e2m * tau * tau) /
+      (e2m * std::sqrt(1.0 + tau * tau) * std::sqrt(1.0 + taupa * taupa));
+    tau += dtau;
+    if (!(std::fabs(dtau) >= 1e-14 * std::max(1.0, std::fabs(tau))))
+    {
+      break;
+    }
+  }
+  return tau;
+}
+
+/// Evaluate the Krüger series sum of c[j] sin(2 (j+1) (xi + i eta))
+/**
+ * Uses Clenshaw summation over the complex argument, so that the whole series
+ * costs one sine, cosine, and exponential rather than a sine, cosine,
+ * hyperbolic sine and hyperbolic cosine per term.  The complex arithmetic is
+ * written out to avoid the overhead of the checked std::complex product.
+ */
+inline void
+krueger_sum(double const* c, double xi, double eta, double& re, double& im)
+{
+  double const s = std::sin(2.0 * xi), co = std::cos(2.0 * xi);
+  double const e = std::exp(2.0 * eta), ei = 1.0 / e;
+  double const sh = 0.5 * (e - ei), ch = 0.5 * (e + ei);
+
+  // 2 cos(z) and sin(z) for z = 2 (xi + i eta)
+  double const ar = 2.0 * co * ch, ai = -2.0 * s * sh;
+  double const sr = s * ch, si = co * sh;
+
+  double b1r = 0.0, b1i = 0.0, b2r = 0.0, b2i = 0.0;
+  for (int j = 5; j >= 0; --j)
+  {
+    double const b0r = ar * b1r - ai * b1i - b2r + c[j];
+    double const b0i = ar * b1i + ai * b1r - b2i;
+    b2r = b1r; b2i = b1i;
+    b1r = b0r; b1i = b0i;
+  }
+  re = b1r * sr - b1i * si;
+  im = b1r * si + b1i * sr;
+}
+
+/// Return true if \p crs is a UTM WGS84 code, with its zone and hemisphere
+bool
+utm_zone_of_crs(int crs, int& zone, bool& north)
+{
+  if (crs > vital::SRID::UTM_WGS84_north &&
+      crs <= vital::SRID::UTM_WGS84_north + 60)
+  {
+    zone = crs - vital::SRID::UTM_WGS84_north;
+    north = true;
+    return true;
+  }
+  if (crs > vital::SRID::UTM_WGS84_south &&
+      crs <= vital::SRID::UTM_WGS84_south + 60)
+  {
+    zone = crs - vital::SRID::UTM_WGS84_south;
+    north = false;
+    return true;
+  }
+  return false;
+}
+
+}
+
+/// Set up the projection of UTM \p zone (1 to 60) of a hemisphere
+utm_projection
+::utm_projection(int zone, bool north)
+  : zone_(zone),
+    north_(north),
+    lon0_((6.0 * zone - 183.0) * vital::deg_to_rad),
+    false_northing_(north ? 0.0 : utm_south_false_northing)
+{
+  if (zone < 1 || zone > 60)
+  {
+    throw vital::invalid_value("UTM zone must be in [1, 60]");
+  }
+
+  // Krüger series coefficients in powers of the third flattening
+  double const n = third_flattening;
+  double const n2 = n * n, n3 = n2 * n, n4 = n3 * n, n5 = n4 * n, n6 = n5 * n;
+  alpha_[0] = n / 2 - 2 * n2 / 3 + 5 * n3 / 16 + 41 * n4 / 180
+            - 127 * n5 / 288 + 7891 * n6 / 37800;
+  alpha_[1] = 13 * n2 / 48 - 3 * n3 / 5 + 557 * n4 / 1440
+            + 281 * n5 / 630 - 1983433 * n6 / 1935360;
+  alpha_[2] = 61 * n3 / 240 - 103 * n4 / 140 + 15061 * n5 / 26880
+            + 167603 * n6 / 181440;
+  alpha_[3] = 49561 * n4 / 161280 - 179 * n5 / 168
+            + 6601661 * n6 / 7257600;
+  alpha_[4] = 34729 * n5 / 80640 - 3418889 * n6 / 1995840;
+  alpha_[5] = 212378941 * n6 / 319334400;
+
+  beta_[0] = n / 2 - 2 * n2 / 3 + 37 * n3 / 96 - n4 / 360
+           - 81 * n5 / 512 + 96199 * n6 / 604800;
+  beta_[1] = n2 / 48 + n3 / 15 - 437 * n4 / 1440 + 46 * n5 / 105
+           - 1118711 * n6 / 3870720;
+  beta_[2] = 17 * n3 / 480 - 37 * n4 / 840 - 209 * n5 / 4480
+           + 5569 * n6 / 90720;
+  beta_[3] = 4397 * n4 / 161280 - 11 * n5 / 504 - 830251 * n6 / 7257600;
+  beta_[4] = 4583 * n5 / 161280 - 108847 * n6 / 3991680;
+  beta_[5] = 20648693 * n6 / 638668800;
+}
+
+/// Return the projection of a UTM WGS84 EPSG code, or null if not UTM
+std::unique_ptr<utm_projection>
+utm_projection
+::from_crs(int crs)
+{
+  int zone;
+  bool north;
+  if (!utm_zone_of_crs(crs, zone, north))
+  {
+    return nullptr;
+  }
+  return std::unique_ptr<utm_projection>(new utm_projection(zone, north));
+}
+
+/// Return the EPSG code of this projection
+int
+utm_projection
+::crs() const
+{
+  return (north_ ? vital::SRID::UTM_WGS84_north
+                 : vital::SRID::UTM_WGS84_south) + zone_;
+}
+
+/// Project \p n geographic points into \p out, which may alias \p in
+void
+utm_projection
+::forward(double const* in, size_t n, double* out) const
+{
+  parallel_for(0, n, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      double const* p = in + 3 * i;
+      double const lambda = p[0] * vital::deg_to_rad - lon0_;
+      double const phi = p[1] * vital::deg_to_rad;
+      double const alt = p[2];
+
+      double const taup = conformal_tangent(std::tan(phi));
+      double const xip = std::atan2(taup, std::cos(lambda));
+      double const etap =
+        std::asinh(std::sin(lambda) / std::hypot(taup, std::cos(lambda)));
+
+      double dxi, deta;
+      krueger_sum(alpha_, xip, etap, dxi, deta);
+      double const xi = xip + dxi;
+      double const eta = etap + deta;
+
+      double* q = out + 3 * i;
+      q[0] = utm_false_easting + k0_A * eta;
+      q[1] = false_northing_ + k0_A * xi;
+      q[2] = alt;
+    }
+  }, 1024);
+}
+
+/// Unproject \p n projected points into \p out, which may alias \p in
+void
+utm_projection
+::inverse(double const* in, size_t n, double* out) const
+{
+  parallel_for(0, n, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      double const* p = in + 3 * i;
+      double const eta = (p[0] - utm_false_easting) / k0_A;
+      double const xi = (p[1] - false_northing_) / k0_A;
+      double const alt = p[2];
+
+      double dxi, deta;
+      krueger_sum(beta_, xi, eta, dxi, deta);
+      double const xip = xi - dxi;
+      double const etap = eta - deta;
+
+      double const s = std::sinh(etap);
+      double const c = std::cos(xip);
+      double const taup = std::sin(xip) / std::hypot(s, c);
+      double const lambda = std::atan2(s, c);
+
+      double* q = out + 3 * i;
+      q[0] = (lambda + lon0_) * vital::rad_to_deg;
+      q[1] = std::atan(geodetic_tangent(taup)) * vital::rad_to_deg;
+      q[2] = alt;
+    }
+  }, 1024);
+}
+
+/// Convert local coordinates of \p lgcs into geographic points
+void
+local_to_geographic(vital::local_geo_cs const& lgcs,
+                    double const* in, size_t n, double* out)
+{
+  auto const& origin = lgcs.origin();
+  int const crs = origin.crs();
+  vital::vector_3d const o = origin.location();
+  if (auto const proj = utm_projection::from_crs(crs))
+  {
+    parallel_for(0, n, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        out[3 * i + 0] = in[3 * i + 0] + o[0];
+        out[3 * i + 1] = in[3 * i + 1] + o[1];
+        out[3 * i + 2] = in[3 * i + 2] + o[2];
+      }
+    });
+    proj->inverse(out, n, out);
+    return;
+  }
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    vital::geo_point const gp(vital::vector_3d(in[3 * i] + o[0],
+                                               in[3 * i + 1] + o[1],
+                                               in[3 * i + 2] + o[2]),
+                              crs);
+    vital::vector_3d const loc = gp.location(vital::SRID::lat_lon_WGS84);
+    out[3 * i + 0] = loc[0];
+    out[3 * i + 1] = loc[1];
+    out[3 * i + 2] = loc[2];
+  }
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,104 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for batched conversion between geodetic and local coordinates
+ */
+
+#ifndef MAPTK_GEODETIC_CONVERSION_H_
+#define MAPTK_GEODETIC_CONVERSION_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/local_geo_cs.h>
+
+#include <memory>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// A WGS84 Universal Transverse Mercator projection of one zone
+/**
+ * The series coefficients of the projection are computed once on
+ * construction, so that converting many points only evaluates a few
+ * trigonometric functions per point.  The projection uses the sixth order
+ * Krüger series, which is accurate to well under a millimeter within a zone.
+ * Large batches are converted in parallel.
+ *
+ * Geographic points are (longitude, latitude, altitude) triples in degrees
+ * and meters; projected points are (easting, northing, altitude) triples in
+ * meters.  The altitude is passed through unchanged.
+ */
+class MAPTK_EXPORT utm_projection
+{
+public:
+  /// Set up the projection of UTM \p zone (1 to 60) of a hemisphere
+  utm_projection(int zone, bool north);
+
+  /// Return the projection of a UTM WGS84 EPSG code, or null if not UTM
+  static std::unique_ptr<utm_projection> from_crs(int crs);
+
+  /// Return the EPSG code of this projection
+  int crs() const;
+
+  /// Project \p n geographic points into \p out, which may alias \p in
+  void forward(double const* in, size_t n, double* out) const;
+
+  /// Unproject \p n projected points into \p out, which may alias \p in
+  void inverse(double const* in, size_t n, double* out) const;
+
+protected:
+  int zone_;
+  bool north_;
+  double lon0_;
+  double false_northing_;
+  double alpha_[6];
+  double beta_[6];
+};
+
+/// Convert local coordinates of \p lgcs into geographic points
+/**
+ * Converts \p n points in local coordinates relative to the origin of \p lgcs
+ * into (longitude, latitude, altitude) triples, in degrees and meters.  When
+ * the origin is in a UTM WGS84 system the whole batch is converted with a
+ * single utm_projection; otherwise each point is converted with
+ * vital::geo_point.  \p out may alias \p in.
+ */
+MAPTK_EXPORT
+void
+local_to_geographic(vital::local_geo_cs const& lgcs,
+                    double const* in, size_t n, double* out);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_GEODETIC_CONVERSION_H_
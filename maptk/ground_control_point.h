@@ -41,6 +41,8 @@
 #include <maptk/maptk_export.h>
 
 #include <vital/types/geo_point.h>
+#include <vital/types/vector.h>
+#include <vital/vital_types.h>
 
 #include <iostream>
 #include <map>
@@ -59,6 +61,9 @@ using ground_control_point_id_t = uint32_t;
 class MAPTK_EXPORT ground_control_point
 {
 public:
+  /// alias for the image observations of the point, by frame
+  using observation_map_t = std::map<frame_id_t, vector_2d>;
+
   /// Constructor
   ground_control_point();
   ground_control_point(vector_3d const& loc,
@@ -129,6 +134,21 @@ public:
   {
     name_ = name;
   }
+  /// Accessor for the image observations of the ground control point
+  observation_map_t const& observations() const
+  {
+    return observations_;
+  }
+  /// Set the image observations of the ground control point
+  void set_observations(observation_map_t const& observations)
+  {
+    observations_ = observations;
+  }
+  /// Set the image observation of the ground control point on one frame
+  void set_observation(frame_id_t frame, vector_2d const& loc)
+  {
+    observations_[frame] = loc;
+  }
 
 protected:
   vector_3d loc_{ 0.0, 0.0, 0.0 };
@@ -136,6 +156,7 @@ protected:
   double elevation_ = 0.0;
   std::string name_;
   bool geo_loc_user_provided_ = false;
+  observation_map_t observations_;
 };
 
 /// output stream operator for a ground control point
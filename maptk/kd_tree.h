@@ -0,0 +1,281 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for a static k-d tree over a flat array of points
+ */
+
+#ifndef MAPTK_KD_TREE_H_
+#define MAPTK_KD_TREE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// A static k-d tree over a flat array of points of dimension \p Dim
+/**
+ * The tree is built once from a flat array of points and answers nearest
+ * neighbor queries in O(log n) time and region queries in O(log n + k) time,
+ * where k is the number of points reported.  Points are identified by their
+ * index in the array given to build().  Each node keeps the bounding box of
+ * its points, so a region is described by a function classifying boxes,
+ * which allows regions such as view frustums that are not boxes.
+ */
+template <unsigned Dim>
+class kd_tree
+{
+public:
+  /// Result of classifying a box against a query region
+  enum region_test { OUTSIDE, INTERSECTS, INSIDE };
+
+  /// The index returned when no point is found
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /// Build the tree over \p n points stored as \p Dim values each
+  void build(double const* points, size_t n)
+  {
+    points_.assign(points, points + Dim * n);
+    index_.resize(n);
+    std::iota(index_.begin(), index_.end(), size_t(0));
+    nodes_.clear();
+    if (n > 0)
+    {
+      nodes_.reserve(2 * (n / leaf_size + 1));
+      build_node(0, n);
+    }
+  }
+
+  /// Remove all points
+  void clear()
+  {
+    points_.clear();
+    index_.clear();
+    nodes_.clear();
+  }
+
+  /// Return the number of points in the tree
+  size_t size() const { return index_.size(); }
+
+  /// Return a pointer to the \p Dim coordinates of point \p i
+  double const* point(size_t i) const { return points_.data() + Dim * i; }
+
+  /// Return the index of the point nearest to \p q within \p max_distance
+  /**
+   * Returns npos if no point is within \p max_distance.
+   */
+  size_t nearest(double const* q,
+                 double max_distance =
+                   std::numeric_limits<double>::infinity()) const
+  {
+    size_t best = npos;
+    double best_d2 = max_distance * max_distance;
+    if (!nodes_.empty())
+    {
+      nearest_node(0, q, best, best_d2);
+    }
+    return best;
+  }
+
+  /// Call \p visit with the index of every point in a region
+  /**
+   * \p classify is called as <code>classify(lo, hi)</code> with the corners
+   * of a node's bounding box and returns a region_test; \p contains is called
+   * as <code>contains(p)</code> for points of boxes which only intersect the
+   * region.
+   */
+  template <typename Classify, typename Contains, typename Visit>
+  void query(Classify const& classify, Contains const& contains,
+             Visit const& visit) const
+  {
+    if (!nodes_.empty())
+    {
+      query_node(0, classify, contains, visit);
+    }
+  }
+
+private:
+  static constexpr size_t leaf_size = 8;
+
+  struct node
+  {
+    double lo[Dim];
+    double hi[Dim];
+    size_t begin, end;
+    size_t left, right; // child node indices, zero for a leaf
+  };
+
+  double coord(size_t k, unsigned d) const
+  {
+    return points_[Dim * index_[k] + d];
+  }
+
+  size_t build_node(size_t begin, size_t end)
+  {
+    size_t const id = nodes_.size();
+    nodes_.push_back(node());
+    node n;
+    n.begin = begin;
+    n.end = end;
+    n.left = n.right = 0;
+    for (unsigned d = 0; d < Dim; ++d)
+    {
+      n.lo[d] = n.hi[d] = coord(begin, d);
+    }
+    for (size_t k = begin + 1; k < end; ++k)
+    {
+      for (unsigned d = 0; d < Dim; ++d)
+      {
+        n.lo[d] = std::min(n.lo[d], coord(k, d));
+        n.hi[d] = std::max(n.hi[d], coord(k, d));
+      }
+    }
+
+    if (end - begin > leaf_size)
+    {
+      // split at the median of the widest dimension
+      unsigned axis = 0;
+      for (unsigned d = 1; d < Dim; ++d)
+      {
+        if (n.hi[d] - n.lo[d] > n.hi[axis] - n.lo[axis])
+        {
+          axis = d;
+        }
+      }
+      size_t const mid = begin + (end - begin) / 2;
+      std::nth_element(index_.begin() + begin, index_.begin() + mid,
+                       index_.begin() + end,
+                       [this, axis](size_t a, size_t b)
+      {
+        return points_[Dim * a + axis] < points_[Dim * b + axis];
+      });
+      n.left = build_node(begin, mid);
+      n.right = build_node(mid, end);
+    }
+    nodes_[id] = n;
+    return id;
+  }
+
+  static double box_distance2(node const& n, double const* q)
+  {
+    double d2 = 0.0;
+    for (unsigned d = 0; d < Dim; ++d)
+    {
+      double const v = q[d] < n.lo[d] ? n.lo[d] - q[d] :
+                       q[d] > n.hi[d] ? q[d] - n.hi[d] : 0.0;
+      d2 += v * v;
+    }
+    return d2;
+  }
+
+  void nearest_node(size_t id, double const* q,
+                    size_t& best, double& best_d2) const
+  {
+    node const& n = nodes_[id];
+    if (box_distance2(n, q) > best_d2)
+    {
+      return;
+    }
+    if (!n.left)
+    {
+      for (size_t k = n.begin; k < n.end; ++k)
+      {
+        double d2 = 0.0;
+        for (unsigned d = 0; d < Dim; ++d)
+        {
+          double const v = coord(k, d) - q[d];
+          d2 += v * v;
+        }
+        if (d2 <= best_d2)
+        {
+          best_d2 = d2;
+          best = index_[k];
+        }
+      }
+      return;
+    }
+
+    // descend into the nearer child first to shrink the search radius
+    size_t first = n.left, second = n.right;
+    if (box_distance2(nodes_[second], q) < box_distance2(nodes_[first], q))
+    {
+      std::swap(first, second);
+    }
+    nearest_node(first, q, best, best_d2);
+    nearest_node(second, q, best, best_d2);
+  }
+
+  template <typename Classify, typename Contains, typename Visit>
+  void query_node(size_t id, Classify const& classify,
+                  Contains const& contains, Visit const& visit) const
+  {
+    node const& n = nodes_[id];
+    region_test const test = classify(n.lo, n.hi);
+    if (test == OUTSIDE)
+    {
+      return;
+    }
+    if (test == INSIDE || !n.left)
+    {
+      for (size_t k = n.begin; k < n.end; ++k)
+      {
+        size_t const i = index_[k];
+        if (test == INSIDE || contains(point(i)))
+        {
+          visit(i);
+        }
+      }
+      return;
+    }
+    query_node(n.left, classify, contains, visit);
+    query_node(n.right, classify, contains, visit);
+  }
+
+  std::vector<double> points_;
+  std::vector<size_t> index_;
+  std::vector<node> nodes_;
+};
+
+template <unsigned Dim>
+constexpr size_t kd_tree<Dim>::npos;
+
+template <unsigned Dim>
+constexpr size_t kd_tree<Dim>::leaf_size;
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_KD_TREE_H_
@@ -0,0 +1,203 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of coverage-aware keyframe selection
+ */
+
+#include "keyframe_selection.h"
+
+#include <maptk/match_matrix.h>
+
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+/// The weight of a track already seen by \p count selected frames
+double
+coverage_weight(unsigned count)
+{
+  return count < 2 ? 1.0 : (count == 2 ? 0.5 : 0.0);
+}
+
+}
+
+/// Select a budget of keyframes which best cover the tracks
+std::set<vital::frame_id_t>
+select_keyframes(vital::track_set const& tracks,
+                 std::vector<vital::frame_id_t> const& frames,
+                 size_t budget)
+{
+  std::set<vital::frame_id_t> selected;
+  if (frames.empty() || budget == 0)
+  {
+    return selected;
+  }
+
+  std::vector<vital::frame_id_t> sorted_frames = frames;
+  std::sort(sorted_frames.begin(), sorted_frames.end());
+  sorted_frames.erase(std::unique(sorted_frames.begin(), sorted_frames.end()),
+                      sorted_frames.end());
+  auto const n = sorted_frames.size();
+  if (budget >= n)
+  {
+    selected.insert(sorted_frames.begin(), sorted_frames.end());
+    return selected;
+  }
+
+  std::unordered_map<vital::frame_id_t, size_t> frame_index;
+  for (size_t i = 0; i < n; ++i)
+  {
+    frame_index.emplace(sorted_frames[i], i);
+  }
+
+  // Index the tracks observed by each frame; tracks seen by only one of the
+  // frames can never be triangulated and are ignored
+  std::vector<std::vector<size_t>> frame_tracks(n);
+  std::vector<std::vector<size_t>> track_frames;
+  for (auto const& t : tracks.tracks())
+  {
+    std::vector<size_t> observers;
+    for (auto const& ts : *t)
+    {
+      auto const i = frame_index.find(ts->frame());
+      if (i != frame_index.end())
+      {
+        observers.push_back(i->second);
+      }
+    }
+    if (observers.size() < 2)
+    {
+      continue;
+    }
+    for (auto const i : observers)
+    {
+      frame_tracks[i].push_back(track_frames.size());
+    }
+    track_frames.push_back(std::move(observers));
+  }
+
+  match_matrix_accumulator accumulator;
+  accumulator.rebuild(tracks);
+  Eigen::SparseMatrix<unsigned int> const mm =
+    accumulator.matrix(sorted_frames);
+
+  std::vector<unsigned> coverage(track_frames.size(), 0);
+  std::vector<double> max_shared(n, 0.0);
+  std::vector<bool> is_selected(n, false);
+
+  auto const gain = [&](size_t i){
+    auto const& ft = frame_tracks[i];
+    if (ft.empty())
+    {
+      return 0.0;
+    }
+    double g = 0.0;
+    for (auto const t : ft)
+    {
+      g += coverage_weight(coverage[t]);
+    }
+    return g * (1.0 - max_shared[i]);
+  };
+
+  auto const select = [&](size_t i){
+    is_selected[i] = true;
+    selected.insert(sorted_frames[i]);
+    for (auto const t : frame_tracks[i])
+    {
+      ++coverage[t];
+    }
+    for (Eigen::SparseMatrix<unsigned int>::InnerIterator it(
+           mm, static_cast<int>(i)); it; ++it)
+    {
+      auto const j = static_cast<size_t>(it.row());
+      auto const total = mm.coeff(it.row(), it.row());
+      if (j != i && total > 0)
+      {
+        max_shared[j] = std::max(max_shared[j],
+          static_cast<double>(it.value()) / static_cast<double>(total));
+      }
+    }
+  };
+
+  // Always keep both ends of the sequence, so the selection spans all of it
+  select(0);
+  if (budget > 1)
+  {
+    select(n - 1);
+  }
+
+  // Lazy greedy selection; the gain of a frame can only decrease as frames
+  // are selected, so a stale gain is an upper bound and only the top of the
+  // queue needs to be re-evaluated
+  std::priority_queue<std::pair<double, size_t>> queue;
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (!is_selected[i])
+    {
+      queue.emplace(gain(i), i);
+    }
+  }
+  while (selected.size() < budget && !queue.empty())
+  {
+    auto const top = queue.top();
+    queue.pop();
+    if (top.first <= 0.0)
+    {
+      break;
+    }
+    auto const g = gain(top.second);
+    if (queue.empty() || g >= queue.top().first)
+    {
+      if (g <= 0.0)
+      {
+        break;
+      }
+      select(top.second);
+    }
+    else
+    {
+      queue.emplace(g, top.second);
+    }
+  }
+
+  return selected;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,76 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for coverage-aware keyframe selection
+ */
+
+#ifndef MAPTK_KEYFRAME_SELECTION_H_
+#define MAPTK_KEYFRAME_SELECTION_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/track_set.h>
+
+#include <set>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Select a budget of keyframes which best cover the tracks
+/**
+ * This function greedily selects frames from \p frames, starting with the
+ * first and last frame, by the gain each would add to the selection.  The
+ * gain of a frame counts its tracks which are seen by fewer than two selected
+ * frames (which could not yet be triangulated) at full weight, and tracks
+ * seen by exactly two selected frames at half weight.  The gain is scaled by
+ * a baseline term, one minus the largest fraction of the frame's tracks which
+ * are shared with any selected frame, so that frames adjacent to a keyframe
+ * are unlikely to be chosen.  Selection stops when \p budget frames are
+ * chosen or no frame adds any gain.
+ *
+ *  \param [in] tracks the tracks from which to compute coverage
+ *  \param [in] frames the frames from which to select
+ *  \param [in] budget the maximum number of frames to select
+ *  \return the selected frames
+ */
+MAPTK_EXPORT
+std::set<vital::frame_id_t>
+select_keyframes(vital::track_set const& tracks,
+                 std::vector<vital::frame_id_t> const& frames,
+                 size_t budget);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_KEYFRAME_SELECTION_H_
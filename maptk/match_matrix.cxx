@@ -0,0 +1,225 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of incrementally maintained match matrix
+ */
+
+#include "match_matrix.h"
+
+#include <algorithm>
+
+
+namespace kwiver {
+namespace maptk {
+
+
+/// Add the track states on a frame to the matrix
+void
+match_matrix_accumulator
+::update(vital::track_set const& tracks, vital::frame_id_t frame)
+{
+  auto const states = tracks.frame_states(frame);
+
+  // Loop closure may merge (and thereby remove) tracks.  The contributions
+  // of tracks which no longer exist can not be found from the new states,
+  // so fall back to a full rebuild when the number of tracks disagrees.
+  size_t new_tracks = 0;
+  for (auto const& ts : states)
+  {
+    auto const t = ts->track();
+    if (t && track_frames_.find(t->id()) == track_frames_.end())
+    {
+      ++new_tracks;
+    }
+  }
+  if (tracks.size() != track_frames_.size() + new_tracks)
+  {
+    this->rebuild(tracks);
+    return;
+  }
+
+  for (auto const& ts : states)
+  {
+    auto const t = ts->track();
+    if (!t)
+    {
+      continue;
+    }
+
+    auto& frames = track_frames_[t->id()];
+    if (t->size() == frames.size() + 1 && t->last_frame() == frame &&
+        (frames.empty() || frames.back() < frame))
+    {
+      // the common case, the track was extended by one state on this frame
+      for (auto const f : frames)
+      {
+        ++counts_[{ f, frame }];
+      }
+      ++counts_[{ frame, frame }];
+      frames.push_back(frame);
+    }
+    else if (t->size() != frames.size() ||
+             std::find(frames.begin(), frames.end(), frame) == frames.end())
+    {
+      // the track changed in some other way, so re-synchronize it
+      this->accumulate(frames, -1);
+      frames.clear();
+      for (auto const& s : *t)
+      {
+        frames.push_back(s->frame());
+      }
+      this->accumulate(frames, +1);
+    }
+  }
+}
+
+
+/// Recompute the matrix from scratch
+void
+match_matrix_accumulator
+::rebuild(vital::track_set const& tracks)
+{
+  this->clear();
+  for (auto const& t : tracks.tracks())
+  {
+    auto& frames = track_frames_[t->id()];
+    frames.reserve(t->size());
+    for (auto const& s : *t)
+    {
+      frames.push_back(s->frame());
+    }
+    this->accumulate(frames, +1);
+  }
+}
+
+
+/// Remove all accumulated counts
+void
+match_matrix_accumulator
+::clear()
+{
+  track_frames_.clear();
+  counts_.clear();
+}
+
+
+/// Return the number of frames with at least one track state
+size_t
+match_matrix_accumulator
+::num_frames() const
+{
+  size_t n = 0;
+  for (auto const& c : counts_)
+  {
+    if (c.first.first == c.first.second)
+    {
+      ++n;
+    }
+  }
+  return n;
+}
+
+
+/// Extract the match matrix
+Eigen::SparseMatrix<unsigned int>
+match_matrix_accumulator
+::matrix(std::vector<vital::frame_id_t>& frames) const
+{
+  // if no frames are specified then use all frames with track states
+  if (frames.empty())
+  {
+    for (auto const& c : counts_)
+    {
+      if (c.first.first == c.first.second)
+      {
+        frames.push_back(c.first.first);
+      }
+    }
+    std::sort(frames.begin(), frames.end());
+  }
+
+  // build a frame map for reverse lookup of matrix indices
+  std::unordered_map<vital::frame_id_t, int> frame_index;
+  frame_index.reserve(frames.size());
+  for (size_t i = 0; i < frames.size(); ++i)
+  {
+    frame_index[frames[i]] = static_cast<int>(i);
+  }
+
+  std::vector<Eigen::Triplet<unsigned int>> triplets;
+  triplets.reserve(2 * counts_.size());
+  for (auto const& c : counts_)
+  {
+    auto const i = frame_index.find(c.first.first);
+    auto const j = frame_index.find(c.first.second);
+    if (i == frame_index.end() || j == frame_index.end())
+    {
+      continue;
+    }
+    triplets.emplace_back(i->second, j->second, c.second);
+    if (i->second != j->second)
+    {
+      triplets.emplace_back(j->second, i->second, c.second);
+    }
+  }
+
+  auto const n = static_cast<int>(frames.size());
+  Eigen::SparseMatrix<unsigned int> mm(n, n);
+  mm.setFromTriplets(triplets.begin(), triplets.end());
+  return mm;
+}
+
+
+/// Add (or remove) the contribution of a track observed on a set of frames
+void
+match_matrix_accumulator
+::accumulate(std::vector<vital::frame_id_t> const& frames, int delta)
+{
+  for (size_t i = 0; i < frames.size(); ++i)
+  {
+    for (size_t j = i; j < frames.size(); ++j)
+    {
+      auto const key = std::make_pair(std::min(frames[i], frames[j]),
+                                      std::max(frames[i], frames[j]));
+      auto& count = counts_[key];
+      count = static_cast<unsigned int>(static_cast<int>(count) + delta);
+      if (count == 0)
+      {
+        counts_.erase(key);
+      }
+    }
+  }
+}
+
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,128 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for incrementally maintained match matrix
+ */
+
+#ifndef MAPTK_MATCH_MATRIX_H_
+#define MAPTK_MATCH_MATRIX_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/track_set.h>
+
+#include <Eigen/SparseCore>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// A sparse frame co-visibility (match) matrix kept up to date incrementally
+/**
+ * This class accumulates the same counts as \c kwiver::arrows::match_matrix,
+ * the number of tracks observed on both frame \em i and frame \em j, but
+ * does so as tracks are extended rather than over the whole track set at
+ * once.  Each call to update() only visits the track states on the new
+ * frame, so the cost of keeping the matrix current while tracking is
+ * proportional to the number of new states rather than the total.
+ *
+ * Tracks that are extended out of order, or merged by loop closure, are
+ * detected and re-synchronized.  The matrix can be extracted at any time
+ * with matrix().
+ */
+class MAPTK_EXPORT match_matrix_accumulator
+{
+public:
+  /// Add the track states on \p frame to the matrix
+  /**
+   *  \param [in] tracks the track set which has been extended to \p frame
+   *  \param [in] frame the frame number of the newly tracked frame
+   */
+  void update(vital::track_set const& tracks, vital::frame_id_t frame);
+
+  /// Recompute the matrix from scratch using all tracks in \p tracks
+  void rebuild(vital::track_set const& tracks);
+
+  /// Remove all accumulated counts
+  void clear();
+
+  /// Return the number of frames with at least one track state
+  size_t num_frames() const;
+
+  /// Extract the match matrix
+  /**
+   * The returned matrix is symmetric and indexed in the same way as the
+   * result of \c kwiver::arrows::match_matrix.
+   *
+   *  \param [in,out] frames the frame numbers to include in the matrix; if
+   *                  empty, it is filled with all frames in sorted order
+   *  \return a sparse matrix of track counts between each pair of frames
+   */
+  Eigen::SparseMatrix<unsigned int>
+  matrix(std::vector<vital::frame_id_t>& frames) const;
+
+protected:
+  /// Add (or remove) the contribution of a track observed on \p frames
+  void accumulate(std::vector<vital::frame_id_t> const& frames, int delta);
+
+  /// Hash for an ordered pair of frame numbers
+  struct frame_pair_hash
+  {
+    size_t operator()(
+      std::pair<vital::frame_id_t, vital::frame_id_t> const& p) const
+    {
+      return std::hash<vital::frame_id_t>()(p.first) ^
+             (std::hash<vital::frame_id_t>()(p.second) * 0x9e3779b97f4a7c15ull);
+    }
+  };
+
+  /// The frames on which each track has been accumulated
+  std::unordered_map<vital::track_id_t,
+                     std::vector<vital::frame_id_t>> track_frames_;
+
+  /// The upper triangular counts, keyed by (first frame, second frame)
+  std::unordered_map<std::pair<vital::frame_id_t, vital::frame_id_t>,
+                     unsigned int, frame_pair_hash> counts_;
+};
+
+/// alias for a match matrix accumulator shared pointer
+using match_matrix_accumulator_sptr =
+  std::shared_ptr<match_matrix_accumulator>;
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_MATCH_MATRIX_H_
@@ -0,0 +1,346 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of a columnar table of per-frame video metadata
+ */
+
+#include "metadata_table.h"
+
+#include <vital/exceptions.h>
+#include <vital/range/valid.h>
+#include <vital/types/geo_point.h>
+#include <vital/types/geodesy.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+double const nan = std::numeric_limits<double>::quiet_NaN();
+
+/// Return the column type used to store the value of \p item
+metadata_table::column_type
+item_column_type(vital::metadata_item const& item)
+{
+  auto const& t = item.type();
+  if (t == typeid(double) || t == typeid(float) || t == typeid(int))
+  {
+    return metadata_table::REAL;
+  }
+  if (t == typeid(uint64_t) || t == typeid(bool))
+  {
+    return metadata_table::INTEGER;
+  }
+  if (t == typeid(vital::geo_point))
+  {
+    return metadata_table::GEO_POINT;
+  }
+  return metadata_table::TEXT;
+}
+
+/// Return the number of doubles stored per row by a column of type \p type
+size_t
+real_stride(metadata_table::column_type type)
+{
+  return type == metadata_table::GEO_POINT ? 3 :
+         type == metadata_table::REAL ? 1 : 0;
+}
+
+}
+
+constexpr size_t metadata_table::npos;
+
+/// Construct a table holding the metadata of every frame in \p md
+metadata_table
+::metadata_table(vital::metadata_map::map_metadata_t const& md)
+{
+  frames_.reserve(md.size());
+  for (auto const& fmd : md)
+  {
+    this->add_frame(fmd.first, fmd.second);
+  }
+}
+
+/// Append a row holding the metadata of frame \p frame
+void
+metadata_table
+::add_frame(vital::frame_id_t frame, vital::metadata_vector const& mdv)
+{
+  if (!frames_.empty() && frame <= frames_.back())
+  {
+    throw vital::invalid_value("Metadata table frames must be added "
+                               "in increasing order");
+  }
+
+  auto const r = frames_.size();
+  frames_.push_back(frame);
+
+  for (auto const& md : mdv | vital::range::valid)
+  {
+    for (auto const& mde : *md)
+    {
+      auto const& item = *mde.second;
+      if (!item.is_valid())
+      {
+        continue;
+      }
+
+      auto const type = item_column_type(item);
+      auto& c = this->make_column(mde.first, type);
+      // Keep the first value of the tag, and skip items whose type does not
+      // match the column; those rows are filled in as invalid below
+      if (c.valid.size() > r || c.type != type)
+      {
+        continue;
+      }
+
+      switch (type)
+      {
+        case REAL:
+          if (item.type() == typeid(double))
+          {
+            c.reals.push_back(vital::any_cast<double>(item.data()));
+          }
+          else if (item.type() == typeid(float))
+          {
+            c.reals.push_back(vital::any_cast<float>(item.data()));
+          }
+          else
+          {
+            c.reals.push_back(vital::any_cast<int>(item.data()));
+          }
+          break;
+        case INTEGER:
+          if (item.type() == typeid(bool))
+          {
+            c.integers.push_back(vital::any_cast<bool>(item.data()));
+          }
+          else
+          {
+            c.integers.push_back(item.as_uint64());
+          }
+          break;
+        case GEO_POINT:
+        {
+          auto const& gp = vital::any_cast<vital::geo_point>(item.data());
+          if (gp.is_empty())
+          {
+            continue;
+          }
+          auto const& loc = gp.location(vital::SRID::lat_lon_WGS84);
+          c.reals.insert(c.reals.end(), loc.data(), loc.data() + 3);
+          break;
+        }
+        case TEXT:
+          c.text += item.as_string();
+          c.text_offsets.push_back(static_cast<uint32_t>(c.text.size()));
+          break;
+      }
+      c.valid.push_back(1);
+    }
+  }
+
+  // Fill in the row of each tag which had no value on this frame
+  for (auto& c : columns_)
+  {
+    if (c.valid.size() == r)
+    {
+      append_invalid(c);
+    }
+  }
+}
+
+/// Return the row of frame \p frame, or \c npos if it is not in the table
+size_t
+metadata_table
+::row(vital::frame_id_t frame) const
+{
+  auto const i = std::lower_bound(frames_.begin(), frames_.end(), frame);
+  if (i == frames_.end() || *i != frame)
+  {
+    return npos;
+  }
+  return static_cast<size_t>(i - frames_.begin());
+}
+
+/// Return the tags which have a column, in increasing order
+std::vector<vital::vital_metadata_tag>
+metadata_table
+::tags() const
+{
+  std::vector<vital::vital_metadata_tag> result;
+  result.reserve(columns_.size());
+  for (auto const& c : columns_)
+  {
+    result.push_back(c.tag);
+  }
+  return result;
+}
+
+/// Return \c true if the table has a column for \p tag
+bool
+metadata_table
+::has(vital::vital_metadata_tag tag) const
+{
+  return this->find_column(tag) != nullptr;
+}
+
+/// Return the storage type of the column of \p tag
+metadata_table::column_type
+metadata_table
+::type(vital::vital_metadata_tag tag) const
+{
+  auto const c = this->find_column(tag);
+  if (!c)
+  {
+    throw std::out_of_range("No metadata column for tag");
+  }
+  return c->type;
+}
+
+/// Return \c true if \p tag has a value on row \p row
+bool
+metadata_table
+::valid(vital::vital_metadata_tag tag, size_t row) const
+{
+  auto const c = this->find_column(tag);
+  return c && row < c->valid.size() && c->valid[row];
+}
+
+/// Return the validity flags of the column of \p tag, one per row
+uint8_t const*
+metadata_table
+::validity(vital::vital_metadata_tag tag) const
+{
+  auto const c = this->find_column(tag);
+  return c ? c->valid.data() : nullptr;
+}
+
+/// Return the values of a \c REAL or \c GEO_POINT column
+double const*
+metadata_table
+::reals(vital::vital_metadata_tag tag) const
+{
+  auto const c = this->find_column(tag);
+  return c && real_stride(c->type) ? c->reals.data() : nullptr;
+}
+
+/// Return the values of an \c INTEGER column, one per row
+uint64_t const*
+metadata_table
+::integers(vital::vital_metadata_tag tag) const
+{
+  auto const c = this->find_column(tag);
+  return c && c->type == INTEGER ? c->integers.data() : nullptr;
+}
+
+/// Return the value of a \c TEXT column on row \p row
+std::string
+metadata_table
+::text(vital::vital_metadata_tag tag, size_t row) const
+{
+  auto const c = this->find_column(tag);
+  if (!c || c->type != TEXT || row >= c->valid.size())
+  {
+    return {};
+  }
+  auto const begin = c->text_offsets[row];
+  return c->text.substr(begin, c->text_offsets[row + 1] - begin);
+}
+
+/// Return the column of \p tag, or \c nullptr if there is none
+metadata_table::column const*
+metadata_table
+::find_column(vital::vital_metadata_tag tag) const
+{
+  auto const i = std::lower_bound(
+    columns_.begin(), columns_.end(), tag,
+    [](column const& c, vital::vital_metadata_tag t) { return c.tag < t; });
+  return (i != columns_.end() && i->tag == tag) ? &*i : nullptr;
+}
+
+/// Return the column of \p tag, adding it if there is none
+/**
+ * A new column is filled with invalid values for every row but the last,
+ * which is the row being added.
+ */
+metadata_table::column&
+metadata_table
+::make_column(vital::vital_metadata_tag tag, column_type type)
+{
+  auto i = std::lower_bound(
+    columns_.begin(), columns_.end(), tag,
+    [](column const& c, vital::vital_metadata_tag t) { return c.tag < t; });
+  if (i != columns_.end() && i->tag == tag)
+  {
+    return *i;
+  }
+
+  i = columns_.insert(i, column{});
+  i->tag = tag;
+  i->type = type;
+  i->text_offsets.push_back(0);
+  for (size_t r = 1; r < frames_.size(); ++r)
+  {
+    append_invalid(*i);
+  }
+  return *i;
+}
+
+/// Append an invalid value to column \p c
+void
+metadata_table
+::append_invalid(column& c)
+{
+  c.valid.push_back(0);
+  switch (c.type)
+  {
+    case REAL:
+    case GEO_POINT:
+      c.reals.insert(c.reals.end(), real_stride(c.type), nan);
+      break;
+    case INTEGER:
+      c.integers.push_back(0);
+      break;
+    case TEXT:
+      c.text_offsets.push_back(static_cast<uint32_t>(c.text.size()));
+      break;
+  }
+}
+
+} // end namespace maptk
+} // end namespace kwiver
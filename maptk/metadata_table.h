@@ -0,0 +1,177 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for a columnar table of per-frame video metadata
+ */
+
+#ifndef MAPTK_METADATA_TABLE_H_
+#define MAPTK_METADATA_TABLE_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/metadata.h>
+#include <vital/types/metadata_map.h>
+#include <vital/vital_types.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// A table of video metadata with one typed, contiguous column per tag
+/**
+ * Each row holds the metadata of one frame and each column the values of one
+ * metadata tag.  Rows are sorted by frame number, so looking up a frame is a
+ * binary search in one array, and each column stores its values in one array
+ * indexed by row.  This makes scanning a tag across the whole video (e.g. the
+ * platform location for camera initialization) a linear walk over memory,
+ * rather than a walk over a map of vectors of heterogeneous metadata items.
+ *
+ * Values are stored by the type of the metadata item: floating point values
+ * as \c double, integers and booleans as \c uint64_t, geographic points as
+ * three doubles (longitude, latitude and altitude in WGS84) and anything
+ * else as text.  Each column also has one validity flag per row.
+ */
+class MAPTK_EXPORT metadata_table
+{
+public:
+  /// The storage type of a column
+  enum column_type
+  {
+    REAL,
+    INTEGER,
+    GEO_POINT,
+    TEXT,
+  };
+
+  /// Row index returned for frames which are not in the table
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /// Construct an empty table
+  metadata_table() = default;
+
+  /// Construct a table holding the metadata of every frame in \p md
+  explicit metadata_table(vital::metadata_map::map_metadata_t const& md);
+
+  /// Append a row holding the metadata of frame \p frame
+  /**
+   * Frames must be added in increasing order.  The first valid item of each
+   * tag in \p mdv provides the value of that tag.
+   *
+   * \throws vital::invalid_value if \p frame is not after the last frame
+   */
+  void add_frame(vital::frame_id_t frame, vital::metadata_vector const& mdv);
+
+  /// Return the number of rows (frames) in the table
+  size_t size() const { return frames_.size(); }
+
+  /// Return the frame number of each row, in increasing order
+  std::vector<vital::frame_id_t> const& frames() const { return frames_; }
+
+  /// Return the row of frame \p frame, or \c npos if it is not in the table
+  size_t row(vital::frame_id_t frame) const;
+
+  /// Return the tags which have a column, in increasing order
+  std::vector<vital::vital_metadata_tag> tags() const;
+
+  /// Return \c true if the table has a column for \p tag
+  bool has(vital::vital_metadata_tag tag) const;
+
+  /// Return the storage type of the column of \p tag
+  /**
+   * \throws std::out_of_range if the table has no column for \p tag
+   */
+  column_type type(vital::vital_metadata_tag tag) const;
+
+  /// Return \c true if \p tag has a value on row \p row
+  bool valid(vital::vital_metadata_tag tag, size_t row) const;
+
+  /// Return the validity flags of the column of \p tag, one per row
+  /**
+   * Returns \c nullptr if the table has no column for \p tag.
+   */
+  uint8_t const* validity(vital::vital_metadata_tag tag) const;
+
+  /// Return the values of a \c REAL or \c GEO_POINT column
+  /**
+   * \c REAL columns hold one value per row and \c GEO_POINT columns hold
+   * three (longitude, latitude, altitude).  Values of invalid rows are NaN.
+   * Returns \c nullptr if \p tag has no column of either type.
+   */
+  double const* reals(vital::vital_metadata_tag tag) const;
+
+  /// Return the values of an \c INTEGER column, one per row
+  /**
+   * Returns \c nullptr if \p tag has no \c INTEGER column.
+   */
+  uint64_t const* integers(vital::vital_metadata_tag tag) const;
+
+  /// Return the value of a \c TEXT column on row \p row
+  /**
+   * Returns an empty string if \p tag has no \c TEXT column or no value on
+   * row \p row.
+   */
+  std::string text(vital::vital_metadata_tag tag, size_t row) const;
+
+protected:
+  /// The values of one tag on every row
+  struct column
+  {
+    vital::vital_metadata_tag tag;
+    column_type type;
+    std::vector<uint8_t> valid;
+    std::vector<double> reals;
+    std::vector<uint64_t> integers;
+    /// Start of the text of each row in \c text, plus the end of the last
+    std::vector<uint32_t> text_offsets;
+    std::string text;
+  };
+
+  column const* find_column(vital::vital_metadata_tag tag) const;
+  column& make_column(vital::vital_metadata_tag tag, column_type type);
+  static void append_invalid(column& c);
+
+  std::vector<vital::frame_id_t> frames_;
+  /// Columns sorted by tag
+  std::vector<column> columns_;
+};
+
+typedef std::shared_ptr<metadata_table const> metadata_table_sptr;
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_METADATA_TABLE_H_
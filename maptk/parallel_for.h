@@ -0,0 +1,132 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for a chunked parallel loop over the vital thread pool
+ */
+
+#ifndef MAPTK_PARALLEL_FOR_H_
+#define MAPTK_PARALLEL_FOR_H_
+
+#include <vital/util/thread_pool.h>
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Call a function over a range of indices in parallel chunks
+/**
+ * The range [\p begin, \p end) is split into contiguous chunks of at least
+ * \p min_chunk indices that are processed by the vital thread pool, with the
+ * first chunk processed on the calling thread.  \p func is called as
+ * <code>func(chunk_begin, chunk_end)</code> and must be safe to call
+ * concurrently on disjoint chunks.  Ranges smaller than \p min_chunk are
+ * processed directly on the calling thread.  The first exception thrown by
+ * any chunk is re-thrown once all chunks have finished.
+ *
+ * \note Do not call this from a task that is itself running in the vital
+ *       thread pool, as waiting on the chunks could then dead-lock.
+ *
+ *  \param [in] begin the first index to process
+ *  \param [in] end one past the last index to process
+ *  \param [in] func the function to call on each chunk
+ *  \param [in] min_chunk the minimum number of indices in each chunk
+ */
+template <typename Func>
+void
+parallel_for(size_t begin, size_t end, Func const& func,
+             size_t min_chunk = 4096)
+{
+  if (end <= begin)
+  {
+    return;
+  }
+
+  auto& pool = vital::thread_pool::instance();
+  size_t const n = end - begin;
+  size_t const max_chunks = 4 * std::max<size_t>(pool.num_threads(), 1);
+  size_t const num_chunks =
+    std::min(max_chunks, (n + min_chunk - 1) / std::max<size_t>(min_chunk, 1));
+  if (num_chunks <= 1)
+  {
+    func(begin, end);
+    return;
+  }
+
+  size_t const chunk = (n + num_chunks - 1) / num_chunks;
+  std::vector<std::future<void>> jobs;
+  jobs.reserve(num_chunks);
+  for (size_t b = begin + chunk; b < end; b += chunk)
+  {
+    size_t const e = std::min(b + chunk, end);
+    jobs.push_back(pool.enqueue([&func, b, e]() { func(b, e); }));
+  }
+
+  // process the first chunk here, but always wait for the other chunks
+  // before leaving since they reference func
+  std::exception_ptr error;
+  try
+  {
+    func(begin, std::min(begin + chunk, end));
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+  for (auto& job : jobs)
+  {
+    try
+    {
+      job.get();
+    }
+    catch (...)
+    {
+      if (!error)
+      {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_PARALLEL_FOR_H_
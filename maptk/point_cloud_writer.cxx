@@ -0,0 +1,352 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of a chunked point cloud file writer
+ */
+
+#include "point_cloud_writer.h"
+
+#include <maptk/parallel_for.h>
+#include <maptk/write_pdal.h>
+
+#include <vital/exceptions/io.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+typedef kwiversys::SystemTools ST;
+
+/// Width of the zero padded point count in PLY and PCD headers
+int const count_width = 12;
+
+/// Size of one spooled LAS record: three doubles and three color bytes
+size_t const spool_record_size = 3 * sizeof(double) + 3;
+
+/// Return true if this machine stores numbers little endian
+bool
+is_little_endian()
+{
+  uint16_t const one = 1;
+  unsigned char byte;
+  std::memcpy(&byte, &one, 1);
+  return byte == 1;
+}
+
+}
+
+/// Open \p path for writing, throwing vital::file_write_exception on error
+point_cloud_writer
+::point_cloud_writer(vital::path_t const& path,
+                     vital::local_geo_cs const& lgcs,
+                     bool has_colors)
+  : path_(path),
+    lgcs_(lgcs),
+    has_colors_(has_colors),
+    num_points_(0)
+{
+  auto const ext = ST::LowerCase(ST::GetFilenameLastExtension(path));
+  if (ext == ".ply")
+  {
+    format_ = PLY;
+  }
+  else if (ext == ".pcd")
+  {
+    format_ = PCD;
+  }
+  else if (ext == ".las" || ext == ".laz")
+  {
+    format_ = LAS;
+  }
+  else
+  {
+    throw vital::file_write_exception(path, "Unsupported point cloud format");
+  }
+
+  // LAS points are spooled to a temporary file until the writer is closed
+  if (format_ == LAS)
+  {
+    spool_path_ = path + ".spool";
+  }
+  vital::path_t const& stream_path = format_ == LAS ? spool_path_ : path;
+  stream_.open(stream_path.c_str(),
+               std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!stream_)
+  {
+    throw vital::file_write_exception(stream_path,
+                                      "Could not open file for writing");
+  }
+  if (format_ != LAS)
+  {
+    write_header();
+  }
+}
+
+/// Destructor, which removes any spool file left by a writer not closed
+point_cloud_writer
+::~point_cloud_writer()
+{
+  if (!spool_path_.empty())
+  {
+    stream_.close();
+    std::remove(spool_path_.c_str());
+  }
+}
+
+/// Return true if \p path has an extension supported by this writer
+bool
+point_cloud_writer
+::is_supported(vital::path_t const& path)
+{
+  auto const ext = ST::LowerCase(ST::GetFilenameLastExtension(path));
+  return ext == ".ply" || ext == ".pcd" || ext == ".las" || ext == ".laz";
+}
+
+/// Write the header of a PLY or PCD file with the current point count
+void
+point_cloud_writer
+::write_header()
+{
+  std::ostringstream count;
+  count << std::setw(count_width) << std::setfill('0') << num_points_;
+
+  std::ostringstream header;
+  if (format_ == PLY)
+  {
+    header << "ply\n"
+           << "format "
+           << (is_little_endian() ? "binary_little_endian"
+                                  : "binary_big_endian") << " 1.0\n"
+           << "comment TeleSculptor point cloud\n"
+           << "element vertex " << count.str() << "\n"
+           << "property float x\n"
+           << "property float y\n"
+           << "property float z\n";
+    if (has_colors_)
+    {
+      header << "property uchar red\n"
+             << "property uchar green\n"
+             << "property uchar blue\n";
+    }
+    header << "end_header\n";
+  }
+  else
+  {
+    header << "# .PCD v0.7 - Point Cloud Data file format\n"
+           << "VERSION 0.7\n";
+    if (has_colors_)
+    {
+      header << "FIELDS x y z rgb\n"
+             << "SIZE 4 4 4 4\n"
+             << "TYPE F F F U\n"
+             << "COUNT 1 1 1 1\n";
+    }
+    else
+    {
+      header << "FIELDS x y z\n"
+             << "SIZE 4 4 4\n"
+             << "TYPE F F F\n"
+             << "COUNT 1 1 1\n";
+    }
+    header << "WIDTH " << count.str() << "\n"
+           << "HEIGHT 1\n"
+           << "VIEWPOINT 0 0 0 1 0 0 0\n"
+           << "POINTS " << count.str() << "\n"
+           << "DATA binary\n";
+  }
+
+  std::string const h = header.str();
+  stream_.write(h.data(), static_cast<std::streamsize>(h.size()));
+}
+
+/// Pack and write a chunk of points of either precision
+template <typename T>
+void
+point_cloud_writer
+::write_chunk(T const* points, size_t num_points,
+              unsigned char const* colors)
+{
+  if (num_points == 0)
+  {
+    return;
+  }
+
+  size_t record_size = 0;
+  switch (format_)
+  {
+    case PLY: record_size = 3 * sizeof(float) + (has_colors_ ? 3 : 0); break;
+    case PCD: record_size = (has_colors_ ? 4 : 3) * sizeof(float); break;
+    case LAS: record_size = spool_record_size; break;
+  }
+
+  // reuse the packing buffer between chunks
+  buffer_.resize(num_points * record_size);
+  char* const buffer = buffer_.data();
+  unsigned char const black[3] = { 0, 0, 0 };
+  auto const format = format_;
+  bool const has_colors = has_colors_;
+
+  parallel_for(0, num_points, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      T const* p = points + 3 * i;
+      unsigned char const* c = colors ? colors + 3 * i : black;
+      char* r = buffer + i * record_size;
+      if (format == LAS)
+      {
+        double const xyz[3] = { static_cast<double>(p[0]),
+                                static_cast<double>(p[1]),
+                                static_cast<double>(p[2]) };
+        std::memcpy(r, xyz, sizeof(xyz));
+        std::memcpy(r + sizeof(xyz), c, 3);
+        continue;
+      }
+
+      float const xyz[3] = { static_cast<float>(p[0]),
+                             static_cast<float>(p[1]),
+                             static_cast<float>(p[2]) };
+      std::memcpy(r, xyz, sizeof(xyz));
+      if (!has_colors)
+      {
+        continue;
+      }
+      if (format == PLY)
+      {
+        std::memcpy(r + sizeof(xyz), c, 3);
+      }
+      else
+      {
+        uint32_t const rgb = (static_cast<uint32_t>(c[0]) << 16) |
+                             (static_cast<uint32_t>(c[1]) << 8) |
+                             static_cast<uint32_t>(c[2]);
+        std::memcpy(r + sizeof(xyz), &rgb, sizeof(rgb));
+      }
+    }
+  });
+
+  stream_.write(buffer, static_cast<std::streamsize>(buffer_.size()));
+  if (!stream_)
+  {
+    throw vital::file_write_exception(
+      format_ == LAS ? spool_path_ : path_, "Failed to write points");
+  }
+  num_points_ += num_points;
+}
+
+/// Append a chunk of points
+void
+point_cloud_writer
+::write(double const* points, size_t num_points, unsigned char const* colors)
+{
+  write_chunk(points, num_points, colors);
+}
+
+/// Append a chunk of single precision points
+void
+point_cloud_writer
+::write(float const* points, size_t num_points, unsigned char const* colors)
+{
+  write_chunk(points, num_points, colors);
+}
+
+/// Finish the file, writing the final point count or the LAS file
+void
+point_cloud_writer
+::close()
+{
+  if (!stream_.is_open())
+  {
+    return;
+  }
+  std::vector<char>().swap(buffer_);
+
+  if (format_ != LAS)
+  {
+    // the zero padded count has a fixed width, so the header can be
+    // rewritten in place
+    stream_.seekp(0);
+    write_header();
+    stream_.close();
+    if (stream_.fail())
+    {
+      throw vital::file_write_exception(path_, "Failed to close file");
+    }
+    return;
+  }
+
+  stream_.close();
+  if (stream_.fail())
+  {
+    throw vital::file_write_exception(spool_path_, "Failed to close file");
+  }
+
+  std::ifstream spool(spool_path_.c_str(), std::ios::in | std::ios::binary);
+  if (!spool)
+  {
+    throw vital::file_not_found_exception(spool_path_, "Could not open file");
+  }
+  char record[spool_record_size];
+  point_source const next =
+    [&spool, &record](vital::vector_3d& pt, vital::rgb_color& rgb)
+  {
+    if (!spool.read(record, sizeof(record)))
+    {
+      return false;
+    }
+    double xyz[3];
+    std::memcpy(xyz, record, sizeof(xyz));
+    pt = vital::vector_3d(xyz[0], xyz[1], xyz[2]);
+    auto const* c = reinterpret_cast<unsigned char const*>(record) +
+                    sizeof(xyz);
+    rgb = vital::rgb_color(c[0], c[1], c[2]);
+    return true;
+  };
+  write_pdal(path_, lgcs_, next, has_colors_);
+  spool.close();
+
+  std::remove(spool_path_.c_str());
+  spool_path_.clear();
+}
+
+} // end namespace maptk
+} // end namespace kwiver
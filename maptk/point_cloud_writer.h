@@ -0,0 +1,133 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for a chunked point cloud file writer
+ */
+
+#ifndef MAPTK_POINT_CLOUD_WRITER_H_
+#define MAPTK_POINT_CLOUD_WRITER_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/local_geo_cs.h>
+#include <vital/vital_types.h>
+
+#include <fstream>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Writer of a point cloud file in chunks of points
+/**
+ * Points are appended in chunks as they are produced, for example one depth
+ * map at a time, and each chunk is packed in parallel and written out
+ * immediately, so memory use does not grow with the size of the cloud.  The
+ * file format is chosen from the extension of the file name:
+ *
+ * - ".ply" writes a binary PLY file with float coordinates and, optionally,
+ *   uchar red, green and blue properties.
+ * - ".pcd" writes a binary PCD file with float coordinates and, optionally,
+ *   colors packed into an unsigned "rgb" field.
+ * - ".las" and ".laz" write with PDAL in geographic coordinates given by the
+ *   local geographic coordinate system.  Since PDAL pulls the points, they
+ *   are spooled to a temporary file next to the output and streamed to PDAL
+ *   when the writer is closed.
+ *
+ * The PLY and PCD headers hold the number of points, which is written when
+ * the writer is closed.  Points are given in local coordinates.
+ */
+class MAPTK_EXPORT point_cloud_writer
+{
+public:
+  /// Open \p path for writing, throwing vital::file_write_exception on error
+  /**
+   *  \param [in] path the file to write, with a supported extension
+   *  \param [in] lgcs the local geographic coordinate system, used for LAS
+   *  \param [in] has_colors whether points are written with colors
+   */
+  point_cloud_writer(vital::path_t const& path,
+                     vital::local_geo_cs const& lgcs,
+                     bool has_colors);
+
+  /// Destructor, which removes any spool file left by a writer not closed
+  ~point_cloud_writer();
+
+  /// Return true if \p path has an extension supported by this writer
+  static bool is_supported(vital::path_t const& path);
+
+  /// Append a chunk of points
+  /**
+   *  \param [in] points \p num_points (x, y, z) triples
+   *  \param [in] num_points the number of points in the chunk
+   *  \param [in] colors \p num_points (r, g, b) triples, or null to write
+   *                     black if the writer was opened with colors
+   */
+  void write(double const* points, size_t num_points,
+             unsigned char const* colors = nullptr);
+
+  /// Append a chunk of single precision points
+  void write(float const* points, size_t num_points,
+             unsigned char const* colors = nullptr);
+
+  /// Finish the file, writing the final point count or the LAS file
+  void close();
+
+  /// Return the number of points written so far
+  size_t size() const { return num_points_; }
+
+protected:
+  enum file_format { PLY, PCD, LAS };
+
+  /// Write the header of a PLY or PCD file with the current point count
+  void write_header();
+
+  /// Pack and write a chunk of points of either precision
+  template <typename T>
+  void write_chunk(T const* points, size_t num_points,
+                   unsigned char const* colors);
+
+  vital::path_t path_;
+  vital::path_t spool_path_;
+  vital::local_geo_cs lgcs_;
+  file_format format_;
+  bool has_colors_;
+  size_t num_points_;
+  std::ofstream stream_;
+  std::vector<char> buffer_;
+};
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_POINT_CLOUD_WRITER_H_
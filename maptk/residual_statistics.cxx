@@ -0,0 +1,256 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of maptk::residual_statistics
+ */
+
+#include "residual_statistics.h"
+
+#include <maptk/parallel_for.h>
+
+#include <vital/types/camera_perspective.h>
+#include <vital/types/feature_track_set.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+/// An observation of a landmark in a camera, flattened
+struct observation
+{
+  unsigned camera;
+  double error;
+};
+
+unsigned const no_camera = std::numeric_limits<unsigned>::max();
+
+}
+
+/// Root mean squared error, or zero if there are no observations
+double
+residual_summary
+::rmse() const
+{
+  return num_observations
+    ? std::sqrt(sum_squared_error / static_cast<double>(num_observations))
+    : 0.0;
+}
+
+/// Constructor
+residual_statistics
+::residual_statistics(double inlier_threshold, double bin_width,
+                      unsigned num_bins)
+  : inlier_threshold_(inlier_threshold),
+    bin_width_(bin_width > 0.0 ? bin_width : 1.0),
+    num_bins_(num_bins)
+{
+}
+
+/// Add an error to a summary
+void
+residual_statistics
+::add(residual_summary& summary, double error) const
+{
+  ++summary.num_observations;
+  summary.sum_squared_error += error * error;
+  summary.max_error = std::max(summary.max_error, error);
+  if (error < inlier_threshold_)
+  {
+    ++summary.num_inliers;
+  }
+  if (num_bins_)
+  {
+    auto const bin = std::min(static_cast<double>(num_bins_ - 1),
+                              std::floor(error / bin_width_));
+    ++summary.histogram[static_cast<size_t>(bin)];
+  }
+}
+
+/// Add the counts of \p other to \p summary
+void
+residual_statistics
+::merge(residual_summary& summary, residual_summary const& other) const
+{
+  summary.num_observations += other.num_observations;
+  summary.num_inliers += other.num_inliers;
+  summary.sum_squared_error += other.sum_squared_error;
+  summary.max_error = std::max(summary.max_error, other.max_error);
+  for (size_t i = 0; i < other.histogram.size(); ++i)
+  {
+    summary.histogram[i] += other.histogram[i];
+  }
+}
+
+/// Compute the statistics of \p tracks observing \p landmarks
+void
+residual_statistics
+::compute(vital::camera_map::map_camera_t const& cameras,
+          vital::landmark_map::map_landmark_t const& landmarks,
+          std::vector<vital::track_sptr> const& tracks)
+{
+  auto const empty = [this]{
+    residual_summary s;
+    s.histogram.assign(num_bins_, 0);
+    return s;
+  }();
+
+  // Index the perspective cameras
+  std::vector<vital::frame_id_t> frames;
+  std::vector<vital::camera_perspective const*> cams;
+  std::unordered_map<vital::frame_id_t, unsigned> cam_index;
+  for (auto const& c : cameras)
+  {
+    auto const cam =
+      dynamic_cast<vital::camera_perspective const*>(c.second.get());
+    if (cam)
+    {
+      cam_index.emplace(c.first, static_cast<unsigned>(cams.size()));
+      frames.push_back(c.first);
+      cams.push_back(cam);
+    }
+  }
+
+  // Assign each track a range of the flattened observation array
+  std::vector<size_t> offsets(tracks.size() + 1, 0);
+  for (size_t i = 0; i < tracks.size(); ++i)
+  {
+    offsets[i + 1] = offsets[i] + (tracks[i] ? tracks[i]->size() : 0);
+  }
+  std::vector<observation> observations(offsets.back(),
+                                        observation{no_camera, 0.0});
+  std::vector<residual_summary> track_summaries(tracks.size());
+  std::vector<char> has_landmark(tracks.size(), 0);
+
+  // Compute the error of every observation, in parallel over tracks
+  parallel_for(0, tracks.size(), [&](size_t begin, size_t end){
+    for (auto i = begin; i < end; ++i)
+    {
+      auto const& t = tracks[i];
+      if (!t)
+      {
+        continue;
+      }
+      auto const lm = landmarks.find(t->id());
+      if (lm == landmarks.end() || !lm->second)
+      {
+        continue;
+      }
+      has_landmark[i] = 1;
+
+      auto& summary = track_summaries[i];
+      summary = empty;
+
+      auto const& loc = lm->second->loc();
+      auto* obs = observations.data() + offsets[i];
+      for (auto const& ts : *t)
+      {
+        auto const fts =
+          dynamic_cast<vital::feature_track_state const*>(ts.get());
+        auto const c = cam_index.find(ts->frame());
+        if (fts && fts->feature && c != cam_index.end())
+        {
+          auto const error =
+            (cams[c->second]->project(loc) - fts->feature->loc()).norm();
+          *obs = observation{c->second, error};
+          add(summary, error);
+        }
+        ++obs;
+      }
+    }
+  }, 256);
+
+  tracks_.clear();
+  for (size_t i = 0; i < tracks.size(); ++i)
+  {
+    if (has_landmark[i])
+    {
+      tracks_.emplace_hint(tracks_.end(), tracks[i]->id(),
+                           std::move(track_summaries[i]));
+    }
+  }
+
+  // Group the errors by camera with a counting sort
+  std::vector<size_t> cam_offsets(cams.size() + 1, 0);
+  for (auto const& o : observations)
+  {
+    if (o.camera != no_camera)
+    {
+      ++cam_offsets[o.camera + 1];
+    }
+  }
+  for (size_t c = 0; c < cams.size(); ++c)
+  {
+    cam_offsets[c + 1] += cam_offsets[c];
+  }
+  std::vector<double> errors(cam_offsets.back());
+  {
+    auto next = cam_offsets;
+    for (auto const& o : observations)
+    {
+      if (o.camera != no_camera)
+      {
+        errors[next[o.camera]++] = o.error;
+      }
+    }
+  }
+
+  // Summarize each camera in parallel
+  std::vector<residual_summary> cam_summaries(cams.size(), empty);
+  parallel_for(0, cams.size(), [&](size_t begin, size_t end){
+    for (auto c = begin; c < end; ++c)
+    {
+      for (auto k = cam_offsets[c]; k < cam_offsets[c + 1]; ++k)
+      {
+        add(cam_summaries[c], errors[k]);
+      }
+    }
+  }, 64);
+
+  overall_ = empty;
+  cameras_.clear();
+  for (size_t c = 0; c < cams.size(); ++c)
+  {
+    merge(overall_, cam_summaries[c]);
+    cameras_.emplace_hint(cameras_.end(), frames[c],
+                          std::move(cam_summaries[c]));
+  }
+}
+
+} // end namespace maptk
+} // end namespace kwiver
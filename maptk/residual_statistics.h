@@ -0,0 +1,133 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for maptk::residual_statistics
+ */
+
+#ifndef MAPTK_RESIDUAL_STATISTICS_H_
+#define MAPTK_RESIDUAL_STATISTICS_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/camera_map.h>
+#include <vital/types/landmark_map.h>
+#include <vital/types/track.h>
+
+#include <map>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Summary of a set of reprojection errors
+struct residual_summary
+{
+  /// Number of observations
+  size_t num_observations = 0;
+  /// Number of observations with error below the inlier threshold
+  size_t num_inliers = 0;
+  /// Sum of the squared errors
+  double sum_squared_error = 0.0;
+  /// Largest error
+  double max_error = 0.0;
+  /// Counts of errors in bins of fixed width; the last bin also counts all
+  /// larger errors
+  std::vector<unsigned> histogram;
+
+  /// Root mean squared error, or zero if there are no observations
+  double rmse() const;
+};
+
+/// Reprojection error statistics of landmarks observed by cameras
+/**
+ * This class computes the overall reprojection RMSE, the same value as
+ * \c kwiver::arrows::reprojection_rmse, along with error summaries and
+ * histograms for each camera and each track.  The residuals are computed in
+ * parallel over a flattened array of observations, and then grouped by camera
+ * without any map lookups.
+ */
+class MAPTK_EXPORT residual_statistics
+{
+public:
+  /// Constructor
+  /**
+   *  \param [in] inlier_threshold errors below this (in pixels) are inliers
+   *  \param [in] bin_width the width (in pixels) of each histogram bin
+   *  \param [in] num_bins the number of histogram bins; if zero, histograms
+   *              are not computed
+   */
+  explicit residual_statistics(double inlier_threshold = 2.0,
+                               double bin_width = 0.5,
+                               unsigned num_bins = 10);
+
+  /// Compute the statistics of \p tracks observing \p landmarks
+  /**
+   * Track states on frames without a perspective camera, and tracks without
+   * a landmark, are ignored.  The landmark of each track is the landmark
+   * with the same ID.
+   */
+  void compute(vital::camera_map::map_camera_t const& cameras,
+               vital::landmark_map::map_landmark_t const& landmarks,
+               std::vector<vital::track_sptr> const& tracks);
+
+  /// Statistics of all observations
+  residual_summary const& overall() const { return overall_; }
+
+  /// Statistics of the observations in each camera
+  std::map<vital::frame_id_t, residual_summary> const&
+  cameras() const { return cameras_; }
+
+  /// Statistics of the observations of each track with a landmark
+  std::map<vital::track_id_t, residual_summary> const&
+  tracks() const { return tracks_; }
+
+protected:
+  /// Add an error to a summary
+  void add(residual_summary& summary, double error) const;
+
+  /// Add the counts of \p other to \p summary
+  void merge(residual_summary& summary, residual_summary const& other) const;
+
+  double inlier_threshold_;
+  double bin_width_;
+  unsigned num_bins_;
+
+  residual_summary overall_;
+  std::map<vital::frame_id_t, residual_summary> cameras_;
+  std::map<vital::track_id_t, residual_summary> tracks_;
+};
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_RESIDUAL_STATISTICS_H_
@@ -0,0 +1,141 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of maptk::compute_robust_bounds functions
+ */
+
+#include "robust_bounds.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool
+robust_bounds(T const* points, size_t num_points, double bounds[6],
+              double percentile, double zmax_percentile, double margin)
+{
+  if (num_points < 2)
+  {
+    return false;
+  }
+
+  auto const last = num_points - 1;
+  auto const min_idx = static_cast<size_t>(percentile * last);
+  auto const max_idx = last - min_idx;
+  auto const zmax_idx = static_cast<size_t>(last * (1.0 - zmax_percentile));
+
+  // Select the order statistics of each axis in turn, reusing one buffer;
+  // after selecting the lower index, the upper one only needs to be searched
+  // for in the partition above it
+  std::vector<T> values(num_points);
+  for (unsigned axis = 0; axis < 3; ++axis)
+  {
+    for (size_t i = 0; i < num_points; ++i)
+    {
+      values[i] = points[3 * i + axis];
+    }
+
+    auto const upper_idx = (axis == 2 ? zmax_idx : max_idx);
+    auto const begin = values.begin();
+    std::nth_element(begin, begin + min_idx, values.end());
+    if (upper_idx > min_idx)
+    {
+      std::nth_element(begin + min_idx + 1, begin + upper_idx, values.end());
+    }
+    bounds[2 * axis] = static_cast<double>(values[min_idx]);
+    bounds[2 * axis + 1] =
+      static_cast<double>(values[std::max(upper_idx, min_idx)]);
+  }
+
+  for (unsigned i = 0; i < 3; ++i)
+  {
+    unsigned i_min = 2 * i;
+    unsigned i_max = i_min + 1;
+    double offset = (bounds[i_max] - bounds[i_min]) * margin;
+    bounds[i_min] -= offset;
+    bounds[i_max] += offset;
+  }
+  return true;
+}
+
+} // end anonymous namespace
+
+/// Compute a bounding box of a point cloud which is robust to outliers
+bool
+compute_robust_bounds(float const* points, size_t num_points,
+                      double bounds[6], double percentile,
+                      double zmax_percentile, double margin)
+{
+  return robust_bounds(points, num_points, bounds,
+                       percentile, zmax_percentile, margin);
+}
+
+/// Compute a bounding box of a point cloud which is robust to outliers
+bool
+compute_robust_bounds(double const* points, size_t num_points,
+                      double bounds[6], double percentile,
+                      double zmax_percentile, double margin)
+{
+  return robust_bounds(points, num_points, bounds,
+                       percentile, zmax_percentile, margin);
+}
+
+/// Compute a bounding box of landmarks which is robust to outliers
+bool
+compute_robust_bounds(vital::landmark_map const& landmarks,
+                      double bounds[6], double percentile,
+                      double zmax_percentile, double margin)
+{
+  auto const& lms = landmarks.landmarks();
+  std::vector<double> points;
+  points.reserve(3 * lms.size());
+  for (auto const& lm : lms)
+  {
+    if (lm.second)
+    {
+      auto const& loc = lm.second->loc();
+      points.insert(points.end(), loc.data(), loc.data() + 3);
+    }
+  }
+
+  return robust_bounds(points.data(), points.size() / 3, bounds,
+                       percentile, zmax_percentile, margin);
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,107 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for maptk::compute_robust_bounds functions
+ */
+
+#ifndef MAPTK_ROBUST_BOUNDS_H_
+#define MAPTK_ROBUST_BOUNDS_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/landmark_map.h>
+
+#include <cstddef>
+
+namespace kwiver {
+namespace maptk {
+
+/// Compute a bounding box of a point cloud which is robust to outliers
+/**
+ * This function computes an axis aligned bounding box which excludes the
+ * given fraction of points on each side of each axis, and then expands it by
+ * a margin relative to its size.  A smaller percentile is used for the top of
+ * the box since that is typically where small structures (poles, towers) with
+ * few points are found.
+ *
+ * The percentiles are found by selection rather than sorting, so the cost is
+ * linear in the number of points.
+ *
+ *  \param [in]  points pointer to \p num_points packed (x, y, z) coordinates
+ *  \param [in]  num_points the number of points
+ *  \param [out] bounds the bounds as (xmin, xmax, ymin, ymax, zmin, zmax)
+ *  \param [in]  percentile the fraction of points to exclude on each side
+ *  \param [in]  zmax_percentile the fraction of points to exclude above
+ *  \param [in]  margin the fraction of the box size to add on each side
+ *  \return false if there are too few points to compute bounds
+ */
+MAPTK_EXPORT
+bool compute_robust_bounds(float const* points, size_t num_points,
+                           double bounds[6],
+                           double percentile = 0.1,
+                           double zmax_percentile = 0.01,
+                           double margin = 0.5);
+
+/// Compute a bounding box of a point cloud which is robust to outliers
+/**
+ * \copydetails compute_robust_bounds(float const*, size_t, double*, double, double, double)
+ */
+MAPTK_EXPORT
+bool compute_robust_bounds(double const* points, size_t num_points,
+                           double bounds[6],
+                           double percentile = 0.1,
+                           double zmax_percentile = 0.01,
+                           double margin = 0.5);
+
+/// Compute a bounding box of landmarks which is robust to outliers
+/**
+ * This is a convenience overload which computes robust bounds of the
+ * locations of a set of landmarks.
+ *
+ *  \param [in]  landmarks the landmarks for which to compute bounds
+ *  \param [out] bounds the bounds as (xmin, xmax, ymin, ymax, zmin, zmax)
+ *  \param [in]  percentile the fraction of points to exclude on each side
+ *  \param [in]  zmax_percentile the fraction of points to exclude above
+ *  \param [in]  margin the fraction of the box size to add on each side
+ *  \return false if there are too few landmarks to compute bounds
+ */
+MAPTK_EXPORT
+bool compute_robust_bounds(vital::landmark_map const& landmarks,
+                           double bounds[6],
+                           double percentile = 0.1,
+                           double zmax_percentile = 0.01,
+                           double margin = 0.5);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_ROBUST_BOUNDS_H_
@@ -0,0 +1,205 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of partitioning cameras into overlapping submaps
+ */
+
+#include "submap_partition.h"
+
+#include <maptk/match_matrix.h>
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Partition frames into overlapping submaps using track co-visibility
+std::vector<camera_submap>
+partition_submaps(vital::track_set const& tracks,
+                  std::vector<vital::frame_id_t> const& frames,
+                  size_t max_size, size_t overlap)
+{
+  std::vector<camera_submap> submaps;
+  if (frames.empty())
+  {
+    return submaps;
+  }
+  max_size = std::max<size_t>(max_size, 1);
+
+  match_matrix_accumulator accumulator;
+  accumulator.rebuild(tracks);
+
+  std::vector<vital::frame_id_t> sorted_frames = frames;
+  std::sort(sorted_frames.begin(), sorted_frames.end());
+  Eigen::SparseMatrix<unsigned int> const mm =
+    accumulator.matrix(sorted_frames);
+
+  auto const n = sorted_frames.size();
+  std::vector<int> assignment(n, -1);
+  std::vector<unsigned long> gain(n, 0);
+
+  // The number of tracks on each frame, used to normalize the gain so that
+  // frames with few tracks (e.g. at the start of a video) are not left behind
+  std::vector<double> num_tracks(n, 1.0);
+  for (size_t i = 0; i < n; ++i)
+  {
+    num_tracks[i] = std::max(1.0, static_cast<double>(
+      mm.coeff(static_cast<int>(i), static_cast<int>(i))));
+  }
+
+  // Grow each core from the earliest unassigned frame by repeatedly adding
+  // the unassigned frame with the largest fraction of its tracks in common
+  // with the core (preferring earlier frames on ties); stale queue entries
+  // are skipped by comparing against the current gain
+  typedef std::pair<double, size_t> entry_t;
+  auto const entry_less = [](entry_t const& a, entry_t const& b){
+    return a.first < b.first || (a.first == b.first && a.second > b.second);
+  };
+  size_t next_seed = 0;
+  while (next_seed < n)
+  {
+    auto const submap_index = static_cast<int>(submaps.size());
+    submaps.emplace_back();
+    auto& core = submaps.back().core;
+
+    std::vector<size_t> touched;
+    std::priority_queue<entry_t, std::vector<entry_t>, decltype(entry_less)>
+      queue(entry_less);
+    while (core.size() < max_size)
+    {
+      size_t next = n;
+      while (!queue.empty())
+      {
+        auto const top = queue.top();
+        queue.pop();
+        if (assignment[top.second] < 0 &&
+            gain[top.second] / num_tracks[top.second] == top.first)
+        {
+          next = top.second;
+          break;
+        }
+      }
+      if (next == n)
+      {
+        // Nothing connected to the core remains; continue with the next
+        // frame in order so that cores stay close to the requested size
+        while (next_seed < n && assignment[next_seed] >= 0)
+        {
+          ++next_seed;
+        }
+        if (next_seed == n)
+        {
+          break;
+        }
+        next = next_seed;
+      }
+
+      assignment[next] = submap_index;
+      core.insert(sorted_frames[next]);
+      for (Eigen::SparseMatrix<unsigned int>::InnerIterator it(
+             mm, static_cast<int>(next)); it; ++it)
+      {
+        auto const j = static_cast<size_t>(it.row());
+        if (assignment[j] < 0)
+        {
+          if (gain[j] == 0)
+          {
+            touched.push_back(j);
+          }
+          gain[j] += it.value();
+          queue.emplace(gain[j] / num_tracks[j], j);
+        }
+      }
+    }
+
+    for (auto const j : touched)
+    {
+      gain[j] = 0;
+    }
+    while (next_seed < n && assignment[next_seed] >= 0)
+    {
+      ++next_seed;
+    }
+  }
+
+  if (overlap == 0 || submaps.size() < 2)
+  {
+    return submaps;
+  }
+
+  // Extend each submap with the frames of other submaps which share the most
+  // tracks with its core
+  for (size_t s = 0; s < submaps.size(); ++s)
+  {
+    std::vector<unsigned long> shared(n, 0);
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (assignment[i] != static_cast<int>(s))
+      {
+        continue;
+      }
+      for (Eigen::SparseMatrix<unsigned int>::InnerIterator it(
+             mm, static_cast<int>(i)); it; ++it)
+      {
+        auto const j = static_cast<size_t>(it.row());
+        if (assignment[j] != static_cast<int>(s))
+        {
+          if (shared[j] == 0)
+          {
+            candidates.push_back(j);
+          }
+          shared[j] += it.value();
+        }
+      }
+    }
+
+    auto const count = std::min(overlap, candidates.size());
+    std::partial_sort(
+      candidates.begin(), candidates.begin() + count, candidates.end(),
+      [&shared](size_t a, size_t b){
+        return shared[a] > shared[b] || (shared[a] == shared[b] && a < b);
+      });
+    for (size_t k = 0; k < count; ++k)
+    {
+      submaps[s].overlap.insert(sorted_frames[candidates[k]]);
+    }
+  }
+
+  return submaps;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
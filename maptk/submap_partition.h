@@ -0,0 +1,83 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for partitioning cameras into overlapping submaps
+ */
+
+#ifndef MAPTK_SUBMAP_PARTITION_H_
+#define MAPTK_SUBMAP_PARTITION_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/track_set.h>
+
+#include <set>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// A subset of cameras to be optimized together
+struct camera_submap
+{
+  /// Frames assigned exclusively to this submap
+  std::set<vital::frame_id_t> core;
+  /// Frames assigned to other submaps which strongly overlap this one
+  std::set<vital::frame_id_t> overlap;
+};
+
+/// Partition frames into overlapping submaps using track co-visibility
+/**
+ * This function splits \p frames into disjoint cores of at most
+ * \p max_size frames by greedily growing each core with the frame sharing
+ * the most tracks with it.  Each core is then extended with up to
+ * \p overlap frames from other cores which share the most tracks with it.
+ * Frames which appear in the overlap of any submap are the separators
+ * between submaps.
+ *
+ *  \param [in] tracks the tracks from which to compute co-visibility
+ *  \param [in] frames the frames to partition
+ *  \param [in] max_size the maximum number of frames in each core
+ *  \param [in] overlap the maximum number of overlap frames of each submap
+ *  \return the submaps covering \p frames
+ */
+MAPTK_EXPORT
+std::vector<camera_submap>
+partition_submaps(vital::track_set const& tracks,
+                  std::vector<vital::frame_id_t> const& frames,
+                  size_t max_size, size_t overlap);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_SUBMAP_PARTITION_H_
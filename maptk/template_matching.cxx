@@ -0,0 +1,344 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of finding image points by template matching
+ */
+
+#include "template_matching.h"
+
+#include <maptk/bounded_task_queue.h>
+
+#include <vital/types/camera_perspective.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+/// Check if the square of half size \p radius around \p loc is in an image
+bool
+window_in_image(vital::vector_2d const& loc, int radius,
+                size_t width, size_t height)
+{
+  // written so that NaN locations are rejected
+  return loc[0] - radius >= 0.0 && loc[1] - radius >= 0.0 &&
+         loc[0] + radius <= static_cast<double>(width) - 1.0 &&
+         loc[1] + radius <= static_cast<double>(height) - 1.0;
+}
+
+/// Sample the gray values of the square of half size \p radius around \p loc
+/**
+ * The square must be inside the image.  All samples share the sub-pixel
+ * offset of \p loc, so each one is a bilinear blend of the same weights.
+ */
+std::vector<float>
+sample_gray_patch(vital::image_of<uint8_t> const& image,
+                  vital::vector_2d const& loc, int radius)
+{
+  size_t const size = static_cast<size_t>(2 * radius + 1);
+  std::vector<float> patch(size * size);
+
+  double const x0 = loc[0] - radius;
+  double const y0 = loc[1] - radius;
+  size_t const i0 = static_cast<size_t>(x0);
+  size_t const j0 = static_cast<size_t>(y0);
+  float const wi = static_cast<float>(x0 - static_cast<double>(i0));
+  float const wj = static_cast<float>(y0 - static_cast<double>(j0));
+
+  ptrdiff_t const istep = image.w_step();
+  ptrdiff_t const jstep = image.h_step();
+  ptrdiff_t const pstep = image.d_step();
+  // without a sub-pixel offset the last sample has no next neighbor
+  ptrdiff_t const di = wi > 0.0f ? istep : 0;
+  ptrdiff_t const dj = wj > 0.0f ? jstep : 0;
+  float const w00 = (1.0f - wi) * (1.0f - wj);
+  float const w10 = wi * (1.0f - wj);
+  float const w01 = (1.0f - wi) * wj;
+  float const w11 = wi * wj;
+
+  // use the luma of color images and the first plane of any others
+  bool const color = image.depth() >= 3;
+  float const cw[3] = { color ? 0.299f : 1.0f,
+                        color ? 0.587f : 0.0f,
+                        color ? 0.114f : 0.0f };
+  int const num_planes = color ? 3 : 1;
+
+  uint8_t const* const origin = image.first_pixel() +
+                                static_cast<ptrdiff_t>(i0) * istep +
+                                static_cast<ptrdiff_t>(j0) * jstep;
+  for (size_t j = 0; j < size; ++j)
+  {
+    for (size_t i = 0; i < size; ++i)
+    {
+      uint8_t const* const p00 = origin + static_cast<ptrdiff_t>(i) * istep +
+                                 static_cast<ptrdiff_t>(j) * jstep;
+      float v = 0.0f;
+      for (int c = 0; c < num_planes; ++c)
+      {
+        uint8_t const* const p = p00 + c * pstep;
+        v += cw[c] * (w00 * p[0] + w10 * p[di] +
+                      w01 * p[dj] + w11 * p[di + dj]);
+      }
+      patch[j * size + i] = v;
+    }
+  }
+  return patch;
+}
+
+/// Find a sampled template in the search window of \p target
+bool
+match_patch(std::vector<float> const& templ,
+            template_matching_options const& options,
+            vital::image_of<uint8_t> const& target,
+            vital::vector_2d const& predicted_loc,
+            vital::vector_2d& target_loc, double* score)
+{
+  int const r = options.template_radius;
+  int const s = options.search_radius;
+  if (!window_in_image(predicted_loc, r + s,
+                       target.width(), target.height()))
+  {
+    return false;
+  }
+  auto const region = sample_gray_patch(target, predicted_loc, r + s);
+
+  size_t const tsize = static_cast<size_t>(2 * r + 1);
+  size_t const rsize = static_cast<size_t>(2 * (r + s) + 1);
+  size_t const ssize = static_cast<size_t>(2 * s + 1);
+  size_t const n = tsize * tsize;
+
+  // remove the mean of the template, which is then reused at every offset
+  double mean = 0.0;
+  for (auto const v : templ)
+  {
+    mean += v;
+  }
+  mean /= static_cast<double>(n);
+  std::vector<double> t(n);
+  double t_norm2 = 0.0;
+  for (size_t k = 0; k < n; ++k)
+  {
+    t[k] = templ[k] - mean;
+    t_norm2 += t[k] * t[k];
+  }
+  // a uniform template matches anything equally well
+  if (t_norm2 < 1e-3 * static_cast<double>(n))
+  {
+    return false;
+  }
+
+  std::vector<double> scores(ssize * ssize, -1.0);
+  size_t best = 0;
+  for (size_t dy = 0; dy < ssize; ++dy)
+  {
+    for (size_t dx = 0; dx < ssize; ++dx)
+    {
+      double sum_tr = 0.0, sum_r = 0.0, sum_r2 = 0.0;
+      for (size_t j = 0; j < tsize; ++j)
+      {
+        float const* const row = region.data() + (dy + j) * rsize + dx;
+        double const* const trow = t.data() + j * tsize;
+        for (size_t i = 0; i < tsize; ++i)
+        {
+          double const v = row[i];
+          sum_tr += trow[i] * v;
+          sum_r += v;
+          sum_r2 += v * v;
+        }
+      }
+      double const var = sum_r2 - sum_r * sum_r / static_cast<double>(n);
+      size_t const k = dy * ssize + dx;
+      if (var > 1e-3 * static_cast<double>(n))
+      {
+        scores[k] = sum_tr / std::sqrt(t_norm2 * var);
+      }
+      if (scores[k] > scores[best])
+      {
+        best = k;
+      }
+    }
+  }
+  if (score)
+  {
+    *score = scores[best];
+  }
+  if (scores[best] < options.min_score)
+  {
+    return false;
+  }
+
+  // fit a parabola through the best score and its neighbors on each axis
+  auto const refine = [](double lo, double mid, double hi)
+  {
+    double const d = lo - 2.0 * mid + hi;
+    return d < 0.0 ? std::max(-0.5, std::min(0.5, 0.5 * (lo - hi) / d))
+                   : 0.0;
+  };
+  size_t const bx = best % ssize;
+  size_t const by = best / ssize;
+  double ox = 0.0, oy = 0.0;
+  if (bx > 0 && bx + 1 < ssize)
+  {
+    ox = refine(scores[best - 1], scores[best], scores[best + 1]);
+  }
+  if (by > 0 && by + 1 < ssize)
+  {
+    oy = refine(scores[best - ssize], scores[best], scores[best + ssize]);
+  }
+  target_loc = predicted_loc +
+               vital::vector_2d(static_cast<double>(bx) - s + ox,
+                                static_cast<double>(by) - s + oy);
+  return true;
+}
+
+/// A frame in which to search for a point
+struct search_frame
+{
+  vital::frame_id_t frame;
+  vital::vector_2d predicted_loc;
+  vital::vector_2d loc;
+  bool found;
+};
+
+}
+
+
+/// Find a template from one image in a window of another image
+bool
+match_template(vital::image const& source, vital::vector_2d const& source_loc,
+               vital::image const& target,
+               vital::vector_2d const& predicted_loc,
+               template_matching_options const& options,
+               vital::vector_2d& target_loc, double* score)
+{
+  vital::image_of<uint8_t> const source_data(source);
+  if (!window_in_image(source_loc, options.template_radius,
+                       source_data.width(), source_data.height()))
+  {
+    return false;
+  }
+  auto const templ =
+    sample_gray_patch(source_data, source_loc, options.template_radius);
+
+  vital::image_of<uint8_t> const target_data(target);
+  return match_patch(templ, options, target_data, predicted_loc,
+                     target_loc, score);
+}
+
+
+/// Find the image observations of a 3D point in many frames
+std::map<vital::frame_id_t, vital::vector_2d>
+match_point_observations(
+  vital::vector_3d const& point,
+  vital::frame_id_t source_frame, vital::vector_2d const& source_loc,
+  vital::camera_map::map_camera_t const& cameras,
+  std::function<vital::image_container_sptr(vital::frame_id_t)> const& images,
+  template_matching_options const& options)
+{
+  std::map<vital::frame_id_t, vital::vector_2d> observations;
+  observations[source_frame] = source_loc;
+
+  auto const source_image = images(source_frame);
+  if (!source_image)
+  {
+    return observations;
+  }
+  vital::image_of<uint8_t> const source_data(source_image->get_image());
+  if (!window_in_image(source_loc, options.template_radius,
+                       source_data.width(), source_data.height()))
+  {
+    return observations;
+  }
+  auto const templ =
+    sample_gray_patch(source_data, source_loc, options.template_radius);
+
+  // predict the location of the point in each frame which can see it, using
+  // the image size of the intrinsics, if known, to skip frames early
+  int const margin = options.template_radius + options.search_radius;
+  std::vector<search_frame> frames;
+  for (auto const& c : cameras)
+  {
+    auto const* const camera =
+      dynamic_cast<vital::camera_perspective const*>(c.second.get());
+    if (c.first == source_frame || !camera || camera->depth(point) <= 0.0)
+    {
+      continue;
+    }
+
+    auto const& predicted_loc = camera->project(point);
+    auto const& intrinsics = camera->intrinsics();
+    if (intrinsics && intrinsics->image_width() > 0 &&
+        intrinsics->image_height() > 0 &&
+        !window_in_image(predicted_loc, margin, intrinsics->image_width(),
+                         intrinsics->image_height()))
+    {
+      continue;
+    }
+    frames.push_back({c.first, predicted_loc, predicted_loc, false});
+  }
+
+  // read the images here, in order, while the pool matches the earlier ones
+  bounded_task_queue matches;
+  for (auto& f : frames)
+  {
+    auto const image = images(f.frame);
+    if (!image)
+    {
+      continue;
+    }
+    auto* const fp = &f;
+    matches.push([&templ, &options, fp, image]()
+    {
+      vital::image_of<uint8_t> const target(image->get_image());
+      fp->found = match_patch(templ, options, target, fp->predicted_loc,
+                              fp->loc, nullptr);
+    });
+  }
+  matches.wait();
+
+  for (auto const& f : frames)
+  {
+    if (f.found)
+    {
+      observations[f.frame] = f.loc;
+    }
+  }
+  return observations;
+}
+
+} // end namespace maptk
+} // end namespace kwiver
@@ -0,0 +1,121 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for finding image points by template matching
+ */
+
+#ifndef MAPTK_TEMPLATE_MATCHING_H_
+#define MAPTK_TEMPLATE_MATCHING_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/types/camera_map.h>
+#include <vital/types/image_container.h>
+#include <vital/types/vector.h>
+
+#include <functional>
+#include <map>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Options for matching an image template
+struct template_matching_options
+{
+  /// The half size of the square template, in pixels
+  int template_radius = 7;
+  /// The half size of the square window searched around a prediction
+  int search_radius = 20;
+  /// The lowest normalized cross-correlation accepted as a match
+  double min_score = 0.8;
+};
+
+/// Find a template from one image in a window of another image
+/**
+ * The template is a square of gray values around \p source_loc in \p source,
+ * which is compared to every integer offset of \p predicted_loc within the
+ * search window of \p target by normalized cross-correlation.  The best
+ * offset is refined to sub-pixel precision by fitting a parabola to the
+ * neighboring scores.  Both images must have 8-bit pixels.
+ *
+ *  \param [in] source the image containing the template
+ *  \param [in] source_loc the center of the template in \p source
+ *  \param [in] target the image in which to search
+ *  \param [in] predicted_loc the center of the search window in \p target
+ *  \param [in] options the template and window sizes and score threshold
+ *  \param [out] target_loc the location of the match in \p target
+ *  \param [out] score if not null, the score of the best match
+ *  \return true if the template and window are inside their images, the
+ *          template is not uniform, and the best score is at least
+ *          \c options.min_score
+ */
+MAPTK_EXPORT
+bool
+match_template(vital::image const& source, vital::vector_2d const& source_loc,
+               vital::image const& target,
+               vital::vector_2d const& predicted_loc,
+               template_matching_options const& options,
+               vital::vector_2d& target_loc, double* score = nullptr);
+
+/// Find the image observations of a 3D point in many frames
+/**
+ * The point is projected into each frame of \p cameras, and the projection
+ * is refined with match_template using a template taken around
+ * \p source_loc in the image of \p source_frame.  Frames in which the point
+ * is behind the camera, or in which the search window falls outside the
+ * image, are skipped.  \p images is only called on the calling thread, first
+ * for \p source_frame and then for each frame searched in increasing frame
+ * order, so it may read frames from a video; the matching runs in the vital
+ * thread pool while further images are read.
+ *
+ *  \param [in] point the 3D point to find
+ *  \param [in] source_frame the frame in which the point was observed
+ *  \param [in] source_loc the observation of the point in \p source_frame
+ *  \param [in] cameras the cameras of the frames to search
+ *  \param [in] images a function returning the image of a frame, or null
+ *  \param [in] options the template and window sizes and score threshold
+ *  \return the observations found, including the source observation
+ */
+MAPTK_EXPORT
+std::map<vital::frame_id_t, vital::vector_2d>
+match_point_observations(
+  vital::vector_3d const& point,
+  vital::frame_id_t source_frame, vital::vector_2d const& source_loc,
+  vital::camera_map::map_camera_t const& cameras,
+  std::function<vital::image_container_sptr(vital::frame_id_t)> const& images,
+  template_matching_options const& options = template_matching_options());
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_TEMPLATE_MATCHING_H_
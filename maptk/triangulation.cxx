@@ -0,0 +1,227 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of parallel landmark triangulation
+ */
+
+#include "triangulation.h"
+
+#include <maptk/parallel_for.h>
+
+#include <vital/algo/triangulate_landmarks.h>
+#include <vital/math_constants.h>
+#include <vital/types/camera_perspective.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <unordered_map>
+
+
+namespace kwiver {
+namespace maptk {
+
+namespace {
+
+/// An observation of a landmark, flattened from its track
+struct observation
+{
+  vital::camera_perspective const* camera;
+  vital::vector_2d loc;
+};
+
+/// Measure the quality of a landmark seen by \p obs
+landmark_quality
+measure_quality(vital::vector_3d const& x,
+                std::vector<observation> const& obs)
+{
+  landmark_quality q;
+  q.num_observations = obs.size();
+  if (obs.empty())
+  {
+    return q;
+  }
+
+  double sum_sq = 0.0;
+  for (auto const& o : obs)
+  {
+    sum_sq += (o.camera->project(x) - o.loc).squaredNorm();
+  }
+  q.rmse = std::sqrt(sum_sq / static_cast<double>(obs.size()));
+
+  // Approximate the largest angle between rays with two linear passes: find
+  // the ray farthest from the first, then the ray farthest from that one
+  auto const ray = [&](size_t i) -> vital::vector_3d {
+    return (obs[i].camera->center() - x).normalized();
+  };
+  auto const farthest = [&](vital::vector_3d const& r, double& min_cos){
+    size_t best = 0;
+    min_cos = 1.0;
+    for (size_t i = 0; i < obs.size(); ++i)
+    {
+      auto const c = r.dot(ray(i));
+      if (c < min_cos)
+      {
+        min_cos = c;
+        best = i;
+      }
+    }
+    return best;
+  };
+  double min_cos;
+  auto const a = farthest(ray(0), min_cos);
+  farthest(ray(a), min_cos);
+  q.angle = std::acos(std::max(-1.0, std::min(1.0, min_cos))) *
+            vital::rad_to_deg;
+  return q;
+}
+
+}
+
+/// Triangulate landmarks from tracks in parallel
+void
+triangulate_tracks(vital::config_block_sptr const& config,
+                   std::string const& block,
+                   vital::camera_map_sptr const& cameras,
+                   vital::feature_track_set_sptr const& tracks,
+                   vital::landmark_map_sptr& landmarks,
+                   std::map<vital::landmark_id_t, landmark_quality>* quality,
+                   double min_angle, double max_rmse)
+{
+  auto const init_lms = landmarks->landmarks();
+  auto const cams = cameras->cameras();
+
+  std::unordered_map<vital::frame_id_t, vital::camera_perspective const*>
+    cam_lookup;
+  for (auto const& c : cams)
+  {
+    auto const cam =
+      dynamic_cast<vital::camera_perspective const*>(c.second.get());
+    if (cam)
+    {
+      cam_lookup.emplace(c.first, cam);
+    }
+  }
+
+  std::vector<vital::track_sptr> to_triangulate;
+  for (auto const& t : tracks->tracks())
+  {
+    if (init_lms.count(t->id()))
+    {
+      to_triangulate.push_back(t);
+    }
+  }
+
+  // Results are written per track and merged afterwards, so that tasks
+  // share no mutable state
+  std::vector<vital::landmark_sptr> results(to_triangulate.size());
+  std::vector<landmark_quality> qualities(to_triangulate.size());
+
+  parallel_for(0, to_triangulate.size(), [&](size_t begin, size_t end){
+    vital::algo::triangulate_landmarks_sptr triangulator;
+    vital::algo::triangulate_landmarks::set_nested_algo_configuration(
+      block, config, triangulator);
+    if (!triangulator)
+    {
+      return;
+    }
+
+    std::vector<vital::track_sptr> chunk_tracks(
+      to_triangulate.begin() + static_cast<std::ptrdiff_t>(begin),
+      to_triangulate.begin() + static_cast<std::ptrdiff_t>(end));
+    vital::landmark_map::map_landmark_t chunk_lms;
+    for (auto const& t : chunk_tracks)
+    {
+      chunk_lms.emplace(t->id(), init_lms.at(t->id()));
+    }
+    auto chunk_tracks_sptr =
+      std::make_shared<vital::feature_track_set>(chunk_tracks);
+    vital::landmark_map_sptr chunk_lm_map =
+      std::make_shared<vital::simple_landmark_map>(chunk_lms);
+    triangulator->triangulate(cameras, chunk_tracks_sptr, chunk_lm_map);
+
+    auto const triangulated = chunk_lm_map->landmarks();
+    std::vector<observation> obs;
+    for (auto i = begin; i < end; ++i)
+    {
+      auto const& t = to_triangulate[i];
+      auto const lm = triangulated.find(t->id());
+      if (lm == triangulated.end() || !lm->second)
+      {
+        continue;
+      }
+
+      obs.clear();
+      for (auto const& ts : *t)
+      {
+        auto const fts =
+          dynamic_cast<vital::feature_track_state const*>(ts.get());
+        auto const c = cam_lookup.find(ts->frame());
+        if (fts && fts->feature && c != cam_lookup.end())
+        {
+          obs.push_back({c->second, fts->feature->loc()});
+        }
+      }
+
+      auto const q = measure_quality(lm->second->loc(), obs);
+      if ((min_angle > 0.0 && q.angle < min_angle) ||
+          (max_rmse > 0.0 && q.rmse > max_rmse))
+      {
+        continue;
+      }
+      results[i] = lm->second;
+      qualities[i] = q;
+    }
+  }, 256);
+
+  vital::landmark_map::map_landmark_t out_lms;
+  if (quality)
+  {
+    quality->clear();
+  }
+  for (size_t i = 0; i < to_triangulate.size(); ++i)
+  {
+    if (results[i])
+    {
+      auto const id = to_triangulate[i]->id();
+      out_lms.emplace(id, results[i]);
+      if (quality)
+      {
+        quality->emplace(id, qualities[i]);
+      }
+    }
+  }
+  landmarks = std::make_shared<vital::simple_landmark_map>(out_lms);
+}
+
+} // end namespace maptk
+} // end namespace kwiver
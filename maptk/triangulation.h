@@ -0,0 +1,99 @@
+/*ckwg +29
+ * Copyright 2019 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Header for parallel landmark triangulation
+ */
+
+#ifndef MAPTK_TRIANGULATION_H_
+#define MAPTK_TRIANGULATION_H_
+
+#include <maptk/maptk_export.h>
+
+#include <vital/config/config_block.h>
+#include <vital/types/camera_map.h>
+#include <vital/types/feature_track_set.h>
+#include <vital/types/landmark_map.h>
+
+#include <map>
+#include <string>
+
+
+namespace kwiver {
+namespace maptk {
+
+/// Quality measures of a triangulated landmark
+struct landmark_quality
+{
+  /// Largest angle (in degrees) between the rays observing the landmark
+  double angle = 0.0;
+  /// Root mean squared reprojection error (in pixels)
+  double rmse = 0.0;
+  /// Number of observations in cameras
+  size_t num_observations = 0;
+};
+
+/// Triangulate landmarks from tracks in parallel
+/**
+ * The tracks with an ID in \p landmarks are split into chunks which are
+ * triangulated concurrently, each by its own instance of the nested
+ * \c triangulate_landmarks algorithm \p block of \p config.  The quality of
+ * every triangulated landmark is then measured, and landmarks whose largest
+ * ray angle is below \p min_angle or whose reprojection RMSE exceeds
+ * \p max_rmse are removed.
+ *
+ *  \param [in] config the configuration containing the nested algorithm
+ *  \param [in] block the name of the nested algorithm block
+ *  \param [in] cameras the cameras from which to triangulate
+ *  \param [in] tracks the tracks from which to triangulate
+ *  \param [in,out] landmarks the landmarks to triangulate, replaced with
+ *                  those successfully triangulated
+ *  \param [out] quality if not null, receives the quality of each landmark
+ *  \param [in] min_angle the smallest allowed ray angle in degrees; zero
+ *              disables this test
+ *  \param [in] max_rmse the largest allowed reprojection RMSE in pixels;
+ *              zero disables this test
+ */
+MAPTK_EXPORT
+void
+triangulate_tracks(vital::config_block_sptr const& config,
+                   std::string const& block,
+                   vital::camera_map_sptr const& cameras,
+                   vital::feature_track_set_sptr const& tracks,
+                   vital::landmark_map_sptr& landmarks,
+                   std::map<vital::landmark_id_t, landmark_quality>* quality =
+                     nullptr,
+                   double min_angle = 0.0, double max_rmse = 0.0);
+
+} // end namespace maptk
+} // end namespace kwiver
+
+#endif // MAPTK_TRIANGULATION_H_
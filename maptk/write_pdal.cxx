@@ -39,15 +39,25 @@
 #include <vital/exceptions/base.h>
 #include <vital/exceptions/io.h>
 
+#include <kwiversys/SystemTools.hxx>
+
 #ifdef TELESCULPTOR_USE_PDAL
 #include <pdal/PointView.hpp>
 #include <pdal/PointTable.hpp>
 #include <pdal/Dimension.hpp>
 #include <pdal/Options.hpp>
+#include <pdal/Reader.hpp>
 #include <pdal/StageFactory.hpp>
-
-#include <io/BufferReader.hpp>
+#include <pdal/pdal_features.hpp>
+#if PDAL_VERSION_MAJOR >= 2
+#include <pdal/Streamable.hpp>
 #endif
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
 
 
 namespace kwiver {
@@ -59,16 +69,20 @@ void
              vital::local_geo_cs const& lgcs,
              vital::landmark_map_sptr const& landmarks)
 {
-  std::vector<vital::vector_3d> points;
-  std::vector<vital::rgb_color> colors;
-  points.reserve(landmarks->size());
-  colors.reserve(landmarks->size());
-  for (auto lm : landmarks->landmarks())
+  // Flatten the landmarks into contiguous buffers for the bulk writer
+  auto const& lms = landmarks->landmarks();
+  std::vector<double> points;
+  std::vector<unsigned char> colors;
+  points.reserve(3 * lms.size());
+  colors.reserve(3 * lms.size());
+  for (auto const& lm : lms)
   {
-    points.push_back(lm.second->loc());
-    colors.push_back(lm.second->color());
+    auto const& loc = lm.second->loc();
+    auto const& rgb = lm.second->color();
+    points.insert(points.end(), { loc[0], loc[1], loc[2] });
+    colors.insert(colors.end(), { rgb.r, rgb.g, rgb.b });
   }
-  write_pdal(filename, lgcs, points, colors);
+  write_pdal(filename, lgcs, points.data(), lms.size(), colors.data());
 }
 
 /// Write point cloud to a file with PDAL
@@ -78,10 +92,10 @@ write_pdal(vital::path_t const& filename,
            std::vector<vital::vector_3d> const& points,
            std::vector<vital::rgb_color> const& colors)
 {
-  namespace kv = kwiver::vital;
-  kv::logger_handle_t logger( kv::get_logger( "write_pdal" ) );
-
-#ifdef TELESCULPTOR_USE_PDAL
+  static_assert(sizeof(vital::vector_3d) == 3 * sizeof(double),
+                "vector_3d must be packed to be written as a buffer");
+  static_assert(sizeof(vital::rgb_color) == 3,
+                "rgb_color must be packed to be written as a buffer");
 
   if( !colors.empty() && colors.size() != points.size() )
   {
@@ -89,6 +103,149 @@ write_pdal(vital::path_t const& filename,
                                "not match the number of points");
   }
 
+  auto const color_data = colors.empty() ? nullptr :
+    reinterpret_cast<unsigned char const*>(colors.data());
+  write_pdal(filename, lgcs, points.empty() ? nullptr : points[0].data(),
+             points.size(), color_data);
+}
+
+namespace {
+
+/// A function which fills up to \c max points into \p xyz, as (x, y, z)
+/// triples, and their colors into \p rgb, if not null, as (r, g, b) triples,
+/// returning the number of points filled in
+using chunk_source =
+  std::function<size_t(double* xyz, uint16_t* rgb, size_t max)>;
+
+#ifdef TELESCULPTOR_USE_PDAL
+
+/// A PDAL reader of points produced a chunk at a time
+/**
+ * Each chunk of points is filled into contiguous coordinate and color
+ * arrays, whose layouts match the X, Y, Z and Red, Green, Blue dimensions,
+ * so each point is stored into the point table as packed data without
+ * converting each field.  In stream mode, PDAL pulls one point at a time
+ * into a fixed size table which is written out when full, so the points are
+ * never all in memory.
+ */
+class source_reader : public pdal::Reader
+#if PDAL_VERSION_MAJOR >= 2
+                    , public pdal::Streamable
+#endif
+{
+public:
+  source_reader(chunk_source const& fill, bool has_colors,
+                vital::vector_3d const& offset, size_t chunk_size)
+    : fill_(fill), has_colors_(has_colors), offset_(offset),
+      chunk_size_(std::max<size_t>(chunk_size, 1)),
+      xyz_(3 * chunk_size_), rgb_(has_colors ? 3 * chunk_size_ : 0),
+      xyz_dims_{ { pdal::Dimension::Id::X, pdal::Dimension::Type::Double },
+                 { pdal::Dimension::Id::Y, pdal::Dimension::Type::Double },
+                 { pdal::Dimension::Id::Z, pdal::Dimension::Type::Double } },
+      rgb_dims_{
+        { pdal::Dimension::Id::Red, pdal::Dimension::Type::Unsigned16 },
+        { pdal::Dimension::Id::Green, pdal::Dimension::Type::Unsigned16 },
+        { pdal::Dimension::Id::Blue, pdal::Dimension::Type::Unsigned16 } }
+  {
+  }
+
+  std::string getName() const override { return "readers.maptk_source"; }
+
+private:
+  void addDimensions(pdal::PointLayoutPtr layout) override
+  {
+    for (auto const& d : xyz_dims_)
+    {
+      layout->registerDim(d.m_id, d.m_type);
+    }
+    if (has_colors_)
+    {
+      for (auto const& d : rgb_dims_)
+      {
+        layout->registerDim(d.m_id, d.m_type);
+      }
+    }
+  }
+
+  bool processOne(pdal::PointRef& point) override
+  {
+    if (next_ == filled_ && !fill_chunk())
+    {
+      return false;
+    }
+    point.setPackedData(xyz_dims_,
+                        reinterpret_cast<char const*>(&xyz_[3 * next_]));
+    if (has_colors_)
+    {
+      point.setPackedData(rgb_dims_,
+                          reinterpret_cast<char const*>(&rgb_[3 * next_]));
+    }
+    ++next_;
+    return true;
+  }
+
+  pdal::point_count_t read(pdal::PointViewPtr view,
+                           pdal::point_count_t count) override
+  {
+    pdal::point_count_t n = 0;
+    while (n < count && (next_ < filled_ || fill_chunk()))
+    {
+      for (; next_ < filled_ && n < count; ++next_, ++n)
+      {
+        auto const id = view->size();
+        view->setPackedPoint(xyz_dims_, id,
+                             reinterpret_cast<char const*>(&xyz_[3 * next_]));
+        if (has_colors_)
+        {
+          view->setPackedPoint(
+            rgb_dims_, id, reinterpret_cast<char const*>(&rgb_[3 * next_]));
+        }
+      }
+    }
+    return n;
+  }
+
+  /// Fill the next chunk of points, returning false if there are no more
+  bool fill_chunk()
+  {
+    next_ = 0;
+    filled_ = fill_(xyz_.data(), has_colors_ ? rgb_.data() : nullptr,
+                    chunk_size_);
+    for (size_t k = 0; k < 3 * filled_; k += 3)
+    {
+      xyz_[k] += offset_[0];
+      xyz_[k + 1] += offset_[1];
+      xyz_[k + 2] += offset_[2];
+    }
+    return filled_ > 0;
+  }
+
+  chunk_source const& fill_;
+  bool has_colors_;
+  vital::vector_3d offset_;
+  size_t chunk_size_;
+  std::vector<double> xyz_;
+  std::vector<uint16_t> rgb_;
+  pdal::DimTypeList xyz_dims_;
+  pdal::DimTypeList rgb_dims_;
+  size_t next_ = 0;
+  size_t filled_ = 0;
+};
+
+#endif
+
+/// Write points produced a chunk at a time to a file with PDAL
+void
+write_pdal_chunks(vital::path_t const& filename,
+                  vital::local_geo_cs const& lgcs,
+                  chunk_source const& fill, bool has_colors,
+                  size_t chunk_size)
+{
+  namespace kv = kwiver::vital;
+  kv::logger_handle_t logger( kv::get_logger( "write_pdal" ) );
+
+#ifdef TELESCULPTOR_USE_PDAL
+
   pdal::Options options;
   options.add("filename", filename);
   options.add("system_id", "TeleSculptor");
@@ -96,24 +253,18 @@ write_pdal(vital::path_t const& filename,
   options.add("offset_y", "auto");
   options.add("offset_z", "auto");
 
-  pdal::PointTable table;
-  table.layout()->registerDim(pdal::Dimension::Id::X);
-  table.layout()->registerDim(pdal::Dimension::Id::Y);
-  table.layout()->registerDim(pdal::Dimension::Id::Z);
-  if( !colors.empty() )
+  auto const ext = kwiversys::SystemTools::LowerCase(
+    kwiversys::SystemTools::GetFilenameLastExtension(filename));
+  if( ext == ".laz" )
   {
-    table.layout()->registerDim(pdal::Dimension::Id::Red);
-    table.layout()->registerDim(pdal::Dimension::Id::Green);
-    table.layout()->registerDim(pdal::Dimension::Id::Blue);
+    options.add("compression", "laszip");
   }
 
   int crs = lgcs.origin().crs();
   kv::vector_3d offset(0.0, 0.0, 0.0);
-  pdal::PointViewPtr view;
   // handle special cases of non-geographic coordinates
   if( crs < 0 )
   {
-    view = std::make_shared<pdal::PointView>(table);
     options.add("scale_x", 1e-4);
     options.add("scale_y", 1e-4);
     options.add("scale_z", 1e-4);
@@ -121,35 +272,31 @@ write_pdal(vital::path_t const& filename,
   else
   {
     offset = lgcs.origin().location();
-    std::string srs_name = "EPSG:" + std::to_string(crs);
-    pdal::SpatialReference srs;
-    srs = pdal::SpatialReference(srs_name);
-    view = std::make_shared<pdal::PointView>(table, srs);
-  }
-
-  for( unsigned int id=0; id < points.size(); ++id )
-  {
-    kv::vector_3d pt = points[id] + offset;
-    view->setField(pdal::Dimension::Id::X, id, pt.x());
-    view->setField(pdal::Dimension::Id::Y, id, pt.y());
-    view->setField(pdal::Dimension::Id::Z, id, pt.z());
-    if (!colors.empty())
-    {
-      kv::rgb_color const& rgb = colors[id];
-      view->setField(pdal::Dimension::Id::Red, id, rgb.r);
-      view->setField(pdal::Dimension::Id::Green, id, rgb.g);
-      view->setField(pdal::Dimension::Id::Blue, id, rgb.b);
-    }
+    options.add("a_srs", "EPSG:" + std::to_string(crs));
   }
 
-  pdal::BufferReader reader;
-  reader.addView(view);
+  source_reader reader(fill, has_colors, offset, chunk_size);
 
   pdal::StageFactory factory;
   pdal::Stage *writer = factory.createStage("writers.las");
 
   writer->setInput(reader);
   writer->setOptions(options);
+
+#if PDAL_VERSION_MAJOR >= 2
+  if( writer->pipelineStreamable() )
+  {
+    // Stream the points through a fixed size table
+    pdal::FixedPointTable table(std::max<size_t>(chunk_size, 1));
+    writer->prepare(table);
+    writer->execute(table);
+    return;
+  }
+  LOG_DEBUG(logger, "PDAL pipeline is not streamable, "
+                    "writing all points at once");
+#endif
+
+  pdal::PointTable table;
   writer->prepare(table);
   writer->execute(table);
 
@@ -161,6 +308,78 @@ write_pdal(vital::path_t const& filename,
 #endif
 }
 
+/// Write point cloud from contiguous buffers with PDAL
+template <typename T>
+void
+write_pdal_buffer(vital::path_t const& filename,
+                  vital::local_geo_cs const& lgcs,
+                  T const* points, size_t num_points,
+                  unsigned char const* colors, size_t chunk_size)
+{
+  size_t i = 0;
+  chunk_source const fill = [&](double* xyz, uint16_t* rgb, size_t max)
+  {
+    size_t const n = std::min(max, num_points - i);
+    std::copy(points + 3 * i, points + 3 * (i + n), xyz);
+    if (rgb)
+    {
+      std::copy(colors + 3 * i, colors + 3 * (i + n), rgb);
+    }
+    i += n;
+    return n;
+  };
+  write_pdal_chunks(filename, lgcs, fill, colors != nullptr, chunk_size);
+}
+
+}
+
+/// Write points produced by a function to a file with PDAL
+void
+write_pdal(vital::path_t const& filename,
+           vital::local_geo_cs const& lgcs,
+           point_source const& next, bool has_colors,
+           size_t chunk_size)
+{
+  chunk_source const fill = [&](double* xyz, uint16_t* rgb, size_t max)
+  {
+    size_t n = 0;
+    vital::vector_3d pt;
+    vital::rgb_color c;
+    for (; n < max && next(pt, c); ++n)
+    {
+      std::copy(pt.data(), pt.data() + 3, xyz + 3 * n);
+      if (rgb)
+      {
+        rgb[3 * n] = c.r;
+        rgb[3 * n + 1] = c.g;
+        rgb[3 * n + 2] = c.b;
+      }
+    }
+    return n;
+  };
+  write_pdal_chunks(filename, lgcs, fill, has_colors, chunk_size);
+}
+
+/// Write point cloud from contiguous buffers to a file with PDAL
+void
+write_pdal(vital::path_t const& filename,
+           vital::local_geo_cs const& lgcs,
+           double const* points, size_t num_points,
+           unsigned char const* colors, size_t chunk_size)
+{
+  write_pdal_buffer(filename, lgcs, points, num_points, colors, chunk_size);
+}
+
+/// Write point cloud from contiguous single precision buffers with PDAL
+void
+write_pdal(vital::path_t const& filename,
+           vital::local_geo_cs const& lgcs,
+           float const* points, size_t num_points,
+           unsigned char const* colors, size_t chunk_size)
+{
+  write_pdal_buffer(filename, lgcs, points, num_points, colors, chunk_size);
+}
+
 
 } // end namespace maptk
 } // end namespace kwiver
@@ -42,10 +42,19 @@
 #include <vital/types/local_geo_cs.h>
 #include <vital/types/landmark_map.h>
 
+#include <functional>
+
 
 namespace kwiver {
 namespace maptk {
 
+/// A function producing the next point of a cloud and its color
+/**
+ * The function returns false, without setting its arguments, when there are
+ * no more points.
+ */
+typedef std::function<bool(vital::vector_3d&, vital::rgb_color&)>
+  point_source;
 
 /// Write landmarks to a file with PDAL
 MAPTK_EXPORT
@@ -62,6 +71,42 @@ write_pdal(vital::path_t const& filename,
            std::vector<vital::vector_3d> const& points,
            std::vector<vital::rgb_color> const& colors = {});
 
+/// Write point cloud from contiguous buffers to a file with PDAL
+/**
+ * \p points holds \p num_points (x, y, z) triples and \p colors, if not
+ * null, holds \p num_points (r, g, b) triples.  The points are streamed to
+ * the LAS writer in chunks of \p chunk_size points, copying only one chunk
+ * at a time, so memory use does not grow with the size of the cloud.  If the
+ * file name ends in ".laz" the output is compressed.
+ */
+MAPTK_EXPORT
+void
+write_pdal(vital::path_t const& filename,
+           vital::local_geo_cs const& lgcs,
+           double const* points, size_t num_points,
+           unsigned char const* colors = nullptr,
+           size_t chunk_size = 65536);
+
+/// Write point cloud from contiguous single precision buffers with PDAL
+MAPTK_EXPORT
+void
+write_pdal(vital::path_t const& filename,
+           vital::local_geo_cs const& lgcs,
+           float const* points, size_t num_points,
+           unsigned char const* colors = nullptr,
+           size_t chunk_size = 65536);
+
+/// Write points produced by a function to a file with PDAL
+/**
+ * The points are pulled from \p next in chunks of \p chunk_size points as
+ * the LAS writer needs them, so the cloud never needs to be in memory.
+ */
+MAPTK_EXPORT
+void
+write_pdal(vital::path_t const& filename,
+           vital::local_geo_cs const& lgcs,
+           point_source const& next, bool has_colors,
+           size_t chunk_size = 65536);
 
 } // end namespace maptk
 } // end namespace kwiver
@@ -36,6 +36,7 @@
 #include "tool_common.h"
 
 #include <iostream>
+#include <map>
 #include <fstream>
 #include <sstream>
 #include <exception>
@@ -69,6 +70,7 @@
 #include <arrows/core/transform.h>
 
 #include <maptk/geo_reference_points_io.h>
+#include <maptk/triangulation.h>
 #include <vital/types/local_geo_cs.h>
 #include <maptk/version.h>
 
@@ -118,6 +120,13 @@ static kwiver::vital::config_block_sptr default_config()
                     "\n"
                     "Landmark z position, or altitude, should be provided in meters.");
 
+  config->set_value("reference_points_cache_file", "",
+                    "Optional binary cache of the parsed "
+                    "input_reference_points_file. If the cache matches the "
+                    "contents of the reference file it is loaded instead of "
+                    "parsing the text; otherwise it is rewritten. Leave blank "
+                    "to always parse the text.");
+
   config->set_value("geo_origin_file", "output/geo_origin.txt",
                     "This file contains the geographical location of the origin "
                     "of the local cartesian coordinate system used in the camera "
@@ -419,7 +428,9 @@ static int maptk_main(int argc, char const* argv[])
 
     // Load up landmarks and assocaited tracks from file, (re)initializing
     // local coordinate system object to the reference.
-    kwiver::maptk::load_reference_file(ref_file, local_cs, reference_landmarks, reference_tracks);
+    kwiver::maptk::load_reference_file(
+      ref_file, local_cs, reference_landmarks, reference_tracks,
+      config->get_value<kwiver::vital::path_t>("reference_points_cache_file", ""));
   }
 
   // if we computed an origin that was not loaded from a file
@@ -463,7 +474,19 @@ static int maptk_main(int argc, char const* argv[])
       LOG_INFO(main_logger, "Triangulating SBA-space reference landmarks from "
                             << "reference tracks and post-SBA cameras");
       kwiver::vital::landmark_map_sptr sba_space_landmarks(new kwiver::vital::simple_landmark_map(reference_landmarks->landmarks()));
-      triangulator->triangulate(cam_map, reference_tracks, sba_space_landmarks);
+      std::map<kwiver::vital::landmark_id_t,
+               kwiver::maptk::landmark_quality> quality;
+      kwiver::maptk::triangulate_tracks(config, "triangulator", cam_map,
+                                        reference_tracks, sba_space_landmarks,
+                                        &quality);
+      for (auto const& q : quality)
+      {
+        LOG_DEBUG(main_logger, "Reference landmark " << q.first
+                               << ": triangulation angle " << q.second.angle
+                               << " deg, RMSE " << q.second.rmse
+                               << " px, " << q.second.num_observations
+                               << " observations");
+      }
       if (sba_space_landmarks->size() < reference_landmarks->size())
       {
         LOG_WARN(main_logger, "Only " << sba_space_landmarks->size()
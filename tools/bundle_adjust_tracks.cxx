@@ -35,11 +35,17 @@
 
 #include "tool_common.h"
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <fstream>
 #include <sstream>
 #include <exception>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <vital/config/config_block.h>
@@ -58,6 +64,7 @@
 #include <vital/io/metadata_io.h>
 #include <vital/io/track_set_io.h>
 #include <vital/plugin_loader/plugin_manager.h>
+#include <vital/types/camera_perspective_map.h>
 #include <vital/types/feature_track_set.h>
 #include <vital/vital_types.h>
 #include <vital/types/geodesy.h>
@@ -72,8 +79,16 @@
 #include <arrows/core/necker_reverse.h>
 #include <arrows/core/transform.h>
 
+#include <maptk/camera_binary_io.h>
+#include <maptk/camera_resection.h>
 #include <maptk/colorize.h>
 #include <maptk/geo_reference_points_io.h>
+#include <maptk/keyframe_selection.h>
+#include <maptk/parallel_for.h>
+#include <maptk/residual_statistics.h>
+#include <maptk/robust_bounds.h>
+#include <maptk/submap_partition.h>
+#include <maptk/triangulation.h>
 #include <vital/types/local_geo_cs.h>
 #include <maptk/version.h>
 
@@ -102,7 +117,8 @@ static kwiver::vital::config_block_sptr default_config()
                     "Enables initialization of cameras from video metadata."
                     "\n"
                     "This is mutually exclusive with the input_krtd_files "
-                    "option for system initialization, and shadowed by the "
+                    "and input_camera_file options for system "
+                    "initialization, and shadowed by the "
                     "input_reference_points option when using an "
                     "st_estimator.");
 
@@ -113,6 +129,15 @@ static kwiver::vital::config_block_sptr default_config()
                     "option for system initialization, and shadowed by the "
                     "input_reference_points_file when using an st_estimator.");
 
+  config->set_value("input_camera_file", "",
+                    "A binary camera file holding all input cameras, as "
+                    "written by the output_camera_file option of pos2krtd.\n"
+                    "\n"
+                    "This is mutually exclusive with the input_krtd_files and "
+                    "init_cameras_with_metadata options for system "
+                    "initialization, and shadowed by the "
+                    "input_reference_points_file when using an st_estimator.");
+
   config->set_value("input_reference_points_file", "",
                     "File containing reference points to use for reprojection "
                     "of results into the geographic coordinate system.\n"
@@ -135,6 +160,13 @@ static kwiver::vital::config_block_sptr default_config()
                     "\n"
                     "Landmark z position, or altitude, should be provided in meters.");
 
+  config->set_value("reference_points_cache_file", "",
+                    "Optional binary cache of the parsed "
+                    "input_reference_points_file. If the cache matches the "
+                    "contents of the reference file it is loaded instead of "
+                    "parsing the text; otherwise it is rewritten. Leave blank "
+                    "to always parse the text.");
+
   config->set_value("initialize_unloaded_cameras", "true",
                     "When loading a subset of cameras, should we optimize only the "
                     "loaded cameras or also initialize and optimize the unspecified cameras");
@@ -153,6 +185,40 @@ static kwiver::vital::config_block_sptr default_config()
                     "Path to the output PLY file in which to write "
                     "resulting 3D landmark points");
 
+  config->set_value("landmark_color_mode", "mean",
+                    "How the colors of the feature observations of each "
+                    "landmark are combined into the landmark color. "
+                    "\"mean\" averages them, \"median\" takes the per "
+                    "channel median, which is robust to occlusions, and "
+                    "\"weighted\" averages them weighted by the inverse "
+                    "distance to the observing camera.");
+
+  config->set_value("landmark_color_from_video", "false",
+                    "If true, sample the landmark colors from the images of "
+                    "video_source at the feature locations instead of using "
+                    "the colors stored with the features. This requires a "
+                    "video_reader which provides images.");
+
+  config->set_value("output_roi_file", "",
+                    "Path to an output file in which to write a region of "
+                    "interest around the resulting landmarks which is robust "
+                    "to outliers, for use as the default region for depth "
+                    "map fusion. The region is written on one line as "
+                    "\"xmin ymin zmin xmax ymax zmax\", the same format as "
+                    "the ROI in a project file.");
+
+  config->set_value("output_residuals_file", "",
+                    "Path to an output file in which to write reprojection "
+                    "error statistics of the resulting cameras.  Each line "
+                    "holds a frame number, the number of observations, the "
+                    "number of inliers, the RMSE and the maximum error, "
+                    "followed by the counts of the error histogram.");
+
+  config->set_value("residual_inlier_threshold", "2.0",
+                    "Reprojection error (in pixels) below which an "
+                    "observation is counted as an inlier in the logged and "
+                    "written error statistics.");
+
   config->set_value("output_pos_dir", "output/pos",
                     "A directory in which to write the output POS files.");
 
@@ -164,6 +230,41 @@ static kwiver::vital::config_block_sptr default_config()
                     "Set to 1 to use all cameras, "
                     "2 to use every other camera, etc.");
 
+  config->set_value("camera_sample_mode", "uniform",
+                    "How cameras are chosen when sub-sampling by "
+                    "camera_sample_rate. \"uniform\" keeps every Nth camera. "
+                    "\"coverage\" keeps the same number of cameras, chosen "
+                    "greedily from the track co-visibility graph to cover "
+                    "the most tracks with the widest baselines.");
+
+  config->set_value("resect_missing_cameras", "false",
+                    "After bundle adjustment, estimate a camera for every "
+                    "frame with tracks but no camera (e.g. frames left out "
+                    "by camera_sample_rate) by resection against the "
+                    "landmarks. Frames are resected in parallel using the "
+                    "nested algorithms of the \"resection\" block.");
+
+  config->set_value("resection:min_inliers", "10",
+                    "Minimum number of inlier landmark observations needed "
+                    "to accept a resected camera.");
+
+  config->set_value("submap_size", "0",
+                    "Maximum number of cameras in each submap for partitioned "
+                    "bundle adjustment. Submaps are grown from cameras which "
+                    "share the most tracks and are optimized in parallel, "
+                    "followed by a refinement of the cameras and landmarks "
+                    "shared between submaps. Set to 0 to optimize all cameras "
+                    "together.");
+
+  config->set_value("submap_overlap", "20",
+                    "Number of cameras from neighboring submaps to include in "
+                    "each submap when using partitioned bundle adjustment.");
+
+  config->set_value("submap_iterations", "1",
+                    "Number of alternations between optimizing the submaps "
+                    "and the cameras and landmarks shared between them when "
+                    "using partitioned bundle adjustment.");
+
   config->set_value("necker_reverse_input", "false",
                     "Apply a Necker reversal to the initial cameras and landmarks");
 
@@ -208,6 +309,7 @@ static kwiver::vital::config_block_sptr default_config()
                                                                      kwiver::vital::algo::estimate_similarity_transform_sptr());
   kwiver::vital::algo::estimate_canonical_transform::get_nested_algo_configuration("can_tfm_estimator", config,
                                                                      kwiver::vital::algo::estimate_canonical_transform_sptr());
+  kwiver::maptk::get_resection_configuration(config->subblock_view("resection"));
 
   return config;
 }
@@ -255,9 +357,18 @@ static bool check_config(kwiver::vital::config_block_sptr config)
       MAPTK_CONFIG_FAIL("KRTD input path given, but does not point to an existing location.");
     }
   }
-  if (input_metadata && input_krtd)
+  bool input_binary = false;
+  if (config->get_value<std::string>("input_camera_file", "") != "")
   {
-    MAPTK_CONFIG_FAIL("Both input metadata and KRTD cameras were given. Don't know which to use!");
+    input_binary = true;
+    if (! ST::FileExists(config->get_value<std::string>("input_camera_file"), true))
+    {
+      MAPTK_CONFIG_FAIL("Binary camera file path given, but does not point to an existing file.");
+    }
+  }
+  if ((input_metadata ? 1 : 0) + (input_krtd ? 1 : 0) + (input_binary ? 1 : 0) > 1)
+  {
+    MAPTK_CONFIG_FAIL("More than one of input metadata, KRTD cameras and a binary camera file were given. Don't know which to use!");
   }
   if (config->get_value<std::string>("input_reference_points_file", "") != "")
   {
@@ -289,6 +400,11 @@ static bool check_config(kwiver::vital::config_block_sptr config)
   {
     MAPTK_CONFIG_FAIL("Failed config check in triangulator algorithm.");
   }
+  if (config->get_value<bool>("resect_missing_cameras", false) &&
+      !kwiver::maptk::check_resection_configuration(config->subblock_view("resection")))
+  {
+    MAPTK_CONFIG_FAIL("Failed config check in resection algorithms.");
+  }
   if (config->has_value("st_estimator:type") && config->get_value<std::string>("st_estimator:type") != "")
   {
     if (!kwiver::vital::algo::estimate_similarity_transform::check_nested_algo_configuration("st_estimator", config))
@@ -353,6 +469,291 @@ subsample_cameras(kwiver::vital::camera_map_sptr cameras, unsigned factor)
   return kwiver::vital::camera_map_sptr(new kwiver::vital::simple_camera_map(sub_cams));
 }
 
+// ------------------------------------------------------------------
+/// Bundle adjust cameras and landmarks in overlapping submaps
+/**
+ * The cameras are partitioned into submaps by track co-visibility.  Cameras
+ * in the overlap of any submap are separators; every other camera belongs to
+ * exactly one submap.  A landmark belongs to a submap if all of its
+ * non-separator observers do, and is otherwise a separator landmark.
+ *
+ * Each iteration first optimizes the non-separator cameras and landmarks of
+ * every submap in parallel, holding the separators (and landmarks owned by
+ * other submaps) fixed, so the submap problems share no free parameters.  A
+ * global refinement of only the separator cameras and landmarks follows,
+ * holding everything else fixed.
+ */
+void
+submap_bundle_adjust(kwiver::vital::config_block_sptr config,
+                     kwiver::vital::camera_map_sptr& cam_map,
+                     kwiver::vital::landmark_map_sptr& lm_map,
+                     kwiver::vital::feature_track_set_sptr tracks,
+                     size_t submap_size, size_t overlap, unsigned iterations)
+{
+  namespace kv = kwiver::vital;
+  typedef std::map<kv::frame_id_t, kv::camera_perspective_sptr> cam_map_t;
+  typedef kv::landmark_map::map_landmark_t lm_map_t;
+
+  kv::simple_camera_perspective_map input_cams;
+  input_cams.set_from_base_camera_map(cam_map->cameras());
+  cam_map_t cams;
+  for (auto const& c : input_cams.T_cameras())
+  {
+    if (c.second)
+    {
+      cams.insert(c);
+    }
+  }
+  lm_map_t lms;
+  for (auto const& l : lm_map->landmarks())
+  {
+    if (l.second)
+    {
+      lms.insert(l);
+    }
+  }
+
+  std::vector<kv::frame_id_t> frames;
+  for (auto const& c : cams)
+  {
+    frames.push_back(c.first);
+  }
+  auto const submaps =
+    kwiver::maptk::partition_submaps(*tracks, frames, submap_size, overlap);
+  LOG_INFO(main_logger, "Partitioned " << frames.size() << " cameras into "
+                        << submaps.size() << " submaps");
+
+  // Find the separator cameras and the submap owning every other camera
+  std::set<kv::frame_id_t> separators;
+  std::unordered_map<kv::frame_id_t, int> camera_owner;
+  for (size_t i = 0; i < submaps.size(); ++i)
+  {
+    separators.insert(submaps[i].overlap.begin(), submaps[i].overlap.end());
+    for (auto const f : submaps[i].core)
+    {
+      camera_owner[f] = static_cast<int>(i);
+    }
+  }
+  for (auto const f : separators)
+  {
+    camera_owner.erase(f);
+  }
+
+  // Assign each landmark to the submap owning all of its non-separator
+  // observers, if any, and collect the cameras needed to optimize each part
+  struct submap_problem
+  {
+    std::set<kv::frame_id_t> cameras;
+    std::set<kv::landmark_id_t> landmarks;
+    std::set<kv::landmark_id_t> fixed_landmarks;
+  };
+  std::vector<submap_problem> problems(submaps.size());
+  submap_problem separator_problem;
+  separator_problem.cameras = separators;
+
+  for (auto const& t : tracks->tracks())
+  {
+    auto const lm_id = t->id();
+    if (!lms.count(lm_id))
+    {
+      continue;
+    }
+
+    std::set<int> owners;
+    std::vector<kv::frame_id_t> observers;
+    std::vector<std::pair<int, kv::frame_id_t>> owned_observers;
+    bool seen_by_separator = false;
+    for (auto const& ts : *t)
+    {
+      auto const f = ts->frame();
+      if (!cams.count(f))
+      {
+        continue;
+      }
+      observers.push_back(f);
+      auto const o = camera_owner.find(f);
+      if (o != camera_owner.end())
+      {
+        owners.insert(o->second);
+        owned_observers.emplace_back(o->second, f);
+      }
+      else
+      {
+        seen_by_separator = true;
+      }
+    }
+
+    if (owners.size() == 1)
+    {
+      auto& p = problems[*owners.begin()];
+      p.landmarks.insert(lm_id);
+      p.cameras.insert(observers.begin(), observers.end());
+      if (seen_by_separator)
+      {
+        separator_problem.fixed_landmarks.insert(lm_id);
+      }
+    }
+    else
+    {
+      // Landmarks shared between submaps still constrain the cameras of
+      // each submap which observe them
+      for (auto const& o : owned_observers)
+      {
+        problems[o.first].fixed_landmarks.insert(lm_id);
+        problems[o.first].cameras.insert(o.second);
+      }
+      separator_problem.landmarks.insert(lm_id);
+      separator_problem.cameras.insert(observers.begin(), observers.end());
+    }
+  }
+
+  // Problems are optimized concurrently, so they must only read the shared
+  // cameras and landmarks
+  cam_map_t const& in_cams = cams;
+  lm_map_t const& in_lms = lms;
+
+  // Build and optimize a problem, returning the optimized values
+  auto const optimize =
+    [&](kv::algo::bundle_adjust_sptr const& ba, submap_problem const& p,
+        cam_map_t& out_cams, lm_map_t& out_lms)
+  {
+    // Cameras and landmarks are cloned so that concurrent problems never
+    // share (fixed) objects
+    kv::simple_camera_perspective_map sub_cams;
+    std::set<kv::frame_id_t> fixed_cams;
+    for (auto const f : p.cameras)
+    {
+      sub_cams.insert(f, std::static_pointer_cast<kv::camera_perspective>(
+                           in_cams.at(f)->clone()));
+      auto const o = camera_owner.find(f);
+      bool const free_cam = (&p == &separator_problem)
+                            ? (o == camera_owner.end())
+                            : (o != camera_owner.end() &&
+                               &problems[o->second] == &p);
+      if (!free_cam)
+      {
+        fixed_cams.insert(f);
+      }
+    }
+
+    lm_map_t sub_lms;
+    auto const add_landmark = [&](kv::landmark_id_t id)
+    {
+      auto const l = in_lms.find(id);
+      if (l != in_lms.end())
+      {
+        sub_lms[id] = l->second->clone();
+      }
+    };
+    for (auto const id : p.landmarks)
+    {
+      add_landmark(id);
+    }
+    for (auto const id : p.fixed_landmarks)
+    {
+      add_landmark(id);
+    }
+
+    ba->optimize(sub_cams, sub_lms, tracks, fixed_cams, p.fixed_landmarks);
+
+    for (auto const& c : sub_cams.T_cameras())
+    {
+      if (!fixed_cams.count(c.first))
+      {
+        out_cams[c.first] = c.second;
+      }
+    }
+    for (auto const id : p.landmarks)
+    {
+      auto const l = sub_lms.find(id);
+      if (l != sub_lms.end() && l->second)
+      {
+        out_lms[id] = l->second;
+      }
+    }
+  };
+
+  // Submap problems are optimized concurrently, so split the bundle
+  // adjuster's threads among them rather than oversubscribing the CPU
+  auto const submap_config = kv::config_block::empty_config();
+  submap_config->merge_config(config);
+  {
+    auto const concurrent = std::min<size_t>(
+      problems.size(), kv::thread_pool::instance().num_threads() + 1);
+    auto const threads_key = "bundle_adjuster:" +
+      config->get_value<std::string>("bundle_adjuster:type", "") +
+      ":num_threads";
+    if (concurrent > 1 && config->has_value(threads_key))
+    {
+      auto const num_threads = config->get_value<size_t>(threads_key);
+      submap_config->set_value(
+        threads_key, std::max<size_t>(1, num_threads / concurrent));
+    }
+  }
+
+  for (unsigned iter = 0; iter < iterations; ++iter)
+  {
+    {
+      kwiver::vital::scoped_cpu_timer t( "--> optimizing submaps" );
+
+      // Each task uses its own instance of the bundle adjuster
+      std::vector<cam_map_t> out_cams(problems.size());
+      std::vector<lm_map_t> out_lms(problems.size());
+      kwiver::maptk::parallel_for(
+        0, problems.size(), [&](size_t begin, size_t end){
+          kv::algo::bundle_adjust_sptr ba;
+          kv::algo::bundle_adjust::set_nested_algo_configuration(
+            "bundle_adjuster", submap_config, ba);
+          for (auto i = begin; i < end; ++i)
+          {
+            optimize(ba, problems[i], out_cams[i], out_lms[i]);
+          }
+        }, 1);
+
+      for (size_t i = 0; i < problems.size(); ++i)
+      {
+        for (auto const& c : out_cams[i])
+        {
+          cams[c.first] = c.second;
+        }
+        for (auto const& l : out_lms[i])
+        {
+          lms[l.first] = l.second;
+        }
+      }
+    }
+
+    if (!separator_problem.cameras.empty())
+    {
+      kwiver::vital::scoped_cpu_timer t( "--> optimizing separators" );
+
+      kv::algo::bundle_adjust_sptr ba;
+      kv::algo::bundle_adjust::set_nested_algo_configuration(
+        "bundle_adjuster", config, ba);
+
+      cam_map_t sep_cams;
+      lm_map_t sep_lms;
+      optimize(ba, separator_problem, sep_cams, sep_lms);
+      for (auto const& c : sep_cams)
+      {
+        cams[c.first] = c.second;
+      }
+      for (auto const& l : sep_lms)
+      {
+        lms[l.first] = l.second;
+      }
+    }
+  }
+
+  kv::camera_map::map_camera_t out_cams = cam_map->cameras();
+  for (auto const& c : cams)
+  {
+    out_cams[c.first] = c.second;
+  }
+  cam_map = std::make_shared<kv::simple_camera_map>(out_cams);
+  lm_map = std::make_shared<kv::simple_landmark_map>(lms);
+}
+
 
 // Generic configuration based input camera load function.
 //
@@ -392,6 +793,15 @@ bool load_input_cameras(kwiver::vital::config_block_sptr config,
       return false;
     }
   }
+  else if (config->get_value<std::string>("input_camera_file", "") != "")
+  {
+    input_cameras = kwiver::maptk::read_camera_binary_file(
+      config->get_value<kwiver::vital::path_t>("input_camera_file"));
+    if (input_cameras.empty())
+    {
+      return false;
+    }
+  }
 
   // No input specified
   return true;
@@ -580,6 +990,7 @@ static int maptk_main(int argc, char const* argv[])
     std::string basename = kwiver::vital::basename_from_metadata(md, frame);
     basename_map[frame] = basename;
   }
+  video_reader->close();
 
   //
   // Create the local coordinate system
@@ -639,7 +1050,9 @@ static int maptk_main(int argc, char const* argv[])
 
     // Load up landmarks and assocaited tracks from file, (re)initializing
     // local coordinate system object to the reference.
-    kwiver::maptk::load_reference_file(ref_file, local_cs, reference_landmarks, reference_tracks);
+    kwiver::maptk::load_reference_file(
+      ref_file, local_cs, reference_landmarks, reference_tracks,
+      config->get_value<kwiver::vital::path_t>("reference_points_cache_file", ""));
   }
 
   // if we computed an origin that was not loaded from a file
@@ -694,7 +1107,36 @@ static int maptk_main(int argc, char const* argv[])
       cam_map = kwiver::vital::camera_map_sptr(new kwiver::vital::simple_camera_map(cameras));
     }
 
-    kwiver::vital::camera_map_sptr subsampled_cams = subsample_cameras(cam_map, cam_samp_rate);
+    kwiver::vital::camera_map_sptr subsampled_cams;
+    auto const samp_mode = config->get_value<std::string>("camera_sample_mode",
+                                                          "uniform");
+    if (samp_mode == "coverage")
+    {
+      kwiver::vital::camera_map::map_camera_t cams = cam_map->cameras(),
+                                              sub_cams;
+      std::vector<kwiver::vital::frame_id_t> frames;
+      for (auto const& p : cams)
+      {
+        frames.push_back(p.first);
+      }
+      auto const budget = (frames.size() + cam_samp_rate - 1) / cam_samp_rate;
+      for (auto const f :
+           kwiver::maptk::select_keyframes(*tracks, frames, budget))
+      {
+        sub_cams.insert(*cams.find(f));
+      }
+      subsampled_cams = std::make_shared<kwiver::vital::simple_camera_map>(
+                          sub_cams);
+    }
+    else
+    {
+      if (samp_mode != "uniform")
+      {
+        LOG_WARN(main_logger, "Unknown camera_sample_mode \"" << samp_mode
+                              << "\", using uniform sub-sampling");
+      }
+      subsampled_cams = subsample_cameras(cam_map, cam_samp_rate);
+    }
 
     // If we were given reference landmarks and tracks, make sure to include
     // the cameras for frames reference track states land on. Required for
@@ -736,20 +1178,64 @@ static int maptk_main(int argc, char const* argv[])
   { // scope block
     kwiver::vital::scoped_cpu_timer t( "Tool-level SBA algorithm" );
 
-    double init_rmse = kwiver::arrows::reprojection_rmse(cam_map->cameras(),
-                                                        lm_map->landmarks(),
-                                                        tracks->tracks());
-    LOG_DEBUG(main_logger, "initial reprojection RMSE: " << init_rmse);
+    kwiver::maptk::residual_statistics stats(
+      config->get_value<double>("residual_inlier_threshold", 2.0));
+    stats.compute(cam_map->cameras(), lm_map->landmarks(), tracks->tracks());
+    LOG_INFO(main_logger, "initial reprojection RMSE: "
+                          << stats.overall().rmse() << ", inliers: "
+                          << stats.overall().num_inliers << " of "
+                          << stats.overall().num_observations);
 
-    bundle_adjuster->optimize(cam_map, lm_map, tracks);
+    auto const submap_size = config->get_value<size_t>("submap_size", 0);
+    if (submap_size > 0 && cam_map->size() > submap_size)
+    {
+      submap_bundle_adjust(config, cam_map, lm_map, tracks, submap_size,
+                           config->get_value<size_t>("submap_overlap", 20),
+                           config->get_value<unsigned>("submap_iterations", 1));
+    }
+    else
+    {
+      bundle_adjuster->optimize(cam_map, lm_map, tracks);
+    }
 
-    double end_rmse = kwiver::arrows::reprojection_rmse(cam_map->cameras(),
-                                                       lm_map->landmarks(),
-                                                       tracks->tracks());
-    LOG_DEBUG(main_logger, "final reprojection RMSE: " << end_rmse);
+    stats.compute(cam_map->cameras(), lm_map->landmarks(), tracks->tracks());
+    LOG_INFO(main_logger, "final reprojection RMSE: "
+                          << stats.overall().rmse() << ", inliers: "
+                          << stats.overall().num_inliers << " of "
+                          << stats.overall().num_observations);
   }
 
 
+  //
+  // Fill in the cameras which were not optimized by resection
+  //
+  if (config->get_value<bool>("resect_missing_cameras", false))
+  {
+    kwiver::vital::scoped_cpu_timer t( "resecting missing cameras" );
+
+    auto cams = cam_map->cameras();
+    std::vector<kwiver::vital::frame_id_t> missing;
+    for (auto const f : tracks->all_frame_ids())
+    {
+      auto const c = cams.find(f);
+      if (c == cams.end() || !c->second)
+      {
+        missing.push_back(f);
+      }
+    }
+
+    auto const resected = kwiver::maptk::resect_cameras(
+      config->subblock_view("resection"), missing, cams, lm_map->landmarks(),
+      *tracks, config->get_value<size_t>("resection:min_inliers", 10));
+    for (auto const& c : resected)
+    {
+      cams[c.first] = c.second;
+    }
+    cam_map = std::make_shared<kwiver::vital::simple_camera_map>(cams);
+    LOG_INFO(main_logger, "Resected " << resected.size() << " of "
+                          << missing.size() << " missing cameras");
+  }
+
   //
   // Adjust cameras/landmarks based on input cameras/reference points
   //
@@ -781,7 +1267,19 @@ static int maptk_main(int argc, char const* argv[])
       LOG_INFO(main_logger, "Triangulating SBA-space reference landmarks from "
                             << "reference tracks and post-SBA cameras");
       kwiver::vital::landmark_map_sptr sba_space_landmarks(new kwiver::vital::simple_landmark_map(reference_landmarks->landmarks()));
-      triangulator->triangulate(cam_map, reference_tracks, sba_space_landmarks);
+      std::map<kwiver::vital::landmark_id_t,
+               kwiver::maptk::landmark_quality> quality;
+      kwiver::maptk::triangulate_tracks(config, "triangulator", cam_map,
+                                        reference_tracks, sba_space_landmarks,
+                                        &quality);
+      for (auto const& q : quality)
+      {
+        LOG_DEBUG(main_logger, "Reference landmark " << q.first
+                               << ": triangulation angle " << q.second.angle
+                               << " deg, RMSE " << q.second.rmse
+                               << " px, " << q.second.num_observations
+                               << " observations");
+      }
       if (sba_space_landmarks->size() < reference_landmarks->size())
       {
         LOG_WARN(main_logger, "Only " << sba_space_landmarks->size()
@@ -824,7 +1322,57 @@ static int maptk_main(int argc, char const* argv[])
   //
   // Compute landmark colors
   //
-  lm_map = kwiver::maptk::compute_landmark_colors(*lm_map, *tracks);
+  {
+    kwiver::maptk::landmark_color_options color_opts;
+    auto const color_mode =
+      config->get_value<std::string>("landmark_color_mode", "mean");
+    if (color_mode == "median")
+    {
+      color_opts.mode = kwiver::maptk::landmark_color_options::MEDIAN;
+    }
+    else if (color_mode == "weighted")
+    {
+      color_opts.mode = kwiver::maptk::landmark_color_options::WEIGHTED;
+      color_opts.cameras = cam_map;
+    }
+    else if (color_mode != "mean")
+    {
+      LOG_WARN(main_logger, "Unknown landmark_color_mode \"" << color_mode
+                            << "\", using the mean color");
+    }
+
+    kwiver::vital::timestamp color_ts;
+    bool video_done = true;
+    if (config->get_value<bool>("landmark_color_from_video", false))
+    {
+      LOG_INFO(main_logger, "Sampling landmark colors from video");
+      video_reader->open(config->get_value<std::string>("video_source"));
+      video_done = false;
+      // frames are requested in increasing order, so read sequentially
+      color_opts.images = [&](kwiver::vital::frame_id_t frame)
+        -> kwiver::vital::image_container_sptr
+      {
+        while (!video_done && (!color_ts.has_valid_frame() ||
+                               color_ts.get_frame() < frame))
+        {
+          video_done = !video_reader->next_frame(color_ts);
+        }
+        if (video_done || color_ts.get_frame() != frame)
+        {
+          return nullptr;
+        }
+        return video_reader->frame_image();
+      };
+    }
+
+    kwiver::vital::scoped_cpu_timer t( "Computing landmark colors" );
+    lm_map = kwiver::maptk::compute_landmark_colors(*lm_map, *tracks,
+                                                    color_opts);
+    if (color_opts.images)
+    {
+      video_reader->close();
+    }
+  }
 
   //
   // Write the output PLY file
@@ -836,6 +1384,66 @@ static int maptk_main(int argc, char const* argv[])
     write_ply_file(lm_map, ply_file);
   }
 
+  //
+  // Write the output residuals file
+  //
+  if( config->get_value<std::string>("output_residuals_file", "") != "" )
+  {
+    kwiver::vital::scoped_cpu_timer t( "computing residual statistics" );
+    std::string res_file =
+      config->get_value<std::string>("output_residuals_file");
+    kwiver::maptk::residual_statistics stats(
+      config->get_value<double>("residual_inlier_threshold", 2.0));
+    stats.compute(cam_map->cameras(), lm_map->landmarks(), tracks->tracks());
+
+    std::string const res_dir = ST::GetFilenamePath(res_file);
+    if (res_dir != "")
+    {
+      ST::MakeDirectory(res_dir);
+    }
+    std::ofstream ofs(res_file.c_str());
+    for (auto const& c : stats.cameras())
+    {
+      auto const& s = c.second;
+      ofs << c.first << " " << s.num_observations << " " << s.num_inliers
+          << " " << s.rmse() << " " << s.max_error;
+      for (auto const n : s.histogram)
+      {
+        ofs << " " << n;
+      }
+      ofs << "\n";
+    }
+  }
+
+  //
+  // Write the output ROI file
+  //
+  if( config->get_value<std::string>("output_roi_file", "") != "" )
+  {
+    kwiver::vital::scoped_cpu_timer t( "computing robust ROI" );
+    std::string roi_file = config->get_value<std::string>("output_roi_file");
+    double bounds[6];
+    if (kwiver::maptk::compute_robust_bounds(*lm_map, bounds))
+    {
+      std::string const roi_dir = ST::GetFilenamePath(roi_file);
+      if (roi_dir != "")
+      {
+        ST::MakeDirectory(roi_dir);
+      }
+      // Write every significant digit, since the bounds may be in large
+      // (e.g. UTM) coordinates
+      std::ofstream ofs(roi_file.c_str());
+      ofs << std::setprecision(std::numeric_limits<double>::max_digits10);
+      ofs << bounds[0] << " " << bounds[2] << " " << bounds[4] << " "
+          << bounds[1] << " " << bounds[3] << " " << bounds[5] << std::endl;
+    }
+    else
+    {
+      LOG_WARN(main_logger, "Too few landmarks to compute an ROI, "
+                            "no output ROI file written");
+    }
+  }
+
   //
   // Write the output POS files
   //
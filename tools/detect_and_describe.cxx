@@ -545,9 +545,11 @@ static int maptk_main(int argc, char const* argv[])
     LOG_INFO( main_logger, "Detected " << curr_feat->size() <<
                            " features on frame " << ts.get_frame() );
 
+    // this runs as a thread pool task, so sample the colors serially
     if (curr_feat)
     {
-      curr_feat = kwiver::maptk::extract_feature_colors(*curr_feat, *converted_image);
+      curr_feat = kwiver::maptk::extract_feature_colors(
+        *curr_feat, *converted_image, false);
     }
 
     // extract descriptors on the current frame
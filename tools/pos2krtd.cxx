@@ -38,6 +38,7 @@
 #include <iostream>
 #include <fstream>
 #include <exception>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -59,6 +60,8 @@
 #include <kwiversys/Directory.hxx>
 
 #include <vital/types/local_geo_cs.h>
+#include <maptk/bounded_task_queue.h>
+#include <maptk/camera_binary_io.h>
 #include <maptk/version.h>
 
 typedef kwiversys::SystemTools     ST;
@@ -88,6 +91,21 @@ default_config()
                     "be interpreted the same as the file mode of the input "
                     "parameter.");
 
+  config->set_value("output_camera_file", "",
+                    "If set, write all cameras into this single binary "
+                    "camera file instead of writing one KRTD file per frame "
+                    "into the output directory. The file may be given to "
+                    "bundle_adjust_tracks as its input_camera_file.");
+
+  config->set_value("streaming", "false",
+                    "Convert the metadata of each frame to a camera as soon "
+                    "as the frame is read, and write the cameras while the "
+                    "video is still being read, rather than collecting the "
+                    "metadata of the whole video first. If the geographic "
+                    "origin is not loaded from geo_origin_file, it is placed "
+                    "at the first camera rather than at the mean of all "
+                    "cameras.");
+
   config->set_value("geo_origin_file", "output/geo_origin.txt",
                     "This file contains the geographical location of the origin "
                     "of the local cartesian coordinate system used in the camera "
@@ -146,8 +164,12 @@ check_config(kwiver::vital::config_block_sptr config)
     MAPTK_CHECK_FAIL("Path given for video_source doesn't exist.");
   }
 
-  if (!config->has_value("output")
-      || config->get_value<std::string>("output") == "")
+  if (config->get_value<std::string>("output_camera_file", "") != "")
+  {
+    // cameras are written to a single file, the output directory is unused
+  }
+  else if (!config->has_value("output")
+           || config->get_value<std::string>("output") == "")
   {
     MAPTK_CHECK_FAIL("Not given an output file or directory.");
   }
@@ -313,6 +335,57 @@ static int maptk_main(int argc, char const* argv[])
   }
 
 
+  kwiver::vital::path_t const camera_file =
+    config->get_value<kwiver::vital::path_t>("output_camera_file", "");
+  bool const streaming = config->get_value<bool>("streaming", false);
+
+  // Cameras are written either into one binary file, in order, or into one
+  // KRTD file per frame by tasks in the thread pool
+  std::unique_ptr<kwiver::maptk::camera_binary_writer> camera_writer;
+  kwiver::maptk::bounded_task_queue krtd_writes;
+  if (camera_file != "")
+  {
+    std::string const camera_dir = ST::GetFilenamePath(camera_file);
+    if (camera_dir != "" && !ST::FileExists(camera_dir))
+    {
+      ST::MakeDirectory(camera_dir);
+    }
+    camera_writer.reset(new kwiver::maptk::camera_binary_writer(camera_file));
+  }
+  else if( ! ST::FileExists(output) )
+  {
+    // create output KRTD directory
+    if( ! ST::MakeDirectory( output ) )
+    {
+      LOG_ERROR( main_logger, "Unable to create output directory: " << output );
+      return EXIT_FAILURE;
+    }
+  }
+
+  size_t num_written = 0;
+  auto const write_camera =
+    [&](kwiver::vital::frame_id_t frame, kwiver::vital::camera_sptr const& cam,
+        std::string const& krtd_filename)
+  {
+    auto const pcam =
+      std::dynamic_pointer_cast<kwiver::vital::camera_perspective>(cam);
+    if (!pcam)
+    {
+      return;
+    }
+    if (camera_writer)
+    {
+      camera_writer->write(frame, *pcam);
+    }
+    else
+    {
+      krtd_writes.push([pcam, krtd_filename]{
+        kwiver::vital::write_krtd_file(*pcam, krtd_filename);
+      });
+    }
+    ++num_written;
+  };
+
   std::map<kwiver::vital::frame_id_t, kwiver::vital::metadata_sptr> md_map;
   std::map<kwiver::vital::frame_id_t, std::string> krtd_filenames;
 
@@ -329,39 +402,52 @@ static int maptk_main(int argc, char const* argv[])
       continue;
     }
     auto md = md_vec[0];
-    md_map[ts.get_frame()] = md;
     std::string basename = kwiver::vital::basename_from_metadata(md, ts.get_frame());
-    krtd_filenames[ts.get_frame()] = output + "/" + basename + ".krtd";
+    std::string krtd_filename = output + "/" + basename + ".krtd";
+    if (streaming)
+    {
+      // Convert this frame alone; the first frame converted also defines
+      // the origin if none was loaded
+      std::map<kwiver::vital::frame_id_t, kwiver::vital::metadata_sptr>
+        frame_md{ { ts.get_frame(), md } };
+      for (auto const& p : kwiver::vital::initialize_cameras_with_metadata(
+                             frame_md, base_camera, local_cs, ins_rot_offset))
+      {
+        write_camera(p.first, p.second, krtd_filename);
+      }
+    }
+    else
+    {
+      md_map[ts.get_frame()] = md;
+      krtd_filenames[ts.get_frame()] = krtd_filename;
+    }
   }
 
-  if (md_map.size() == 0)
+  if (!streaming)
   {
-    LOG_WARN( main_logger, "No valid metadata found in directory. Nothing to do.");
-    return EXIT_SUCCESS;
-  }
+    if (md_map.size() == 0)
+    {
+      LOG_WARN( main_logger, "No valid metadata found in directory. Nothing to do.");
+      return EXIT_SUCCESS;
+    }
 
-  LOG_INFO( main_logger, "Initializing cameras" );
-  std::map<kwiver::vital::frame_id_t, kwiver::vital::camera_sptr> cam_map;
-  cam_map = kwiver::vital::initialize_cameras_with_metadata(md_map, base_camera, local_cs, ins_rot_offset);
+    LOG_INFO( main_logger, "Initializing cameras" );
+    std::map<kwiver::vital::frame_id_t, kwiver::vital::camera_sptr> cam_map;
+    cam_map = kwiver::vital::initialize_cameras_with_metadata(md_map, base_camera, local_cs, ins_rot_offset);
 
-  // create output KRTD directory
-  if( ! ST::FileExists(output) )
-  {
-    if( ! ST::MakeDirectory( output ) )
+    LOG_INFO( main_logger, "Writing cameras" );
+    for (auto const& p : cam_map)
     {
-      LOG_ERROR( main_logger, "Unable to create output directory: " << output );
-      return EXIT_FAILURE;
+      write_camera(p.first, p.second, krtd_filenames[p.first]);
     }
   }
 
-  LOG_INFO( main_logger, "Writing KRTD files" );
-  typedef std::map<kwiver::vital::frame_id_t, kwiver::vital::camera_sptr>::value_type cam_map_val_t;
-  for(cam_map_val_t const &p : cam_map)
+  krtd_writes.wait();
+  if (camera_writer)
   {
-    auto cam = dynamic_cast<kwiver::vital::simple_camera_perspective*>(p.second.get());
-    kwiver::vital::write_krtd_file(*cam, krtd_filenames[p.first]);
+    camera_writer->close();
   }
-
+  LOG_INFO( main_logger, "Wrote " << num_written << " cameras" );
 
   // if we computed an origin that was not loaded from a file
   if (!local_cs.origin().is_empty() &&
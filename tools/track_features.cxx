@@ -39,7 +39,10 @@
 #include <string>
 #include <vector>
 
+#include <unsupported/Eigen/SparseExtra>
+
 #include <maptk/colorize.h>
+#include <maptk/match_matrix.h>
 
 #include <vital/config/config_block.h>
 #include <vital/config/config_block_io.h>
@@ -106,6 +109,12 @@ static kwiver::vital::config_block_sptr default_config()
                     "homographies for each frame. Leave blank to disable this "
                     "output. The output_homography_generator algorithm type "
                     "only needs to be set if this is set.");
+  config->set_value("output_match_matrix_file", "",
+                    "Optional path to a file to write the frame match matrix "
+                    "to. The matrix is accumulated as tracking proceeds. "
+                    "Files with a \".mtx\" extension are written in Matrix "
+                    "Market format, otherwise a dense text matrix is written. "
+                    "Leave blank to disable this output.");
 
   kwiver::vital::algo::video_input::get_nested_algo_configuration("video_reader", config,
                                       kwiver::vital::algo::video_input_sptr());
@@ -192,6 +201,14 @@ static bool check_config(kwiver::vital::config_block_sptr config)
     MAPTK_CONFIG_FAIL("output_tracks_file is not in a valid directory");
   }
 
+  if ( config->has_value("output_match_matrix_file") &&
+       config->get_value<std::string>("output_match_matrix_file") != "" &&
+       ! ST::FileIsDirectory( ST::CollapseFullPath( ST::GetFilenamePath(
+           config->get_value<kwiver::vital::path_t>("output_match_matrix_file") ) ) ) )
+  {
+    MAPTK_CONFIG_FAIL("output_match_matrix_file is not in a valid directory");
+  }
+
   if (!kwiver::vital::algo::video_input::check_nested_algo_configuration("video_reader", config))
   {
     MAPTK_CONFIG_FAIL("video_reader configuration check failed");
@@ -321,6 +338,8 @@ static int maptk_main(int argc, char const* argv[])
   bool invert_masks = config->get_value<bool>("invert_masks");
   bool expect_multichannel_masks = config->get_value<bool>("expect_multichannel_masks");
   std::string output_tracks_file = config->get_value<std::string>("output_tracks_file");
+  std::string output_match_matrix_file =
+    config->get_value<std::string>("output_match_matrix_file", "");
 
 
   LOG_INFO( main_logger, "Reading Video" );
@@ -403,6 +422,7 @@ static int maptk_main(int argc, char const* argv[])
 
   // Track features on each frame sequentially
   kwiver::vital::feature_track_set_sptr tracks;
+  kwiver::maptk::match_matrix_accumulator match_matrix;
   while( video_reader->next_frame(ts) )
   {
     LOG_INFO(main_logger, "processing frame "<<ts.get_frame() );
@@ -455,6 +475,10 @@ static int maptk_main(int argc, char const* argv[])
     if (tracks)
     {
       tracks = kwiver::maptk::extract_feature_colors(tracks, *image, ts.get_frame());
+      if ( ! output_match_matrix_file.empty() )
+      {
+        match_matrix.update(*tracks, ts.get_frame());
+      }
     }
 
     // Compute ref homography for current frame with current track set + write to file
@@ -474,6 +498,23 @@ static int maptk_main(int argc, char const* argv[])
   // Writing out tracks to file
   kwiver::vital::write_feature_track_file(tracks, output_tracks_file);
 
+  // Writing out the accumulated match matrix
+  if ( ! output_match_matrix_file.empty() )
+  {
+    LOG_INFO(main_logger, "Writing match matrix to: " << output_match_matrix_file);
+    std::vector<kwiver::vital::frame_id_t> frames;
+    auto const mm = match_matrix.matrix(frames);
+    if( ST::GetFilenameExtension( output_match_matrix_file ) == ".mtx" )
+    {
+      Eigen::saveMarket(mm, output_match_matrix_file);
+    }
+    else
+    {
+      std::ofstream mm_ofs(output_match_matrix_file.c_str());
+      mm_ofs << Eigen::MatrixXd(mm.cast<double>()) << std::endl;
+    }
+  }
+
   return EXIT_SUCCESS;
 }
 